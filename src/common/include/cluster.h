@@ -38,6 +38,8 @@
 #include "typedid.h"
 #include <nlohmann/json.hpp>
 
+namespace common { template <typename T> struct JsonFileCache; }
+
 /**
  * This structure represents a cluster setup, that is, a collection of computers that are
  * addressed as a unit. Each cluster has a human readable \m name, a unique \m id, a
@@ -60,6 +62,11 @@ struct Cluster {
     /// A list of all nodes belonging to this cluster
     std::vector<std::string> nodes;
 
+    /// The maximum number of nodes on which a program is starting at the same time. A
+    /// node counts as starting until its tray reports that the process has started or
+    /// failed to do so. A value of 0 does not limit the number
+    std::size_t launchConcurrency = 0;
+
     auto operator<=>(const Cluster& rhs) const = default;
 };
 
@@ -70,10 +77,12 @@ void to_json(nlohmann::json& j, const Cluster& c);
  * This method walks the passed \p directory and looks for all `*.json` files in it. Any
  * \c JSON file in it will be interpreted as a cluster configuration and returned.
  * \param directory The directory that is walked in search for `*.json` files
+ * \param cache If provided, only the files that have changed since the last call with
+ *        the same cache are parsed again
  * \return A list of all Cluster%s that were found by walking the \p directory, the second
  *         parameter is true if all files loaded successfully
  */
 std::pair<std::vector<Cluster>, bool> loadClustersFromDirectory(
-    std::string_view directory);
+    std::string_view directory, common::JsonFileCache<Cluster>* cache = nullptr);
 
 #endif // __COMMON__CLUSTER_H__
@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__ENTITYINDEX_H__
+#define __COMMON__ENTITYINDEX_H__
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace common {
+
+/**
+ * Keeps hash indices from the identifier and, if the entity has one, the name to entities
+ * that are owned elsewhere. The entities need an `id` member that is a TypedId and can
+ * have a `name` member. If multiple entities share the same identifier or name, the one
+ * that was inserted first is returned, which matches the result of a linear search
+ * through the entities in the order in which they were inserted.
+ */
+template <typename T>
+class EntityIndex {
+public:
+    using ID = typename T::ID;
+
+    static constexpr bool HasName = requires (const T& t) { std::string_view(t.name); };
+
+    /// Removes all entities from the index
+    void clear() {
+        _ids.clear();
+        _names.clear();
+    }
+
+    /**
+     * Adds the \p entity to the index. The \p entity has to stay alive until the index is
+     * cleared, and its identifier and name must not change in the meantime.
+     */
+    void insert(T* entity) {
+        _ids.emplace(entity->id.v, entity);
+        if constexpr (HasName) {
+            _names.emplace(entity->name, entity);
+        }
+    }
+
+    /**
+     * Removes the \p entity from the index. Other entities that share the identifier or
+     * name of the \p entity are not found anymore either, so this should only be used if
+     * the identifiers are unique.
+     */
+    void erase(const T* entity) {
+        auto it = _ids.find(entity->id.v);
+        if (it != _ids.end() && it->second == entity) {
+            _ids.erase(it);
+        }
+        if constexpr (HasName) {
+            auto jt = _names.find(entity->name);
+            if (jt != _names.end() && jt->second == entity) {
+                _names.erase(jt);
+            }
+        }
+    }
+
+    /// Returns the entity with the identifier \p id or `nullptr` if there is none
+    T* find(ID id) const {
+        const auto it = _ids.find(id.v);
+        return it != _ids.end() ? it->second : nullptr;
+    }
+
+    /// Returns the entity with the \p name or `nullptr` if there is none
+    T* find(std::string_view name) const requires HasName {
+        const auto it = _names.find(name);
+        return it != _names.end() ? it->second : nullptr;
+    }
+
+    /// Returns the number of distinct identifiers in the index
+    std::size_t size() const {
+        return _ids.size();
+    }
+
+private:
+    /// Allows looking up names with a std::string_view without creating a std::string
+    struct StringHash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>()(value);
+        }
+    };
+
+    std::unordered_map<int, T*> _ids;
+    std::unordered_map<std::string, T*, StringHash, std::equal_to<>> _names;
+};
+
+} // namespace common
+
+#endif // __COMMON__ENTITYINDEX_H__
@@ -0,0 +1,117 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__FRAMECIPHER_H__
+#define __COMMON__FRAMECIPHER_H__
+
+#include <QMessageAuthenticationCode>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * This class encrypts and authenticates the payload of individual frames with a key that
+ * is derived from a shared secret. The payload is encrypted with the ChaCha20 keystream
+ * (RFC 8439) and the nonce and ciphertext are then authenticated with an HMAC-SHA256
+ * (encrypt-then-MAC). Every frame uses a fresh random nonce so that the same cipher can
+ * be used in both directions of a connection. An encrypted frame is laid out as:
+ * `nonce (12 bytes) | ciphertext | tag (16 bytes)`.
+ *
+ * The cipher itself keeps no state between frames and thus cannot detect a frame that is
+ * replayed. Callers have to include the direction and position of the frame in the
+ * associated data for that, as the JsonSocket does.
+ */
+class FrameCipher {
+public:
+    static constexpr std::size_t KeySize = 32;
+    static constexpr std::size_t NonceSize = 12;
+    static constexpr std::size_t TagSize = 16;
+    /// The number of bytes by which the encrypted frame is larger than the plaintext
+    static constexpr std::size_t Overhead = NonceSize + TagSize;
+
+    /**
+     * Creates the cipher, deriving separate keys for the encryption and authentication
+     * from the \p secret.
+     */
+    explicit FrameCipher(std::string_view secret);
+
+    /**
+     * Encrypts the \p plaintext and stores the encrypted frame in \p result, replacing
+     * its previous contents. The \p associatedData is not encrypted, but is covered by
+     * the authentication tag and has to be provided unchanged to decrypt the frame.
+     *
+     * \param plaintext The bytes that should be encrypted
+     * \param associatedData Additional bytes that are authenticated, but not encrypted
+     * \param result The string into which the encrypted frame is written
+     */
+    void encrypt(std::string_view plaintext, std::string_view associatedData,
+        std::string& result);
+
+    /**
+     * Verifies and decrypts the encrypted \p frame and stores the plaintext in \p result,
+     * replacing its previous contents.
+     *
+     * \param frame The encrypted frame as it was created by #encrypt
+     * \param associatedData The same associated data that was passed to #encrypt
+     * \param result The string into which the plaintext is written
+     * \throw std::runtime_error If the frame is too short or fails the authentication
+     */
+    void decrypt(std::string_view frame, std::string_view associatedData,
+        std::string& result);
+
+    /**
+     * XORs the \p data with the ChaCha20 keystream for the \p key and \p nonce, starting
+     * at the block with the index \p counter. Applying the keystream twice with the same
+     * parameters restores the original data.
+     */
+    static void applyKeystream(std::span<const std::uint8_t, KeySize> key,
+        std::span<const std::uint8_t, NonceSize> nonce, std::uint32_t counter,
+        std::span<char> data);
+
+private:
+    std::array<std::uint8_t, TagSize> computeTag(std::string_view associatedData,
+        std::string_view data);
+
+    std::array<std::uint8_t, KeySize> _encryptionKey;
+    QMessageAuthenticationCode _mac;
+};
+
+} // namespace common
+
+#endif // __COMMON__FRAMECIPHER_H__
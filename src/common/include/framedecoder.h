@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__FRAMEDECODER_H__
+#define __COMMON__FRAMEDECODER_H__
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace common {
+
+/// The encodings in which the payload of a frame can be stored
+enum class Encoding {
+    /// UTF-8 encoded JSON text, which every version of the applications understands
+    Json = 0,
+    /// Concise Binary Object Representation (RFC 8949)
+    Cbor,
+    /// MessagePack
+    MessagePack
+};
+
+/// Returns the name of the \p encoding as it is used in the network messages
+std::string_view toString(Encoding encoding);
+
+/// Returns the encoding with the name \p name or `std::nullopt` if it is unknown
+std::optional<Encoding> encodingFromString(std::string_view name);
+
+/// A single frame that was extracted by the FrameDecoder
+struct Frame {
+    /// The bytes of the payload
+    std::string_view payload;
+    /// The encoding of the payload as announced in the frame header
+    Encoding encoding = Encoding::Json;
+    /// Whether the payload was compressed with zlib (see \c qCompress) after encoding it
+    bool isCompressed = false;
+    /// Whether the payload was encrypted with the FrameCipher as the last step
+    bool isEncrypted = false;
+};
+
+/// The maximum number of characters in a frame header
+constexpr std::size_t MaxFrameHeaderSize = 24;
+
+/**
+ * Writes the header for a frame with a payload of \p payloadSize bytes that is stored in
+ * the \p encoding into the \p buffer. The header consists of the payload size as decimal
+ * number, optional flag characters describing a binary encoding, the compression, and the
+ * encryption, and the `#` separator. Plain text JSON frames do not have a flag and are
+ * thus readable by older versions.
+ *
+ * \param buffer The buffer into which the header is written
+ * \param payloadSize The number of bytes of the payload following the header
+ * \param encoding The encoding of the payload
+ * \param isCompressed Whether the payload was compressed after encoding it
+ * \param isEncrypted Whether the payload was encrypted after compressing it
+ * \return The number of characters that were written into the \p buffer
+ */
+std::size_t encodeFrameHeader(std::span<char, MaxFrameHeaderSize> buffer,
+    std::size_t payloadSize, Encoding encoding, bool isCompressed = false,
+    bool isEncrypted = false);
+
+/**
+ * This class incrementally decodes the length-prefixed frames (`{length}#{payload}`) that
+ * are sent through a JsonSocket. Incoming bytes are stored in a growable ring buffer so
+ * that frames that are split across multiple reads are reassembled and multiple frames
+ * that arrive in the same read can be extracted one after another without moving the
+ * remaining bytes around.
+ */
+class FrameDecoder {
+public:
+    /// The default maximum size of a single frame payload in bytes
+    static constexpr std::size_t DefaultMaxFrameSize = 32 * 1024 * 1024;
+
+    /**
+     * Creates a new FrameDecoder that rejects all frames whose payload is larger than
+     * \p maxFrameSize.
+     *
+     * \param maxFrameSize The largest payload in bytes that is accepted by the decoder
+     */
+    explicit FrameDecoder(std::size_t maxFrameSize = DefaultMaxFrameSize);
+
+    /**
+     * Copies the \p data into the end of the ring buffer, growing it if necessary.
+     *
+     * \param data The bytes that were received from the socket
+     */
+    void append(std::span<const char> data);
+
+    /**
+     * Returns a contiguous region at the end of the ring buffer into which at most
+     * \p maxSize bytes can be written directly. The returned region might be smaller than
+     * requested if the free space wraps around the end of the buffer, in which case the
+     * function has to be called again after the bytes were committed. The written bytes
+     * only become part of the buffer after calling #commit.
+     *
+     * \param maxSize The maximum number of bytes the caller wants to write
+     * \return The region into which the caller can write
+     */
+    std::span<char> writeRegion(std::size_t maxSize);
+
+    /**
+     * Marks \p size bytes of the region previously returned by #writeRegion as written.
+     *
+     * \param size The number of bytes that were actually written
+     * \pre \p size must not be larger than the region returned by #writeRegion
+     */
+    void commit(std::size_t size);
+
+    /**
+     * Extracts the next complete frame from the buffer. The returned view stays valid
+     * until the next non-const member function is called on this object.
+     *
+     * \return The next frame or `std::nullopt` if no complete frame is available yet
+     * \throw std::runtime_error If the frame header is malformed or if the announced
+     *        payload is larger than the maximum frame size. The decoder should be cleared
+     *        after this happened as the stream cannot be resynchronized
+     */
+    std::optional<Frame> nextFrame();
+
+    /**
+     * Removes all buffered bytes and any partially decoded frame.
+     */
+    void clear();
+
+    /**
+     * Returns the number of bytes that are currently stored in the buffer and that have
+     * not been returned as part of a frame yet.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns the size of the payload of the frame that is currently being received or
+     * `std::nullopt` if the header of the next frame has not been received yet.
+     */
+    std::optional<std::size_t> pendingFrameSize() const;
+
+    /// Returns the largest payload in bytes that is accepted by this decoder
+    std::size_t maxFrameSize() const;
+
+private:
+    std::size_t index(std::size_t position) const;
+    void grow(std::size_t minimumFree);
+    std::optional<std::size_t> parseHeader();
+
+    const std::size_t _maxFrameSize;
+
+    /// The ring buffer; its size is always a power of two
+    std::vector<char> _buffer;
+    /// The absolute positions of the first unread byte and one past the last written byte
+    std::size_t _head = 0;
+    std::size_t _tail = 0;
+
+    /// The payload size of the current frame if its header was already consumed
+    std::optional<std::size_t> _payloadSize;
+    /// The encoding of the current frame if its header was already consumed
+    Encoding _encoding = Encoding::Json;
+    /// Whether the current frame is compressed if its header was already consumed
+    bool _isCompressed = false;
+    /// Whether the current frame is encrypted if its header was already consumed
+    bool _isEncrypted = false;
+
+    /// Storage for frames that wrap around the end of the ring buffer
+    std::vector<char> _scratch;
+};
+
+} // namespace common
+
+#endif // __COMMON__FRAMEDECODER_H__
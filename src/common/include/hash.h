@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__HASH_H__
+#define __COMMON__HASH_H__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * Computes the 64 bit xxHash (XXH64) of the \p data. In contrast to std::hash, the value
+ * is the same for every compiler, standard library, and platform and can therefore be
+ * stored on disk or exchanged with other applications.
+ *
+ * \param data The bytes that should be hashed
+ * \param seed The seed value that is used to initialize the hash
+ * \return The hash of the \p data
+ */
+std::uint64_t xxHash64(std::string_view data, std::uint64_t seed = 0);
+
+/**
+ * Combines a list of values into a single xxHash64 value. The values are written into a
+ * buffer in a fixed, platform independent layout and the hash is computed over the whole
+ * buffer. Strings are prefixed with their length so that, for example, the fields
+ * `"ab", "c"` and `"a", "bc"` lead to different hashes.
+ */
+class HashBuilder {
+public:
+    HashBuilder& add(std::string_view value);
+    HashBuilder& add(std::int64_t value);
+    HashBuilder& add(std::uint64_t value);
+    HashBuilder& add(int value);
+
+    /// Returns the hash of all of the values that were added so far
+    std::uint64_t value() const;
+
+private:
+    std::string _buffer;
+};
+
+} // namespace common
+
+#endif // __COMMON__HASH_H__
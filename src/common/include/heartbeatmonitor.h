@@ -0,0 +1,154 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__HEARTBEATMONITOR_H__
+#define __COMMON__HEARTBEATMONITOR_H__
+
+#include "latencyhistogram.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/**
+ * Decides when a heartbeat is sent on each of a set of connections and keeps track of
+ * the answers. The time between sending a heartbeat and receiving its answer is recorded
+ * in a LatencyHistogram for each connection. A connection for which a number of
+ * heartbeats in a row were not answered is reported as dead, which also catches
+ * connections that are half-open and would otherwise only be noticed once the operating
+ * system gives up on them. The current time is passed in by the caller so that this
+ * class does not depend on any timer.
+ */
+class HeartbeatMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        /// The time between two heartbeats that are sent on the same connection
+        std::chrono::milliseconds interval = std::chrono::seconds(1);
+        /// The number of heartbeats in a row that can go unanswered before the connection
+        /// is considered to be dead
+        int maxMissedBeats = 5;
+        /// The number of most recent round-trip times that the statistics are based on
+        std::size_t windowSize = 300;
+    };
+
+    /// A heartbeat that has to be sent on the connection with the `id`
+    struct Ping {
+        int id = -1;
+        std::uint64_t sequence = 0;
+    };
+
+    /// The heartbeats that should be sent now and the connections that are dead
+    struct Actions {
+        std::vector<Ping> ping;
+        std::vector<int> dead;
+    };
+
+    struct Statistics {
+        /// The round-trip time of the most recent answer
+        std::chrono::microseconds last = std::chrono::microseconds(0);
+        /// The median of the recent round-trip times
+        std::chrono::microseconds p50 = std::chrono::microseconds(0);
+        /// The 99th percentile of the recent round-trip times
+        std::chrono::microseconds p99 = std::chrono::microseconds(0);
+        /// The number of round-trip times that the percentiles are based on
+        std::size_t nSamples = 0;
+        /// The number of heartbeats in a row that have not been answered so far
+        int missedBeats = 0;
+    };
+
+    HeartbeatMonitor();
+    explicit HeartbeatMonitor(Options options);
+
+    /// Starts sending heartbeats on the connection with the \p id, starting right away
+    void add(int id, Clock::time_point now);
+
+    /// Stops sending heartbeats on the connection with the \p id and forgets its history
+    void remove(int id);
+
+    /**
+     * Records the answer to the heartbeat with the \p sequence number on the connection
+     * with the \p id. Any answer shows that the connection is alive, but only the answer
+     * to a heartbeat that is still remembered contributes a round-trip time.
+     *
+     * \return `true` if the round-trip time of the heartbeat was recorded
+     */
+    bool receivePong(int id, std::uint64_t sequence, Clock::time_point now);
+
+    /**
+     * Returns the heartbeats that should be sent now and the connections that missed too
+     * many heartbeats. The dead connections are removed from this monitor and have to be
+     * added again once they are reestablished.
+     */
+    Actions update(Clock::time_point now);
+
+    /**
+     * Returns the time at which update has to be called next, or `std::nullopt` if there
+     * are no connections.
+     */
+    std::optional<Clock::time_point> nextUpdate() const;
+
+    /// Returns the statistics of the connection with the \p id or `std::nullopt` if no
+    /// heartbeats are sent on it
+    std::optional<Statistics> statistics(int id) const;
+
+    const Options& options() const;
+
+private:
+    struct Connection {
+        explicit Connection(std::size_t windowSize);
+
+        /// The time at which the next heartbeat is sent
+        Clock::time_point nextPing;
+        /// The sequence numbers and times of the heartbeats that are not answered yet
+        std::deque<std::pair<std::uint64_t, Clock::time_point>> pending;
+        int missedBeats = 0;
+        std::chrono::microseconds last = std::chrono::microseconds(0);
+        LatencyHistogram histogram;
+    };
+
+    Options _options;
+    std::map<int, Connection> _connections;
+    std::uint64_t _nextSequence = 1;
+};
+
+} // namespace common
+
+#endif // __COMMON__HEARTBEATMONITOR_H__
@@ -35,19 +35,105 @@
 #ifndef __COMMON__JSONLOAD_H__
 #define __COMMON__JSONLOAD_H__
 
+#include "hash.h"
 #include "jsonvalidation.h"
 #include "logging.h"
 #include <QDirIterator>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json-schema.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
 #include <optional>
+#include <set>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace common {
 
+/**
+ * The objects that were created from the JSON files in a directory, keyed by the path of
+ * the file. Passing the same cache to subsequent calls of loadJsonFromDirectory means
+ * that only the files that were added or modified since the last call are parsed again.
+ * A file is only considered unchanged if its modification time, its size, and the hash
+ * of its contents all match. Each cached value has already passed the validation.
+ *
+ * \tparam T The type of the objects that were created from the JSON files
+ */
+template <typename T>
+struct JsonFileCache {
+    struct Entry {
+        std::filesystem::file_time_type lastWriteTime;
+        std::uintmax_t fileSize = 0;
+        std::uint64_t contentHash = 0;
+        T value;
+    };
+    std::map<std::string, Entry> entries;
+};
+
+/**
+ * Serializes the \p cache into a JSON array that contains one
+ * `[path, lastWriteTime, fileSize, contentHash, value]` array per entry. The result is
+ * meant to be stored in a binary format, such as CBOR, between runs of the application
+ * and it is only valid for the same build of the application on the same machine.
+ */
+template <typename T> requires std::is_constructible_v<nlohmann::json, T>
+void to_json(nlohmann::json& j, const JsonFileCache<T>& cache) {
+    j = nlohmann::json::array();
+    for (const auto& [path, entry] : cache.entries) {
+        j.push_back(nlohmann::json::array({
+            path,
+            entry.lastWriteTime.time_since_epoch().count(),
+            entry.fileSize,
+            entry.contentHash,
+            entry.value
+        }));
+    }
+}
+
+template <typename T> requires std::is_constructible_v<T, nlohmann::json>
+void from_json(const nlohmann::json& j, JsonFileCache<T>& cache) {
+    using Time = std::filesystem::file_time_type;
+
+    cache.entries.clear();
+    for (const nlohmann::json& e : j) {
+        typename JsonFileCache<T>::Entry entry;
+        entry.lastWriteTime = Time(Time::duration(e.at(1).get<Time::rep>()));
+        e.at(2).get_to(entry.fileSize);
+        e.at(3).get_to(entry.contentHash);
+        entry.value = T(e.at(4));
+        cache.entries[e.at(0).get<std::string>()] = std::move(entry);
+    }
+}
+
+/**
+ * Validates the JSON object \p obj against the \p validator, if one is provided, and
+ * constructs an object \tparam T from it.
+ *
+ * \throw validation::JsonError If \p obj does not match the \p validator
+ */
+template <typename T> requires std::is_constructible_v<T, nlohmann::json>
+T loadFromJsonObject(const nlohmann::json& obj,
+                     const nlohmann::json_schema::json_validator* validator = nullptr)
+{
+    if (validator) {
+        validation::ErrorHandler err;
+        validator->validate(obj, err);
+        if (err) {
+            throw validation::JsonError(std::move(err));
+        }
+    }
+
+    return T(obj);
+}
+
 /**
  * This function loads an object \tparam T from the specified \p jsonFile. \p jsonFile has
  * to be a fully qualified path to the JSON file on disk and \p baseDirectory is the part
@@ -57,25 +143,44 @@ namespace common {
  *
  * \tparam T The type of the object that should be constructed from the JSON file
  * \param jsonFile The path to the JSON file that contains the data for the object T
+ * \param validator If provided, the contents of the file are validated against it
  * \return A constructed object T that is initialized from the JSON file \p jsonFile
  */
 template <typename T> requires std::is_constructible_v<T, nlohmann::json>
 T loadFromJson(std::string_view jsonFile,
-     const std::optional<nlohmann::json_schema::json_validator>& validator = std::nullopt)
+               const nlohmann::json_schema::json_validator* validator = nullptr)
 {
     std::ifstream f = std::ifstream(std::string(jsonFile));
     nlohmann::json obj;
     f >> obj;
+    return loadFromJsonObject<T>(obj, validator);
+}
 
-    if (validator.has_value()) {
-        validation::ErrorHandler err;
-        validator->validate(obj, err);
-        if (err) {
-            throw validation::JsonError(std::move(err));
+/**
+ * Calls \p function for every index in `[0, count)` on as many threads as the hardware
+ * provides and returns once all of the calls have finished. The calls for different
+ * indices can happen concurrently and in any order.
+ */
+template <typename F>
+void parallelFor(std::size_t count, const F& function) {
+    const std::size_t nThreads = std::min<std::size_t>(
+        count,
+        std::max(std::thread::hardware_concurrency(), 1u)
+    );
+
+    std::atomic<std::size_t> next = 0;
+    auto work = [&next, count, &function]() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            function(i);
         }
-    }
+    };
 
-    return T(obj);
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 1; i < nThreads; i++) {
+        threads.emplace_back(work);
+    }
+    // The calling thread does its share of the work, too
+    work();
 }
 
 template <typename T> requires std::is_constructible_v<nlohmann::json, T>
@@ -91,43 +196,151 @@ void saveToJson(std::string_view filename, const T& value) {
  * This function reads all `.json` files in the provided \p directory and creates a list
  * of \tparam T objects from these files. Each file in the directory will lead to a single
  * \tparam T in the result vector. For each of the valid files in \p directory, the
- * loadFromJson function will be called
+ * loadFromJson function will be called. The files are parsed and validated in parallel,
+ * but the result is always in the order in which the directory was traversed. Files
+ * that are in the \p cache and that did not change are neither parsed nor validated
  *
  * \tparam T The type of the object that is created from the JSON files in \p directory
  * \param directory The path to the directory that contains a list of JSON files, this
  *        directory is traversed recursively
+ * \param validator If provided, all files are validated against it. The validator is
+ *        used from multiple threads at the same time
+ * \param cache If this is provided, files that have not changed since they were added
+ *        to the cache are not parsed again and the cache is updated with the result
  * \return A list of \tparam T objects that was created from JSON files in \p directory
  */
 template <typename T> requires std::is_constructible_v<T, nlohmann::json>
 std::pair<std::vector<T>, bool> loadJsonFromDirectory(std::string_view directory,
-     const std::optional<nlohmann::json_schema::json_validator>& validator = std::nullopt)
+                         const nlohmann::json_schema::json_validator* validator = nullptr,
+                                                        JsonFileCache<T>* cache = nullptr)
 {
     namespace fs = std::filesystem;
     if (!fs::is_directory(directory)) {
         throw std::runtime_error(std::format("Could not find directory '{}'", directory));
     }
 
-    std::vector<T> res;
-    bool loadingSucceeded = true;
+    struct File {
+        std::string path;
+        fs::file_time_type lastWriteTime;
+        std::uintmax_t fileSize = 0;
+        std::uint64_t contentHash = 0;
+
+        // Only one of these is set after the file was loaded
+        std::optional<T> value;
+        std::string error;
+        std::exception_ptr exception;
+        bool isCached = false;
+    };
+
+    std::vector<File> files;
     for (const fs::directory_entry& p : fs::recursive_directory_iterator(directory)) {
         if (!p.is_regular_file() || p.path().extension() != ".json") {
             continue;
         }
 
-        const std::string file = p.path().string();
-        ::Log("Status", std::format("Loading file '{}'", file));
-        try {
-            T obj = common::loadFromJson<T>(file, validator);
-            res.push_back(std::move(obj));
+        File file;
+        file.path = p.path().string();
+        file.lastWriteTime = p.last_write_time();
+        file.fileSize = p.file_size();
+        files.push_back(std::move(file));
+    }
+
+    parallelFor(
+        files.size(),
+        [&files, validator, cache](std::size_t i) {
+            File& file = files[i];
+            try {
+                std::ifstream f = std::ifstream(file.path, std::ios::binary);
+                const std::string content = std::string(
+                    std::istreambuf_iterator<char>(f),
+                    std::istreambuf_iterator<char>()
+                );
+                file.contentHash = common::xxHash64(content);
+
+                if (cache) {
+                    // The cache is not modified until all files are loaded, so it is
+                    // safe to read it from all threads at the same time
+                    const auto it = cache->entries.find(file.path);
+                    if (it != cache->entries.end() &&
+                        it->second.lastWriteTime == file.lastWriteTime &&
+                        it->second.fileSize == file.fileSize &&
+                        it->second.contentHash == file.contentHash)
+                    {
+                        file.value = it->second.value;
+                        file.isCached = true;
+                        return;
+                    }
+                }
+
+                file.value = common::loadFromJsonObject<T>(
+                    nlohmann::json::parse(content),
+                    validator
+                );
+            }
+            catch (const nlohmann::json::exception& e) {
+                // A file with a syntax error, for example one that is only partially
+                // written, must not take down the loading of all other files
+                file.error = e.what();
+            }
+            catch (const std::runtime_error& e) {
+                // This also catches the validation::JsonError
+                file.error = e.what();
+            }
+            catch (...) {
+                // All other exceptions are passed on to the caller like before
+                file.exception = std::current_exception();
+            }
+        }
+    );
+
+    std::vector<T> res;
+    res.reserve(files.size());
+    bool loadingSucceeded = true;
+    for (File& file : files) {
+        if (file.isCached) {
+            res.push_back(std::move(*file.value));
+            continue;
+        }
+
+        ::Log("Status", std::format("Loading file '{}'", file.path));
+        if (cache) {
+            // A file that fails to load must not be served from an older version
+            cache->entries.erase(file.path);
         }
-        catch (const validation::JsonError& e) {
-            ::Log("Error", std::format("Failed to load file '{}': {}", file, e.what()));
-            loadingSucceeded = false;
+        if (file.exception) {
+            std::rethrow_exception(file.exception);
         }
-        catch (const std::runtime_error& e) {
-            ::Log("Error", std::format("Failed to load file '{}': {}", file, e.what()));
+        if (!file.value.has_value()) {
+            ::Log(
+                "Error",
+                std::format("Failed to load file '{}': {}", file.path, file.error)
+            );
             loadingSucceeded = false;
+            continue;
+        }
+
+        if (cache) {
+            cache->entries[file.path] = {
+                file.lastWriteTime,
+                file.fileSize,
+                file.contentHash,
+                *file.value
+            };
         }
+        res.push_back(std::move(*file.value));
+    }
+
+    if (cache) {
+        std::set<std::string> paths;
+        for (const File& file : files) {
+            paths.insert(file.path);
+        }
+
+        // Files that were removed should not be served again
+        std::erase_if(
+            cache->entries,
+            [&paths](const auto& p) { return !paths.contains(p.first); }
+        );
     }
 
     return { res, loadingSucceeded };
@@ -148,7 +361,7 @@ Conf loadConfiguration(std::string config, std::string schema) {
         return common::loadFromJson<Conf>(config);
     }
     else {
-        return common::loadFromJson<Conf>(config, validation::loadValidator(schema));
+        return common::loadFromJson<Conf>(config, &validation::sharedValidator(schema));
     }
 }
 
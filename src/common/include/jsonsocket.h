@@ -37,50 +37,310 @@
 
 #include <QObject>
 
+#include "framecipher.h"
+#include "framedecoder.h"
+#include <QHostAddress>
 #include <QTcpSocket>
 #include <nlohmann/json.hpp>
-#include <simplecrypt/simplecrypt.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace common {
 
+class SharedMessage;
+
 /**
  * This socket handles connections that transmit entire JSON messages. Individual packages
- * are cached. When a complete JSON object is received the readyRead signal is emitted,
- * after which the JSON object is available through the read method. Similarly, the
- * write method will transmit a JSON object through the socket to the receiver.
+ * are cached in a FrameDecoder. Every complete JSON object that is received is emitted
+ * through the messageReceived signal. Similarly, the write method will transmit a JSON
+ * object through the socket to the receiver. All messages that are written in the same
+ * iteration of the event loop are collected in an outbound queue and handed to the
+ * operating system in a single write. If the peer does not read the data fast enough,
+ * the socket signals this through the backpressureChanged signal.
+ *
+ * Outgoing messages are serialized in the encoding that was selected through setEncoding,
+ * which defaults to JSON text. Incoming messages are decoded in whichever encoding is
+ * announced in their frame header, so both sides can switch independently of each other.
+ * If compression was enabled through setCompressionEnabled, outgoing messages that are
+ * larger than the compression threshold are additionally compressed with zlib. If a
+ * secret was provided, every frame is encrypted and authenticated with a FrameCipher and
+ * frames that are not encrypted or fail the authentication are dropped. The
+ * authentication covers the direction and the position of the frame in the connection,
+ * so a recorded frame can neither be replayed nor reflected back to its sender.
+ *
+ * Encoded frames are immutable and reference-counted, so the same message can be sent to
+ * multiple peers through broadcast without serializing or compressing it more often than
+ * the different settings of the sockets require. Encrypted frames are unique to their
+ * connection and are therefore never shared.
  */
 class JsonSocket : public QObject {
 Q_OBJECT
 public:
+    /// The name under which the zlib compression is advertised in the handshake
+    static constexpr std::string_view CompressionZlib = "zlib";
+
+    /**
+     * A function that receives the decrypted and decompressed payload of every incoming
+     * frame before it is parsed. If it returns \c true, the payload was consumed and no
+     * messageReceived signal is emitted for it.
+     */
+    using PayloadHandler =
+        std::function<bool(std::string_view payload, Encoding encoding)>;
+
+    struct Options {
+        /// Disables Nagle's algorithm. Messages are already coalesced by the JsonSocket
+        /// so waiting for more data only adds latency
+        bool noDelay = true;
+        /// Enables the TCP keep-alive probes to detect peers that have vanished
+        bool keepAlive = true;
+        /// If more bytes than this are waiting to be sent, the peer is considered to be
+        /// falling behind and the backpressureChanged signal is emitted
+        std::size_t highWatermark = 4 * 1024 * 1024;
+        /// The peer is considered to have caught up once fewer than this many bytes are
+        /// waiting to be sent
+        std::size_t lowWatermark = 1024 * 1024;
+        /// If more bytes than this are waiting to be sent, the peer is considered to be
+        /// unresponsive and the connection is dropped
+        std::size_t maxQueueSize = 64 * 1024 * 1024;
+        /// Encoded messages that are smaller than this many bytes are never compressed as
+        /// the saved bandwidth would not be worth the time spent compressing them
+        std::size_t compressionThreshold = 1024;
+        /// The zlib compression level between 0 and 9 or -1 for the zlib default
+        int compressionLevel = -1;
+
+        bool operator==(const Options&) const = default;
+    };
+
+    /// Counters that describe how well the compression of this socket is doing
+    struct CompressionStatistics {
+        /// Returns the ratio of compressed to uncompressed bytes of the outgoing frames
+        double ratio() const;
+
+        /// The number of outgoing frames that were sent compressed
+        std::uint64_t nCompressedFrames = 0;
+        /// The number of outgoing frames that exceeded the threshold, but did not shrink
+        std::uint64_t nIncompressibleFrames = 0;
+        /// The size of the outgoing payloads before they were compressed
+        std::uint64_t bytesBeforeCompression = 0;
+        /// The size of the outgoing payloads after they were compressed
+        std::uint64_t bytesAfterCompression = 0;
+        /// The total time that was spent compressing outgoing frames
+        std::chrono::nanoseconds compressionTime = std::chrono::nanoseconds(0);
+
+        /// The number of incoming frames that were decompressed
+        std::uint64_t nDecompressedFrames = 0;
+        /// The size of the incoming compressed payloads
+        std::uint64_t bytesBeforeDecompression = 0;
+        /// The size of the incoming payloads after they were decompressed
+        std::uint64_t bytesAfterDecompression = 0;
+        /// The total time that was spent decompressing incoming frames
+        std::chrono::nanoseconds decompressionTime = std::chrono::nanoseconds(0);
+    };
+
     JsonSocket(std::unique_ptr<QTcpSocket> socket, std::string secret);
-    virtual ~JsonSocket() = default;
+    virtual ~JsonSocket();
 
     void connectToHost(const std::string& host, int port);
+    /// Connects to an \p address that was already resolved, skipping the host lookup
+    void connectToHost(const QHostAddress& address, int port);
+    /// Closes the connection or cancels the connection attempt immediately
+    void abort();
     QTcpSocket::SocketState state() const;
 
+    /**
+     * Serializes the \p json and adds it to the outbound queue. The queue is handed to
+     * the operating system at the next iteration of the event loop.
+     */
     void write(const nlohmann::json& json);
 
+    /**
+     * Writes the \p json to all of the \p sockets. The message is serialized only once
+     * per encoding and compressed only once per encoding and compression settings. All
+     * sockets with the same settings that are not encrypted share a single copy of the
+     * resulting frame in their outbound queues.
+     */
+    static void broadcast(std::span<JsonSocket* const> sockets,
+        const nlohmann::json& json);
+
+    /**
+     * Adds the \p message to the outbound queue. The frame that is encoded for this
+     * socket is kept in the \p message, so that all sockets with the same settings that
+     * the message is written to afterwards send the same frame without encoding it again.
+     */
+    void write(SharedMessage& message);
+
+    /**
+     * Sets the \p options for this socket. The TCP options are applied as soon as the
+     * connection is established.
+     */
+    void setOptions(Options options);
+
+    /**
+     * Returns the number of bytes that have been written, but that have not been sent to
+     * the peer yet.
+     */
+    std::size_t bytesPending() const;
+
+    /**
+     * Sets the \p encoding that is used for all messages that are written from now on.
+     * The encoding is reset to JSON text whenever the connection is lost, as the peer of
+     * the next connection might not support any other encoding.
+     */
+    void setEncoding(Encoding encoding);
+
+    /// Returns the encoding that is currently used for outgoing messages
+    Encoding encoding() const;
+
+    /**
+     * Enables or disables the compression of outgoing messages. This must only be enabled
+     * after the peer has announced that it is able to decompress frames. Similar to the
+     * encoding, the compression is disabled whenever the connection is lost.
+     */
+    void setCompressionEnabled(bool enabled);
+
+    /// Returns whether outgoing messages are compressed
+    bool isCompressionEnabled() const;
+
+    /// Returns the compression counters that were collected for the current connection
+    const CompressionStatistics& compressionStatistics() const;
+
+    /**
+     * Sets the \p handler that gets the first look at every incoming payload. This makes
+     * it possible to decode frequent messages straight into their structs without
+     * creating a JSON document for them first. Exceptions thrown by the \p handler cause
+     * the message to be dropped, just as any other malformed message.
+     */
+    void setPayloadHandler(PayloadHandler handler);
+
+    /**
+     * Returns \c true if the number of pending bytes exceeded the high watermark and has
+     * not dropped below the low watermark since.
+     */
+    bool hasBackpressure() const;
+
     std::string localAddress() const;
     std::string peerAddress() const;
 
 signals:
     void messageReceived(nlohmann::json message);
     void disconnected();
+    void backpressureChanged(bool hasBackpressure);
 
 private:
+    friend class SharedMessage;
+
+    /// A complete frame, including its header, that is ready to be sent
+    using EncodedFrame = std::shared_ptr<const std::string>;
+
+    /// The settings of a socket that determine the frame that a message is encoded into
+    struct FrameSettings {
+        bool operator==(const FrameSettings&) const = default;
+
+        Encoding encoding;
+        bool isCompressionEnabled;
+        /// The compression threshold and level are 0 if the compression is disabled
+        std::size_t compressionThreshold;
+        int compressionLevel;
+    };
+
+    /// The intermediate results of encoding a single message for one or more sockets
+    struct EncodeCache {
+        /// The serialized message, indexed by the Encoding
+        std::array<std::optional<std::string>, 3> serialized;
+
+        struct Compressed {
+            Encoding encoding;
+            std::size_t threshold;
+            int level;
+            /// Empty if the message was too small or did not shrink by compressing it
+            QByteArray data;
+        };
+        std::vector<Compressed> compressed;
+
+        struct Frame {
+            /// The settings of the socket that this frame was first encoded for
+            FrameSettings settings;
+            EncodedFrame frame;
+        };
+        std::vector<Frame> frames;
+    };
+
+    /// Returns the settings of this socket. All unencrypted sockets with the same
+    /// settings can share one frame for every message
+    FrameSettings frameSettings() const;
+    EncodedFrame encode(const nlohmann::json& json, EncodeCache& cache);
+    void enqueue(EncodedFrame frame);
+
     void readToBuffer();
     void parseBuffer();
+    std::string_view unpackFrame(const Frame& frame);
+    std::string_view decompress(std::string_view payload);
+
+    void applySocketOptions();
+    void scheduleFlush();
+    void flushQueue();
+    void updateBackpressure();
 
     std::unique_ptr<QTcpSocket> _socket;
-    std::optional<SimpleCrypt> _crypto;
-    std::vector<char> _buffer;
-    int _payloadSize = -1;
+    std::optional<FrameCipher> _cipher;
+    /// Whether this side initiated the connection through connectToHost. This determines
+    /// the direction that is authenticated in the encrypted frames
+    bool _isClient = false;
+    /// The number of encrypted frames sent and received on the current connection
+    std::uint64_t _sendSequence = 0;
+    std::uint64_t _receiveSequence = 0;
+    FrameDecoder _decoder;
+    Options _options;
+    Encoding _encoding = Encoding::Json;
+    bool _isCompressionEnabled = false;
+    CompressionStatistics _compressionStatistics;
+    PayloadHandler _payloadHandler;
+
+    /// Reusable storage into which outgoing frames are encrypted
+    std::string _encrypted;
+    /// Reusable storage into which encrypted incoming frames are decrypted
+    std::string _decrypted;
+    /// Reusable storage into which compressed incoming frames are decompressed
+    QByteArray _decompressed;
+    /// The frames that have been written but not yet handed to the QTcpSocket. The first
+    /// _queueOffset bytes of the first frame have already been handed over
+    std::deque<EncodedFrame> _queue;
+    std::size_t _queueOffset = 0;
+    /// The number of bytes in the queue that have not been handed over yet
+    std::size_t _queueSize = 0;
+    bool _isFlushScheduled = false;
+    bool _hasBackpressure = false;
 };
 
+/**
+ * A message that is written to multiple sockets, possibly at different points in time,
+ * for example because it had to wait for the flow control of some of the connections.
+ * The message is serialized and compressed at most once for every different combination
+ * of socket settings and all unencrypted sockets with the same settings share the frame.
+ */
+class SharedMessage {
+public:
+    explicit SharedMessage(nlohmann::json json);
+
+private:
+    friend class JsonSocket;
+
+    nlohmann::json _json;
+    JsonSocket::EncodeCache _cache;
+};
+
+void to_json(nlohmann::json& j, const JsonSocket::Options& o);
+void from_json(const nlohmann::json& j, JsonSocket::Options& o);
+
 } // namespace common
 
 #endif // __COMMON__JSONSOCKET_H__
@@ -57,6 +57,13 @@ struct JsonError : public std::runtime_error {
 
 nlohmann::json_schema::json_validator loadValidator(std::string path);
 
+/**
+ * Returns the validator for the schema at \p path, which is only loaded and compiled the
+ * first time it is requested. The validator is shared between all callers and can be
+ * used from multiple threads at the same time.
+ */
+const nlohmann::json_schema::json_validator& sharedValidator(const std::string& path);
+
 } // namespace validation
 
 #endif // __COMMON__JSONVALIDATION_H__
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__LATENCYHISTOGRAM_H__
+#define __COMMON__LATENCYHISTOGRAM_H__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+/**
+ * A histogram of the most recent latency measurements of a connection. The values are
+ * sorted into buckets whose width grows with the value, so that every bucket is at most
+ * an eighth as wide as its lower bound. The percentiles are thus accurate to within
+ * 12.5% no matter whether the latency is in the range of microseconds or seconds, while
+ * the memory and the time to compute a percentile stay constant. Only the last
+ * `windowSize` values are part of the histogram, so that a connection whose latency gets
+ * worse shows up in the percentiles instead of being hidden by a long history.
+ */
+class LatencyHistogram {
+public:
+    /// Creates an empty histogram that keeps the last \p windowSize values
+    explicit LatencyHistogram(std::size_t windowSize = 256);
+
+    /// Adds the \p value to the histogram, which replaces the oldest value if the window
+    /// is full. Values above 2^32 microseconds (about 71 minutes) are clamped
+    void add(std::chrono::microseconds value);
+
+    /**
+     * Returns the value below which the \p fraction of the values in the window are. The
+     * result is the upper bound of the bucket the value falls into.
+     *
+     * \param fraction The fraction of the values in the range [0, 1], for example 0.99
+     *        for the 99th percentile
+     * \return The percentile or 0 if the histogram is empty
+     */
+    std::chrono::microseconds percentile(double fraction) const;
+
+    /// Returns the number of values that are currently in the window
+    std::size_t count() const;
+
+    /// Removes all values from the histogram
+    void clear();
+
+private:
+    /// Each power of two is split into this many buckets
+    static constexpr int SubBuckets = 8;
+    /// Values below 2^MaxExponent are counted in the buckets, larger ones are clamped
+    static constexpr int MaxExponent = 32;
+    static constexpr int NBuckets = SubBuckets * (MaxExponent - 2);
+
+    static int bucket(std::uint64_t value);
+    static std::uint64_t upperBound(int bucket);
+
+    std::array<std::uint32_t, NBuckets> _counts = {};
+    /// The buckets of the values in the window in the order in which they were added
+    std::vector<std::uint8_t> _window;
+    std::size_t _windowSize = 0;
+    /// The position in the window that is overwritten next once the window is full
+    std::size_t _next = 0;
+};
+
+} // namespace common
+
+#endif // __COMMON__LATENCYHISTOGRAM_H__
@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__LAUNCHSCHEDULER_H__
+#define __COMMON__LAUNCHSCHEDULER_H__
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/**
+ * Decides when the items of a rollout are launched, for example the instances of a
+ * program on the nodes of a cluster. The items of a rollout are launched in order with a
+ * delay between two of them. Every rollout belongs to a group that can limit how many
+ * launches are in flight at the same time across all of its rollouts; a launch stays in
+ * flight until it is confirmed or until it timed out. A rollout can be held back until
+ * some preparation has finished and it can be cancelled at any time. The current time is
+ * passed in by the caller so that this class does not depend on any timer.
+ */
+class LaunchScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        /// The time after which a launch that was not confirmed no longer counts towards
+        /// the limit of its group
+        std::chrono::milliseconds launchTimeout = std::chrono::seconds(30);
+    };
+
+    struct Rollout {
+        /// The group whose limit of concurrent launches applies to this rollout
+        int group = 0;
+        /// The items that are launched, in this order
+        std::vector<int> items;
+        /// The minimum time between the launches of two consecutive items
+        std::chrono::milliseconds delay = std::chrono::milliseconds(0);
+    };
+
+    /// The `item` of the rollout with the identifier `rollout` that should be launched
+    struct Launch {
+        int rollout = -1;
+        int item = -1;
+    };
+
+    LaunchScheduler();
+    explicit LaunchScheduler(Options options);
+
+    /**
+     * Adds the \p rollout, whose first item is launched right away unless it \p isHeld.
+     *
+     * \return The identifier of the rollout
+     */
+    int add(Rollout rollout, Clock::time_point now, bool isHeld = false);
+
+    /// Allows the rollout with the \p id that was added as held to start launching
+    void release(int id, Clock::time_point now);
+
+    /**
+     * Cancels the rollout with the \p id. The launches that are in flight still count
+     * towards the limit of the group until they are confirmed or time out.
+     *
+     * \return The items that have not been launched yet
+     */
+    std::vector<int> cancel(int id);
+
+    /// Sets the maximum number of launches of the \p group that can be in flight at the
+    /// same time. A \p limit of 0 means that the number is not limited
+    void setLimit(int group, std::size_t limit);
+
+    /// Confirms the launch of the \p item of the rollout with the \p id, which frees up
+    /// its place for the next launch of its group
+    void setLaunched(int id, int item);
+
+    /// Returns the items that should be launched now. They are in flight afterwards
+    std::vector<Launch> update(Clock::time_point now);
+
+    /**
+     * Returns the time at which update has to be called next, or `std::nullopt` if
+     * nothing will happen until one of the other functions is called.
+     */
+    std::optional<Clock::time_point> nextUpdate() const;
+
+    /// Returns whether the rollout with the \p id still has items that are not launched
+    bool contains(int id) const;
+
+    /// Returns whether the launch of the \p item of the rollout with the \p id is in
+    /// flight, meaning that it was neither confirmed nor has it timed out yet
+    bool isInFlight(int id, int item) const;
+
+    /// Returns the number of launches of the \p group that are in flight
+    std::size_t nInFlight(int group) const;
+
+private:
+    struct State {
+        Rollout rollout;
+        /// The index of the next item that is launched
+        std::size_t next = 0;
+        bool isHeld = false;
+        /// The earliest time at which the next item can be launched
+        Clock::time_point nextLaunch;
+    };
+
+    struct InFlight {
+        int group = 0;
+        Clock::time_point timeout;
+    };
+
+    /// Returns whether the \p group can launch another item
+    bool hasCapacity(int group) const;
+
+    Options _options;
+    std::map<int, State> _rollouts;
+    /// The launches that are in flight, keyed by the rollout and the item
+    std::map<std::pair<int, int>, InFlight> _inFlight;
+    std::map<int, std::size_t> _nInFlight;
+    std::map<int, std::size_t> _limits;
+    int _nextId = 0;
+};
+
+} // namespace common
+
+#endif // __COMMON__LAUNCHSCHEDULER_H__
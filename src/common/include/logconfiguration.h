@@ -35,8 +35,10 @@
 #ifndef __COMMON__LOGCONFIGURATION_H__
 #define __COMMON__LOGCONFIGURATION_H__
 
+#include "logging.h"
 #include <nlohmann/json.hpp>
 #include <chrono>
+#include <map>
 
 namespace common {
 
@@ -48,6 +50,18 @@ struct LogRotation {
 void to_json(nlohmann::json& j, const LogRotation& c);
 void from_json(const nlohmann::json& j, LogRotation& c);
 
+/// The levels of the categories that deviate from the default level, which is determined
+/// by the debug command line argument
+struct LogLevels {
+    std::map<LogCategory, LogLevel> levels;
+};
+
+void to_json(nlohmann::json& j, const LogLevels& c);
+void from_json(const nlohmann::json& j, LogLevels& c);
+
+/// Sets the level of every category that is contained in the \p levels
+void applyLogLevels(const LogLevels& levels);
+
 } // namespace common
 
 #endif // __COMMON__LOGCONFIGURATION_H__
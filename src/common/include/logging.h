@@ -36,12 +36,53 @@
 #define __COMMON__LOGGING_H__
 
 #include <QString>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace common {
+
+/// The subsystems that produce log messages. Each of them has its own LogLevel
+enum class LogCategory {
+    /// Everything that does not fit into any of the other categories
+    General = 0,
+    /// Connections and the frames that are sent through them
+    Network,
+    /// The contents of the individual messages that are sent and received
+    Messages,
+    /// The starting, stopping, and monitoring of processes
+    Processes,
+    /// The widgets of the user interface
+    Ui,
+    /// The REST API that is provided by C-Troll
+    Rest
+};
+
+/// The number of values in the LogCategory enum
+constexpr std::size_t NumLogCategories = 6;
+
+/// The severity of a log message. A category logs all messages at or above its level
+enum class LogLevel {
+    Debug = 0,
+    Info,
+    /// Disables all messages of a category
+    None
+};
+
+} // namespace common
 
 /**
  * This method is a shortcut for a more convenient logging. Calling this function is
@@ -64,6 +105,34 @@ void Log(std::string category, std::string message);
  */
 void Debug(std::string category, std::string message);
 
+/**
+ * Logs a debug message in the \p category, but only formats it if debug messages are
+ * enabled for that category. The \p args are passed to std::format unchanged, so they
+ * should be cheap to evaluate. For arguments that are expensive to compute, use the
+ * overload that takes a function instead.
+ *
+ * \param category The category that determines whether the message is logged
+ * \param label The label that is printed in front of the message
+ * \param fmt The format string of the message
+ * \param args The arguments that are formatted into the message
+ */
+template <typename... Args>
+void Debug(common::LogCategory category, std::string_view label,
+           std::format_string<Args...> fmt, Args&&... args);
+
+/**
+ * Logs a debug message in the \p category. The \p message function is only called if
+ * debug messages are enabled for that category, so any work that is needed to create the
+ * message, such as serializing a JSON object, is skipped otherwise.
+ *
+ * \param category The category that determines whether the message is logged
+ * \param label The label that is printed in front of the message
+ * \param message A function returning the message that is to be logged
+ */
+template <typename F>
+    requires std::is_invocable_r_v<std::string, F&>
+void Debug(common::LogCategory category, std::string_view label, F&& message);
+
 /**
  * A logging function suitable to be passed to the qInstallMessageHandler to redirect Qt
  * log messages to our built-in functionality. See the Qt documentation for explanations
@@ -80,9 +149,38 @@ namespace common {
  * function. Every following call to logMessage will be relegated to both a file that is
  * called `log_{application}.txt`. as well as the console. Every time the log file is
  * created, the old contents will be silently overwritten.
+ *
+ * The messages are not written by the thread that logs them. Instead, they are added to a
+ * lock-free queue that is drained by a background thread, which writes them to the file
+ * in batches and only flushes the file periodically. The logging function is called on
+ * the main thread once per batch instead of once per message.
  */
 class Log {
 public:
+    /// The settings of the background thread that writes the messages
+    struct Options {
+        /// After the first message arrives, the writer waits this long for more messages
+        /// to write them as a single batch. This is also the longest delay before
+        /// messages are passed to the logging function
+        std::chrono::milliseconds batchInterval = std::chrono::milliseconds(16);
+        /// Written messages are flushed to the log file at least this often
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds(250);
+        /// The log file is also flushed once this many bytes were written to it since
+        /// the last flush
+        std::size_t flushSize = 64 * 1024;
+        /// If more bytes than this are waiting to be written or to be passed to the
+        /// logging function, new messages are dropped until both have caught up
+        std::size_t maxPendingBytes = 16 * 1024 * 1024;
+    };
+
+    /// Counters of the messages that have passed through the Log
+    struct Statistics {
+        /// The number of messages that were written
+        std::uint64_t nWritten = 0;
+        /// The number of messages that were dropped because the queue was full
+        std::uint64_t nDropped = 0;
+    };
+
     /**
      * Initializes the static Log and opens the log file for reading.
      *
@@ -110,8 +208,8 @@ public:
 
     /**
      * Logs a message with the Log. This message is both logged to the log file as well
-     * as to the console using the \c qDebug macro. Every content to the file is flushed
-     * immediately.
+     * as to the console using the \c qDebug macro. The message is only queued here and
+     * written by the background writer shortly afterwards.
      *
      * \param category The category/type of the messages
      * \param message The message that is to be logged
@@ -119,9 +217,9 @@ public:
     static void logMessage(std::string category, std::string message);
 
     /**
-     * Logs a debug message with the Log. If the Log was created accepting debug log
-     * messages, this message is both logged to the log file as well as to the console
-     * using the \c qDebug macro. Every content to the file is flushed immediately.
+     * Logs a debug message with the Log. This message is both logged to the log file as
+     * well as to the console using the \c qDebug macro. Callers are expected to check
+     * isEnabled first, which the Debug functions do.
      *
      * \param category The category/type of the messages
      * \param message The message that is to be logged
@@ -140,12 +238,53 @@ public:
      */
     bool shouldLogDebugMessage() const;
 
+    /**
+     * Returns \c true if messages of the \p level should be logged for the \p category.
+     * This is cheap enough to be called before every message and can be called before
+     * the Log was initialized, in which case only non-debug messages are enabled.
+     */
+    static bool isEnabled(LogCategory category, LogLevel level);
+
+    /**
+     * Sets the \p level of the \p category. This can be called at any time from any
+     * thread and takes effect for all messages that are logged afterwards.
+     */
+    static void setLevel(LogCategory category, LogLevel level);
+
+    /// Returns the current level of the \p category
+    static LogLevel level(LogCategory category);
+
     /**
      * Sets a logging function that will get called whenever a message should be logged.
      */
     void setLoggingFunction(std::function<void(std::string)> loggingFunction);
 
+    /// Sets the \p options of the background writer, which take effect immediately
+    void setOptions(Options options);
+
+    /// Returns the counters of the messages that were written or dropped so far
+    Statistics statistics() const;
+
+    /**
+     * Writes all messages that are still queued and stops the background writer. Any
+     * message that is logged afterwards is written immediately by the logging thread.
+     * This is called automatically when the application exits.
+     */
+    static void shutdown();
+
 private:
+    /// A queued message. The queue is a singly linked list in reverse order
+    struct Entry {
+        std::string message;
+        Entry* next = nullptr;
+    };
+
+    void enqueue(std::string message);
+    void writeImmediately(const std::string& message);
+    void runWriter(std::stop_token stopToken);
+    std::size_t writeBatch(Entry* entries, bool isStopping);
+    void deliverToLoggingFunction();
+
     /**
      * Constructs a Log and opens the file for reading, overwriting any old content that
      * was in the file previously.
@@ -161,18 +300,52 @@ private:
     // The static Log that is returned in the Log::ref method
     static Log* _log;
 
-    const bool _shouldLogDebug;
+    /// The current LogLevel of each LogCategory
+    static std::array<std::atomic<LogLevel>, NumLogCategories> _levels;
 
     /// Mutex that protects the access to the log file
     std::mutex _access;
 
+    /// The most recently queued message or nullptr if the queue is empty
+    std::atomic<Entry*> _pending = nullptr;
+    /// The number of bytes in all messages that are queued or wait for the logging
+    /// function
+    std::atomic<std::size_t> _pendingBytes = 0;
+    std::atomic<std::size_t> _maxPendingBytes = Options().maxPendingBytes;
+    std::atomic<std::uint64_t> _nWritten = 0;
+    std::atomic<std::uint64_t> _nDropped = 0;
+    /// The number of dropped messages that were already reported in the log
+    std::uint64_t _nReportedDropped = 0;
+    std::atomic<bool> _isWriterRunning = false;
+
+    /// Mutex that protects the _options and is used to wake up the writer
+    std::mutex _wakeMutex;
+    std::condition_variable_any _wake;
+    Options _options;
+
+    /// Mutex that protects the messages that wait for the logging function
+    std::mutex _loggingFunctionAccess;
+    std::vector<std::string> _loggingFunctionBatch;
+    /// The number of bytes of the queued messages in _loggingFunctionBatch
+    std::size_t _loggingFunctionBytes = 0;
+    std::atomic<bool> _isDeliveryScheduled = false;
+
     /// The log file to which all messages from the logMessage method get logged
     std::string _filePath;
     std::ofstream _file;
 
     std::function<void(std::string)> _loggingFunction;
+
+    /// The background writer, declared last so that it is stopped before the rest of
+    /// the members are destroyed
+    std::jthread _writer;
 };
 
+inline bool Log::isEnabled(LogCategory category, LogLevel level) {
+    const std::size_t idx = static_cast<std::size_t>(category);
+    return level >= _levels[idx].load(std::memory_order_relaxed);
+}
+
 } // namespace common
 
 inline void QtLogFunction(QtMsgType, const QMessageLogContext&, const QString& msg) {
@@ -184,9 +357,29 @@ inline void Log(std::string category, std::string message) {
 }
 
 inline void Debug(std::string category, std::string message) {
-    if (common::Log::ref()->shouldLogDebugMessage()) {
+    if (common::Log::isEnabled(common::LogCategory::General, common::LogLevel::Debug)) {
         common::Log::logDebugMessage(std::move(category), std::move(message));
     }
 }
 
+template <typename... Args>
+void Debug(common::LogCategory category, std::string_view label,
+           std::format_string<Args...> fmt, Args&&... args)
+{
+    if (common::Log::isEnabled(category, common::LogLevel::Debug)) {
+        common::Log::logDebugMessage(
+            std::string(label),
+            std::format(fmt, std::forward<Args>(args)...)
+        );
+    }
+}
+
+template <typename F>
+    requires std::is_invocable_r_v<std::string, F&>
+void Debug(common::LogCategory category, std::string_view label, F&& message) {
+    if (common::Log::isEnabled(category, common::LogLevel::Debug)) {
+        common::Log::logDebugMessage(std::string(label), message());
+    }
+}
+
 #endif // __COMMON__LOGGING_H__
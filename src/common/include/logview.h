@@ -0,0 +1,153 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__LOGVIEW_H__
+#define __COMMON__LOGVIEW_H__
+
+#include <QAbstractListModel>
+
+#include <QString>
+#include <QTimer>
+#include <QWidget>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class QComboBox;
+class QListView;
+
+namespace common {
+
+/**
+ * A list model that stores the most recent log messages in a ring buffer. Once the
+ * maximum number of lines is reached, every new message replaces the oldest one, so the
+ * memory usage does not grow no matter how long the application is running. Messages are
+ * not added immediately, but collected and inserted together at most once per repaint.
+ * The model can be restricted to the messages of a single category, which is extracted
+ * from the `(category)` part of each message that is produced by the Log.
+ */
+class LogModel : public QAbstractListModel {
+Q_OBJECT
+public:
+    explicit LogModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /// Queues the \p message to be added to the model at the next repaint
+    void append(std::string message);
+
+    /**
+     * Sets the maximum number of lines that are kept. If there are currently more lines
+     * than that, the oldest ones are removed.
+     */
+    void setMaxLines(std::size_t maxLines);
+
+    /// Returns the maximum number of lines that are kept
+    std::size_t maxLines() const;
+
+    /**
+     * Only shows the messages that belong to the \p category from now on. If the
+     * \p category is empty, all messages are shown.
+     */
+    void setCategoryFilter(const QString& category);
+
+signals:
+    /// Emitted whenever a message of a category is added that was not seen before
+    void categoryAdded(const QString& category);
+
+private:
+    struct Line {
+        QString text;
+        /// The index of the category of this line in _categories
+        std::uint32_t category = 0;
+    };
+
+    void flushPending();
+    std::uint32_t findOrAddCategory(std::string_view category);
+    const Line& line(std::uint64_t seq) const;
+
+    /// The ring buffer of lines. The line with the sequence number s is stored at the
+    /// index s % _maxLines
+    std::vector<Line> _lines;
+    /// The sequence number of the oldest line that is still stored
+    std::uint64_t _firstSeq = 0;
+    /// The sequence number that the next line will get
+    std::uint64_t _nextSeq = 0;
+    std::size_t _maxLines = 10000;
+
+    std::vector<QString> _categories;
+    std::map<std::string, std::uint32_t, std::less<>> _categoryIndices;
+
+    /// The category that is shown or std::nullopt if all categories are shown
+    std::optional<std::uint32_t> _filter;
+    /// The sequence numbers of the stored lines that match the _filter in order
+    std::deque<std::uint64_t> _filtered;
+
+    /// The messages that are added at the next repaint
+    std::vector<std::string> _pending;
+    QTimer _flushTimer;
+};
+
+/**
+ * A widget that shows the log messages of a LogModel in a list view that only ever
+ * creates the visible rows. A combobox above the list makes it possible to only show the
+ * messages of a single category. The view stays scrolled to the bottom as long as the
+ * user does not scroll up.
+ */
+class LogView : public QWidget {
+Q_OBJECT
+public:
+    explicit LogView(QWidget* parent = nullptr);
+
+    /// Adds the \p message to the end of the log
+    void appendMessage(std::string message);
+
+    /// Sets the maximum number of lines that are kept in the log
+    void setMaxLines(std::size_t maxLines);
+
+private:
+    LogModel* _model = nullptr;
+    QListView* _view = nullptr;
+    QComboBox* _categories = nullptr;
+    bool _isAtBottom = true;
+};
+
+} // namespace common
+
+#endif // __COMMON__LOGVIEW_H__
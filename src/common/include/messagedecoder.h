@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__MESSAGEDECODER_H__
+#define __COMMON__MESSAGEDECODER_H__
+
+#include "framedecoder.h"
+#include "messages/processoutputmessage.h"
+#include "messages/processstatusmessage.h"
+#include "messages/traystatusmessage.h"
+#include <nlohmann/json.hpp>
+#include <string_view>
+#include <variant>
+
+namespace common {
+
+/// The messages that can be decoded directly from the payload of a frame, or the JSON
+/// document for all other messages
+using DecodedMessage = std::variant<
+    ProcessOutputMessage, ProcessStatusMessage, TrayStatusMessage, nlohmann::json
+>;
+
+/**
+ * Decodes the \p payload of a frame directly into one of the message structs of the
+ * DecodedMessage without building a JSON document first. The payload is consumed as a
+ * stream of SAX events and the values are moved into the fields of the message as they
+ * are encountered, so decoding a ProcessOutputMessage only allocates its strings. If the
+ * payload contains a different message or a field that is unknown to this decoder, the
+ * JSON document of the payload is built instead during the same pass.
+ *
+ * \param payload The bytes of the frame after it was decrypted and decompressed
+ * \param encoding The encoding in which the \p payload is stored
+ * \return The decoded message or the JSON document of the \p payload
+ * \throw std::runtime_error If the payload is malformed, or if a message that is decoded
+ *         directly has an incompatible version or is missing a required field
+ */
+DecodedMessage decodeMessage(std::string_view payload, Encoding encoding);
+
+} // namespace common
+
+#endif // __COMMON__MESSAGEDECODER_H__
@@ -0,0 +1,272 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__MESSAGEDISPATCHER_H__
+#define __COMMON__MESSAGEDISPATCHER_H__
+
+#include "messages.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace common {
+
+/// A compile-time list of message types
+template <typename... Ts>
+struct MessageList {
+    static constexpr std::size_t Size = sizeof...(Ts);
+};
+
+/// The registry of all messages that can be sent between C-Troll and the Tray. Every new
+/// message has to be added to this list to be dispatchable
+using Messages = MessageList<
+    ErrorOccurredMessage,
+    ExitCommandMessage,
+    FetchOutputMessage,
+    InvalidAuthMessage,
+    KillAllMessage,
+    KillTrayMessage,
+    OutputCreditMessage,
+    PingMessage,
+    PongMessage,
+    ProcessOutputMessage,
+    ProcessStatusMessage,
+    RestartNodeMessage,
+    SelectEncodingMessage,
+    ShutdownNodeMessage,
+    StartCommandMessage,
+    TrayConnectedMessage,
+    TrayStatusMessage
+>;
+
+/// The interned identifier of a message type, which is its index in the Messages list
+using MessageTypeId = std::size_t;
+
+namespace detail {
+    template <typename T, typename... Ts>
+    constexpr MessageTypeId indexOf(MessageList<Ts...>) {
+        constexpr std::array<bool, sizeof...(Ts)> matches = { std::is_same_v<T, Ts>... };
+        for (std::size_t i = 0; i < matches.size(); i++) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        throw "Message type is not part of the registry";
+    }
+} // namespace detail
+
+/// The identifier of the message type \tparam T
+template <typename T>
+constexpr MessageTypeId messageTypeId = detail::indexOf<T>(Messages{});
+
+/// Returns the name of the message type with the identifier \p id
+std::string_view messageTypeName(MessageTypeId id);
+
+/**
+ * Returns the identifier of the message type with the name \p type or `std::nullopt` if
+ * there is no such message in the registry.
+ */
+std::optional<MessageTypeId> findMessageType(std::string_view type);
+
+/// The result of inspecting the type and version fields of a message exactly once
+struct MessageHeader {
+    enum class Status {
+        /// The message has a compatible version and a known type
+        Valid,
+        /// The message is missing the type or the version or they are malformed
+        Invalid,
+        /// The major version of the message is different from our API version
+        IncompatibleVersion,
+        /// The message has a compatible version but a type that is not in the registry
+        UnknownType
+    };
+
+    Status status = Status::Invalid;
+    /// The identifier of the message type, only valid if the status is Status::Valid
+    MessageTypeId typeId = 0;
+};
+
+/// Reads the type and version fields of the \p message without allocating any memory
+MessageHeader decodeMessageHeader(const nlohmann::json& message);
+
+/**
+ * This class calls a handler for each received message based on its type. The header of
+ * the message is decoded only once and the handler is then looked up in a table that is
+ * indexed by the MessageTypeId, so the cost of dispatching a message does not depend on
+ * the number of message types. All \tparam Args are passed on to the handlers unchanged
+ * to provide context, for example the connection that the message was received on.
+ */
+template <typename... Args>
+class MessageDispatcher {
+public:
+    /// The counters of how many messages were dispatched or rejected
+    struct Statistics {
+        /// The number of messages for which a handler was called
+        std::uint64_t nDispatched = 0;
+        /// The number of messages with a known type, but without a registered handler
+        std::uint64_t nUnhandled = 0;
+        /// The number of messages whose type is not part of the registry
+        std::uint64_t nUnknownType = 0;
+        /// The number of messages with a missing or incompatible type or version
+        std::uint64_t nInvalid = 0;
+    };
+
+    using Fallback = std::function<void(const nlohmann::json&, Args...)>;
+
+    /**
+     * Registers the \p handler for messages of type \tparam T, replacing any previously
+     * registered handler. The handler is called either as `handler(T, Args...)` or as
+     * `handler(T, const nlohmann::json&, Args...)` if it also needs the raw message.
+     */
+    template <typename T, typename F>
+    void on(F handler) {
+        if constexpr (std::is_invocable_v<F&, T, Args...>) {
+            // Handlers that only need the message struct can also be called directly
+            // with a message that was already decoded, see dispatchMessage
+            _typedHandlers[messageTypeId<T>] =
+                [h = handler](void* message, Args... args) {
+                    h(std::move(*static_cast<T*>(message)), args...);
+                };
+        }
+        else {
+            _typedHandlers[messageTypeId<T>] = nullptr;
+        }
+
+        _handlers[messageTypeId<T>] =
+            [h = std::move(handler)](const nlohmann::json& message, Args... args) {
+                // The header was already checked before the handler was looked up
+                T msg;
+                from_json(message, msg, SkipValidation());
+                if constexpr (std::is_invocable_v<F&, T, Args...>) {
+                    h(std::move(msg), args...);
+                }
+                else {
+                    h(std::move(msg), message, args...);
+                }
+            };
+    }
+
+    /**
+     * Sets the \p fallback that is called with all messages that do not have a handler,
+     * regardless of whether they are unhandled, unknown, or invalid.
+     */
+    void setFallback(Fallback fallback) {
+        _fallback = std::move(fallback);
+    }
+
+    /**
+     * Calls the handler that is registered for the type of the \p message. If there is
+     * no such handler, the fallback is called instead.
+     *
+     * \return The status of the message header
+     */
+    MessageHeader::Status dispatch(const nlohmann::json& message, Args... args) {
+        return dispatch(decodeMessageHeader(message), message, args...);
+    }
+
+    /**
+     * Calls the handler that is registered for the type of the \p message, whose
+     * \p header was already decoded by the caller through decodeMessageHeader. This
+     * avoids decoding the header again if the caller also needs to know the type. As the
+     * handlers rely on the \p header, the message is not validated a second time.
+     *
+     * \return The status of the message header
+     */
+    MessageHeader::Status dispatch(const MessageHeader& header,
+                                   const nlohmann::json& message, Args... args)
+    {
+        switch (header.status) {
+            case MessageHeader::Status::Valid:
+                if (const Handler& handler = _handlers[header.typeId];  handler) {
+                    _statistics.nDispatched++;
+                    handler(message, args...);
+                    return header.status;
+                }
+                _statistics.nUnhandled++;
+                break;
+            case MessageHeader::Status::UnknownType:
+                _statistics.nUnknownType++;
+                break;
+            case MessageHeader::Status::Invalid:
+            case MessageHeader::Status::IncompatibleVersion:
+                _statistics.nInvalid++;
+                break;
+        }
+
+        if (_fallback) {
+            _fallback(message, args...);
+        }
+        return header.status;
+    }
+
+    /**
+     * Calls the handler that is registered for messages of type \tparam T with the
+     * already decoded \p message. This skips the JSON document altogether if the
+     * handler only needs the message struct. Otherwise, the \p message is converted back
+     * into a JSON document and passed to the dispatch function.
+     */
+    template <typename T>
+    void dispatchMessage(T message, Args... args) {
+        if (const TypedHandler& handler = _typedHandlers[messageTypeId<T>];  handler) {
+            _statistics.nDispatched++;
+            handler(&message, args...);
+            return;
+        }
+
+        dispatch(nlohmann::json(message), args...);
+    }
+
+    /// Returns the counters of the messages that were passed to this dispatcher
+    const Statistics& statistics() const {
+        return _statistics;
+    }
+
+private:
+    using Handler = std::function<void(const nlohmann::json&, Args...)>;
+    /// Receives a pointer to the message struct whose type matches the table index
+    using TypedHandler = std::function<void(void*, Args...)>;
+
+    std::array<Handler, Messages::Size> _handlers;
+    std::array<TypedHandler, Messages::Size> _typedHandlers;
+    Fallback _fallback;
+    Statistics _statistics;
+};
+
+} // namespace common
+
+#endif // __COMMON__MESSAGEDISPATCHER_H__
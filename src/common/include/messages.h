@@ -39,12 +39,17 @@
 
 #include "messages/erroroccurredmessage.h"
 #include "messages/exitcommandmessage.h"
+#include "messages/fetchoutputmessage.h"
 #include "messages/invalidauthmessage.h"
 #include "messages/killallmessage.h"
 #include "messages/killtraymessage.h"
+#include "messages/outputcreditmessage.h"
+#include "messages/pingmessage.h"
+#include "messages/pongmessage.h"
 #include "messages/processoutputmessage.h"
 #include "messages/processstatusmessage.h"
 #include "messages/restartnodemessage.h"
+#include "messages/selectencodingmessage.h"
 #include "messages/shutdownnodemessage.h"
 #include "messages/startcommandmessage.h"
 #include "messages/trayconnectedmessage.h"
@@ -57,6 +57,7 @@ struct ErrorOccurredMessage : public Message {
 
 void to_json(nlohmann::json& j, const ErrorOccurredMessage& m);
 void from_json(const nlohmann::json& j, ErrorOccurredMessage& m);
+void from_json(const nlohmann::json& j, ErrorOccurredMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -56,6 +56,7 @@ struct ExitCommandMessage : public Message {
 
 void to_json(nlohmann::json& j, const ExitCommandMessage& m);
 void from_json(const nlohmann::json& j, ExitCommandMessage& m);
+void from_json(const nlohmann::json& j, ExitCommandMessage& m, SkipValidation);
 
 } // namespace commmon
 
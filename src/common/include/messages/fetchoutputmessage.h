@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__FETCHOUTPUTMESSAGE_H__
+#define __COMMON__FETCHOUTPUTMESSAGE_H__
+
+#include "message.h"
+
+#include "messages/processoutputmessage.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace common {
+
+/// This struct is the data structure that gets send from the Core to the Tray to request
+/// the output of a process whose output is only sent on demand. The Tray answers with a
+/// ProcessOutputMessage that contains the requested range and its offset
+struct FetchOutputMessage : public Message {
+    static constexpr std::string_view Type = "FetchOutputMessage";
+
+    FetchOutputMessage();
+    bool operator==(const FetchOutputMessage& rhs) const noexcept = default;
+
+    /// The unique identifier of the process whose output is requested
+    int processId = -1;
+    /// The output stream that is requested
+    ProcessOutputMessage::OutputType outputType =
+        ProcessOutputMessage::OutputType::StdOut;
+    /// The offset from which on the output is requested. If this is not set, only the
+    /// most recent output is requested
+    std::optional<std::uint64_t> offset;
+    /// The maximum number of the most recent bytes that should be sent
+    std::uint64_t maxBytes = 64 * 1024;
+    /// If this is `true`, all new output is sent as it arrives until another request for
+    /// the same stream with this value set to `false` is received
+    bool follow = false;
+};
+
+void to_json(nlohmann::json& j, const FetchOutputMessage& m);
+void from_json(const nlohmann::json& j, FetchOutputMessage& m);
+void from_json(const nlohmann::json& j, FetchOutputMessage& m, SkipValidation);
+
+} // namespace common
+
+#endif // __COMMON__FETCHOUTPUTMESSAGE_H__
@@ -50,6 +50,7 @@ struct InvalidAuthMessage : public Message {
 
 void to_json(nlohmann::json& j, const InvalidAuthMessage& m);
 void from_json(const nlohmann::json& j, InvalidAuthMessage& m);
+void from_json(const nlohmann::json& j, InvalidAuthMessage& m, SkipValidation);
 
 } // namespace
 
@@ -51,6 +51,7 @@ struct KillAllMessage : public Message {
 
 void to_json(nlohmann::json& j, const KillAllMessage& m);
 void from_json(const nlohmann::json& j, KillAllMessage& m);
+void from_json(const nlohmann::json& j, KillAllMessage& m, SkipValidation);
 
 } // namespace commmon
 
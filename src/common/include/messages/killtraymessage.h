@@ -51,6 +51,7 @@ struct KillTrayMessage : public Message {
 
 void to_json(nlohmann::json& j, const KillTrayMessage& m);
 void from_json(const nlohmann::json& j, KillTrayMessage& m);
+void from_json(const nlohmann::json& j, KillTrayMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -74,14 +74,15 @@ using ApiVersion = std::array<int, 3>;
 template <typename T = void>
     requires std::is_same_v<T, void> || std::is_base_of_v<Message, T>
 [[nodiscard]] bool isValidMessage(const nlohmann::json& message) {
-    const bool hasType = message.contains(Message::KeyType);
-    const bool hasVersion = message.contains(Message::KeyVersion);
-    if (!hasType || !hasVersion) {
+    const auto type = message.find(Message::KeyType);
+    const auto version = message.find(Message::KeyVersion);
+    if (type == message.end() || version == message.end()) {
         return false;
     }
 
-    const ApiVersion version = message.at(Message::KeyVersion).get<ApiVersion>();
-    if (version[0] != api::MajorVersion) {
+    // Only the major version is relevant for the compatibility, so we don't need to
+    // convert the entire version
+    if (version->at(0).get<int>() != api::MajorVersion) {
         return false;
     }
     if constexpr (std::is_same_v<T, void>) {
@@ -90,8 +91,7 @@ template <typename T = void>
     }
     else {
         // Otherwise we want to check that the type is correct
-        const std::string type = message.at(Message::KeyType).get<std::string>();
-        return type == T::Type;
+        return type->get_ref<const std::string&>() == T::Type;
     }
 }
 
@@ -99,6 +99,11 @@ template <typename T = void>
 // Throws std::runtime_error if the version is different from the current version
 void validateMessage(const nlohmann::json& message, std::string_view expectedType);
 
+/// Selects the variant of the from_json functions of the messages that does not call
+/// validateMessage. Only use it if the type and version were already checked, for
+/// example through decodeMessageHeader
+struct SkipValidation {};
+
 void from_json(const nlohmann::json& j, Message& m);
 
 } // namespace common
@@ -0,0 +1,66 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__PINGMESSAGE_H__
+#define __COMMON__PINGMESSAGE_H__
+
+#include "message.h"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string_view>
+
+namespace common {
+
+/// This struct is the data structure that gets send from the Core to the Tray in a fixed
+/// interval. The Tray answers every one of these messages right away with a PongMessage,
+/// which is used to measure the round-trip time of the connection and to detect Trays
+/// that no longer respond
+struct PingMessage : public Message {
+    static constexpr std::string_view Type = "PingMessage";
+
+    PingMessage();
+    bool operator==(const PingMessage& rhs) const noexcept = default;
+
+    /// The number that identifies this heartbeat and that is returned in the answer
+    std::uint64_t sequence = 0;
+};
+
+void to_json(nlohmann::json& j, const PingMessage& m);
+void from_json(const nlohmann::json& j, PingMessage& m);
+void from_json(const nlohmann::json& j, PingMessage& m, SkipValidation);
+
+} // namespace common
+
+#endif // __COMMON__PINGMESSAGE_H__
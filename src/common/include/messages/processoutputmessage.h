@@ -38,6 +38,8 @@
 #include "message.h"
 
 #include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
 #include <string_view>
 
 namespace common {
@@ -61,10 +63,21 @@ struct ProcessOutputMessage : Message {
     std::string message;
     /// The type of output
     OutputType outputType = OutputType::StdOut;
+    /// The offset of the first byte of the #message in the entire output of the process.
+    /// This is only set for processes whose output is sent on demand
+    std::optional<std::uint64_t> offset;
 };
 
+/// Returns the name of the output \p type as it is used in the message
+std::string_view toString(ProcessOutputMessage::OutputType type);
+
+/// Returns the output type with the name \p type. Throws a std::runtime_error if the type
+/// is not known
+ProcessOutputMessage::OutputType outputTypeFromString(std::string_view type);
+
 void to_json(nlohmann::json& j, const ProcessOutputMessage& m);
 void from_json(const nlohmann::json& j, ProcessOutputMessage& m);
+void from_json(const nlohmann::json& j, ProcessOutputMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -69,8 +69,16 @@ struct ProcessStatusMessage : public Message {
     Status status = Status::Unknown;
 };
 
+/// Returns the name of the \p status as it is used in the message
+std::string_view toString(ProcessStatusMessage::Status status);
+
+/// Returns the status with the name \p status. Throws a std::runtime_error if the status
+/// is not known
+ProcessStatusMessage::Status statusFromString(std::string_view status);
+
 void to_json(nlohmann::json& j, const ProcessStatusMessage& m);
 void from_json(const nlohmann::json& j, ProcessStatusMessage& m);
+void from_json(const nlohmann::json& j, ProcessStatusMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -51,6 +51,7 @@ struct RestartNodeMessage : public Message {
 
 void to_json(nlohmann::json& j, const RestartNodeMessage& m);
 void from_json(const nlohmann::json& j, RestartNodeMessage& m);
+void from_json(const nlohmann::json& j, RestartNodeMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -51,6 +51,7 @@ struct ShutdownNodeMessage : public Message {
 
 void to_json(nlohmann::json& j, const ShutdownNodeMessage& m);
 void from_json(const nlohmann::json& j, ShutdownNodeMessage& m);
+void from_json(const nlohmann::json& j, ShutdownNodeMessage& m, SkipValidation);
 
 } // namespace common
 
@@ -37,7 +37,9 @@
 
 #include "message.h"
 
+#include "outputflowcontrol.h"
 #include <nlohmann/json.hpp>
+#include <cstdint>
 #include <string_view>
 
 namespace common {
@@ -60,6 +62,10 @@ struct StartCommandMessage : public Message {
     std::string commandlineParameters;
     /// This value determines whether the process should send back console messages
     bool forwardStdOutStdErr = false;
+    /// Determines which output is kept if it is produced faster than it can be sent
+    OutputPolicy outputPolicy = OutputPolicy::KeepTail;
+    /// If this is `true`, the output is kept on the tray until it is requested
+    bool outputOnDemand = false;
     /// This value determines whether the program should auto restart if it crashes
     bool autoRestart = false;
 
@@ -69,11 +75,18 @@ struct StartCommandMessage : public Message {
     int configurationId = -1;
     int clusterId = -1;
     int nodeId = -1;
-    std::size_t dataHash = 0;
+    /// The hash over all of the data that was loaded by the C-Troll
+    std::uint64_t dataHash = 0;
+    /// The hashes of the program, cluster, and node the process was started with, which
+    /// are used to determine which of them have changed since then
+    std::uint64_t programHash = 0;
+    std::uint64_t clusterHash = 0;
+    std::uint64_t nodeHash = 0;
 };
 
 void to_json(nlohmann::json& j, const StartCommandMessage& m);
 void from_json(const nlohmann::json& j, StartCommandMessage& m);
+void from_json(const nlohmann::json& j, StartCommandMessage& m, SkipValidation);
 
 } // namespace commmon
 
@@ -38,7 +38,9 @@
 #include "message.h"
 
 #include <nlohmann/json.hpp>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace common {
 
@@ -47,10 +49,26 @@ struct TrayConnectedMessage : public Message {
 
     TrayConnectedMessage();
     bool operator==(const TrayConnectedMessage& rhs) const noexcept = default;
+
+    /// The binary encodings that the Tray understands in addition to JSON text, ordered
+    /// by preference. Older Trays do not send this list and only understand JSON text
+    std::vector<std::string> encodings;
+
+    /// The compression methods that the Tray is able to decompress
+    std::vector<std::string> compressions;
+
+    /// Whether the Tray limits its process output to the credits granted through
+    /// OutputCreditMessages. Older Trays always send all output
+    bool supportsOutputCredits = false;
+
+    /// Whether the Tray answers PingMessages. Older Trays would ignore them and could
+    /// not be told apart from Trays that stopped responding
+    bool supportsHeartbeat = false;
 };
 
 void to_json(nlohmann::json& j, const TrayConnectedMessage& m);
 void from_json(const nlohmann::json& j, TrayConnectedMessage& m);
+void from_json(const nlohmann::json& j, TrayConnectedMessage& m, SkipValidation);
 
 } // namespace common
 
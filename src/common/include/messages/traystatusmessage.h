@@ -38,6 +38,7 @@
 #include "message.h"
 
 #include <nlohmann/json.hpp>
+#include <cstdint>
 #include <string_view>
 #include <vector>
 
@@ -57,7 +58,11 @@ struct TrayStatusMessage : public Message {
         int configurationId;
         int clusterId;
         int nodeId;
-        std::size_t dataHash;
+        std::uint64_t dataHash;
+        // These are 0 for processes that were started by an older C-Troll
+        std::uint64_t programHash = 0;
+        std::uint64_t clusterHash = 0;
+        std::uint64_t nodeHash = 0;
     };
 
     std::vector<ProcessInfo> processes;
@@ -65,6 +70,7 @@ struct TrayStatusMessage : public Message {
 
 void to_json(nlohmann::json& j, const TrayStatusMessage& m);
 void from_json(const nlohmann::json& j, TrayStatusMessage& m);
+void from_json(const nlohmann::json& j, TrayStatusMessage& m, SkipValidation);
 
 } // namespace
 
@@ -38,6 +38,8 @@
 #include "typedid.h"
 #include <nlohmann/json.hpp>
 
+namespace common { template <typename T> struct JsonFileCache; }
+
 /**
  * This struct contains information about individual computer nodes of the cluster.
  * Each node has a human-readable \m name, an \m ipAddress, and a \m port on which the
@@ -78,9 +80,12 @@ void to_json(nlohmann::json& j, const Node& n);
  * \c JSON file in it will be interpreted as a node configuration and returned.
  *
  * \param directory The directory that is walked in search for `*.json` files
+ * \param cache If provided, only the files that have changed since the last call with
+ *        the same cache are parsed again
  * \return A list of all Nodes%s that were found by walking the \p directory, the second
  *         parameter is true if all files loaded successfully
  */
-std::pair<std::vector<Node>, bool> loadNodesFromDirectory(std::string_view directory);
+std::pair<std::vector<Node>, bool> loadNodesFromDirectory(std::string_view directory,
+    common::JsonFileCache<Node>* cache = nullptr);
 
 #endif // __COMMON__NODE_H__
@@ -0,0 +1,114 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__OUTPUTBUFFER_H__
+#define __COMMON__OUTPUTBUFFER_H__
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * Stores the most recent output of a process, limited to a maximum number of bytes and
+ * lines. The output is appended in chunks as it arrives and the oldest chunks are
+ * discarded once either of the limits is exceeded. Every byte that was ever appended has
+ * an absolute offset, which makes it possible to ask for all output that was appended
+ * since a previous call, as long as it has not been discarded in the meantime.
+ */
+class OutputBuffer {
+public:
+    struct Limits {
+        /// The maximum number of bytes that are kept
+        std::size_t maxBytes = 1024 * 1024;
+        /// The maximum number of lines that are kept
+        std::size_t maxLines = 10000;
+    };
+
+    OutputBuffer();
+    explicit OutputBuffer(Limits limits);
+
+    /**
+     * Appends the \p text to the end of the buffer and discards the oldest output until
+     * the buffer is within its limits again.
+     */
+    void append(std::string_view text);
+
+    /**
+     * Returns all output that is stored starting at the absolute \p offset. If the
+     * \p offset is smaller than the beginOffset, all stored output is returned.
+     */
+    std::string text(std::uint64_t offset = 0) const;
+
+    /// Returns the absolute offset of the oldest byte that is still stored
+    std::uint64_t beginOffset() const;
+
+    /// Returns the absolute offset just after the most recently appended byte
+    std::uint64_t endOffset() const;
+
+    /// Returns the number of bytes that are currently stored
+    std::size_t size() const;
+
+    /// Returns the number of lines that are currently stored
+    std::size_t lineCount() const;
+
+    /// Sets new \p limits, discarding the oldest output if necessary
+    void setLimits(Limits limits);
+
+    /// Returns the limits of this buffer
+    const Limits& limits() const;
+
+    /// Discards all stored output. The offsets continue from where they were
+    void clear();
+
+private:
+    struct Chunk {
+        std::string text;
+        std::size_t nLines = 0;
+    };
+
+    void trim();
+
+    Limits _limits;
+    std::deque<Chunk> _chunks;
+    std::uint64_t _beginOffset = 0;
+    std::size_t _nBytes = 0;
+    std::size_t _nLines = 0;
+};
+
+} // namespace common
+
+#endif // __COMMON__OUTPUTBUFFER_H__
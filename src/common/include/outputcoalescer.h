@@ -0,0 +1,149 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__OUTPUTCOALESCER_H__
+#define __COMMON__OUTPUTCOALESCER_H__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * Limits the number of bytes that are accepted in each second. A single limit can be
+ * shared by multiple OutputCoalescer, for example for the standard output and the
+ * standard error of the same process, so that the limit applies to their sum.
+ */
+class OutputRateLimit {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Creates the limit for \p maxBytesPerSecond bytes per second. 0 means no limit
+    explicit OutputRateLimit(std::size_t maxBytesPerSecond = 0);
+
+    /**
+     * Returns whether \p nBytes that are received at the time \p now are accepted and,
+     * if so, counts them against the limit. Whole chunks are accepted or rejected, so
+     * the limit can be exceeded by one chunk.
+     */
+    bool accept(std::size_t nBytes, Clock::time_point now);
+
+private:
+    std::size_t _maxBytesPerSecond = 0;
+
+    /// The start of the one second window that the limit is applied to
+    Clock::time_point _windowStart;
+    std::size_t _windowBytes = 0;
+};
+
+/**
+ * Collects the output of a single process pipe so that it can be sent out in fewer, but
+ * larger messages. Pending output should be sent once the interval since the first
+ * pending byte has passed or as soon as the flush size is reached, whichever comes
+ * first. In addition, the number of bytes that are accepted in each second is limited,
+ * either by the coalescer itself or by an OutputRateLimit that is shared with others.
+ * Output beyond that limit is dropped and replaced with a marker stating the number of
+ * bytes that were lost. The current time is passed in by the caller so that this class
+ * does not depend on any timer.
+ */
+class OutputCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        /// The maximum time that output is kept before it should be sent
+        std::chrono::milliseconds interval = std::chrono::milliseconds(50);
+        /// The number of pending bytes at which the output should be sent immediately
+        std::size_t flushSize = 16 * 1024;
+        /// The maximum number of bytes that are accepted per second. 0 means no limit.
+        /// This is ignored for output that is appended with a shared OutputRateLimit
+        std::size_t maxBytesPerSecond = 1024 * 1024;
+    };
+
+    OutputCoalescer();
+    explicit OutputCoalescer(Options options);
+
+    /**
+     * Adds the \p text that was received at the time \p now to the pending output. If
+     * the rate limit has already been reached, the \p text is dropped instead.
+     *
+     * \return `true` if the pending output has reached the flush size and should be
+     *         taken right away
+     */
+    bool append(std::string_view text, Clock::time_point now);
+
+    /**
+     * Adds the \p text that was received at the time \p now to the pending output,
+     * unless the shared \p rateLimit has already been reached, in which case the \p text
+     * is dropped instead.
+     *
+     * \return `true` if the pending output has reached the flush size and should be
+     *         taken right away
+     */
+    bool append(std::string_view text, Clock::time_point now,
+        OutputRateLimit& rateLimit);
+
+    /// Returns whether there is any output (or dropped marker) waiting to be taken
+    bool hasPending() const;
+
+    /// Returns the time at which the pending output should be taken at the latest
+    Clock::time_point deadline() const;
+
+    /**
+     * Returns all pending output and resets the buffer. If output was dropped since the
+     * last call, a marker line with the number of dropped bytes is appended.
+     */
+    std::string take();
+
+    /// Returns the total number of bytes that were dropped due to the rate limit
+    std::uint64_t totalDropped() const;
+
+private:
+    Options _options;
+
+    std::string _pending;
+    Clock::time_point _firstPending;
+
+    /// The limit that is used if no shared limit is passed to append
+    OutputRateLimit _rateLimit;
+
+    std::uint64_t _nDropped = 0;
+    std::uint64_t _nTotalDropped = 0;
+};
+
+} // namespace common
+
+#endif // __COMMON__OUTPUTCOALESCER_H__
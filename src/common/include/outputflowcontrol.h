@@ -0,0 +1,165 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__OUTPUTFLOWCONTROL_H__
+#define __COMMON__OUTPUTFLOWCONTROL_H__
+
+#include "messages/processoutputmessage.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace common {
+
+class SharedMessage;
+
+/// Determines which part of the output of a process is kept if it is produced faster
+/// than the receiving C-Troll is willing to accept it
+enum class OutputPolicy {
+    /// The oldest output is kept and newer output is dropped
+    KeepHead,
+    /// The newest output is kept and older output is dropped
+    KeepTail,
+    /// An evenly spaced sample of the output is kept
+    Sample
+};
+
+/// Returns the name of the output \p policy as it is used in the configuration files
+std::string_view toString(OutputPolicy policy);
+
+/// Returns the output policy with the name \p policy. Throws a std::runtime_error if the
+/// policy is not known
+OutputPolicy outputPolicyFromString(std::string_view policy);
+
+/**
+ * A piece of process output that is passed through the flow control of one or more
+ * connections. The output is shared between all of them, so that it is encoded only once
+ * for all connections with the same socket settings, no matter when it is sent on each.
+ */
+struct SharedOutput {
+    explicit SharedOutput(ProcessOutputMessage msg);
+
+    ProcessOutputMessage message;
+    /// The message as it is written to the sockets. This is created by the first socket
+    /// that the output is sent on, see JsonSocket::write
+    std::shared_ptr<SharedMessage> encoded;
+};
+using SharedOutputPtr = std::shared_ptr<SharedOutput>;
+
+/**
+ * Limits the amount of process output that is sent on a single connection to the number
+ * of bytes that the receiver has granted. While credits are available, output passes
+ * through unchanged. Once they are used up, the output of each process is queued up to a
+ * fixed size and anything beyond that is discarded according to the OutputPolicy of the
+ * process. Discarded output is replaced with a marker that contains the number of bytes
+ * that were lost. New credits release the queued output in a round-robin fashion across
+ * all processes, so that a single noisy process cannot hold back the others.
+ */
+class OutputFlowControl {
+public:
+    /// \param maxQueuedBytes The maximum number of bytes that are queued per process
+    explicit OutputFlowControl(std::size_t maxQueuedBytes);
+
+    /**
+     * Passes the \p message through the flow control, using the \p policy if it has to
+     * be queued.
+     *
+     * \return The output that can be sent out right away
+     */
+    std::vector<SharedOutputPtr> push(SharedOutputPtr output, OutputPolicy policy);
+
+    /**
+     * Adds the number of \p credits that were granted by the receiver.
+     *
+     * \return The queued output that can be sent out now
+     */
+    std::vector<SharedOutputPtr> grant(std::uint64_t credits);
+
+    /**
+     * Pauses or resumes the sending of output regardless of the credits, for example
+     * while the connection itself is not able to keep up. While paused, all output is
+     * queued and granted credits are only collected.
+     *
+     * \return The queued output that can be sent out now
+     */
+    std::vector<SharedOutputPtr> setPaused(bool isPaused);
+
+    /// Returns whether the flow control is currently paused
+    bool isPaused() const;
+
+    /// Returns the number of bytes that can currently be sent without queueing
+    std::int64_t credits() const;
+
+    /// Returns the number of bytes of output that are currently queued
+    std::size_t queuedBytes() const;
+
+    /// Returns the total number of bytes that were discarded so far
+    std::uint64_t totalDropped() const;
+
+private:
+    struct Queue {
+        OutputPolicy policy = OutputPolicy::KeepTail;
+        std::deque<SharedOutputPtr> messages;
+        std::size_t nBytes = 0;
+        /// The number of dropped bytes per ProcessOutputMessage::OutputType
+        std::array<std::uint64_t, 2> nDropped = { 0, 0 };
+        /// Only every n-th message is kept for the OutputPolicy::Sample
+        std::size_t sampleStride = 1;
+        std::size_t sampleCounter = 0;
+    };
+
+    /// Sends as much of the queued output as the credits allow
+    std::vector<SharedOutputPtr> release();
+    void enqueue(Queue& queue, SharedOutputPtr output);
+    void drop(Queue& queue, const ProcessOutputMessage& message);
+    void appendDroppedMarkers(Queue& queue, int processId,
+        std::vector<SharedOutputPtr>& result);
+    void send(SharedOutputPtr output, std::vector<SharedOutputPtr>& result);
+
+    const std::size_t _maxQueuedBytes;
+    /// This value can become negative as a message is sent as long as any credit is left
+    std::int64_t _credits = 0;
+    bool _isPaused = false;
+    std::map<int, Queue> _queues;
+    std::size_t _nQueuedBytes = 0;
+    std::uint64_t _nTotalDropped = 0;
+};
+
+} // namespace common
+
+#endif // __COMMON__OUTPUTFLOWCONTROL_H__
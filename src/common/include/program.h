@@ -36,6 +36,7 @@
 #define __COMMON__PROGRAM_H__
 
 #include "cluster.h"
+#include "outputflowcontrol.h"
 #include "typedid.h"
 #include <nlohmann/json.hpp>
 #include <chrono>
@@ -43,6 +44,8 @@
 #include <string>
 #include <vector>
 
+namespace common { template <typename T> struct JsonFileCache; }
+
 struct Program {
     struct Configuration {
         using ID = TypedId<struct ConfigurationTag>;
@@ -88,6 +91,12 @@ struct Program {
     std::string workingDirectory;
     /// If this is set to `true`, child processes will forward the Std and error streams
     bool shouldForwardMessages = false;
+    /// Determines which part of the forwarded messages is kept if they are produced
+    /// faster than C-Troll can accept them
+    common::OutputPolicy outputPolicy = common::OutputPolicy::KeepTail;
+    /// If this is set to `true`, the forwarded messages are kept on the tray and are only
+    /// sent when C-Troll requests them, for example when the output window is opened
+    bool outputOnDemand = false;
     /// If this is set to `true` the program will automatically restart if it crashes
     bool shouldAutoRestart = false;
     /// A flag showing whether this Program is enabled or disabled
@@ -108,7 +117,7 @@ struct Program {
 };
 
 std::pair<std::vector<Program>, bool> loadProgramsFromDirectory(
-    std::string_view directory);
+    std::string_view directory, common::JsonFileCache<Program>* cache = nullptr);
 
 void from_json(const nlohmann::json& j, Program& p);
 void to_json(nlohmann::json& j, const Program& p);
@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#ifndef __COMMON__RECONNECTSCHEDULER_H__
+#define __COMMON__RECONNECTSCHEDULER_H__
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace common {
+
+/**
+ * Decides when each of a set of connections should be dialed. Every connection is in one
+ * of four states: waiting for its next attempt, dialing, connected, or established once
+ * the peer has completed the handshake. A connection that failed or was lost before it
+ * was established is retried after an exponentially increasing delay. A random
+ * jitter keeps many connections that failed at the same time from being retried at the
+ * same time, too. The number of attempts that are in progress at the same time is
+ * limited, and an attempt that takes too long is given up. The current time is passed
+ * in by the caller so that this class does not depend on any timer.
+ */
+class ReconnectScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        /// The delay before the first retry of a connection that failed or was lost
+        std::chrono::milliseconds initialDelay = std::chrono::milliseconds(500);
+        /// The maximum delay between two attempts of the same connection
+        std::chrono::milliseconds maxDelay = std::chrono::seconds(30);
+        /// The maximum number of connection attempts that are in progress at once
+        std::size_t maxConcurrentDials = 16;
+        /// The time after which a connection attempt is given up and counts as failed
+        std::chrono::milliseconds dialTimeout = std::chrono::seconds(10);
+    };
+
+    /// The connections that should be dialed now and the attempts that timed out
+    struct Actions {
+        std::vector<int> dial;
+        std::vector<int> abort;
+    };
+
+    ReconnectScheduler();
+    explicit ReconnectScheduler(Options options,
+        std::uint64_t seed = std::random_device()());
+
+    /// Adds the connection with the \p id, which is dialed as soon as possible
+    void add(int id, Clock::time_point now);
+
+    /// Removes the connection with the \p id, regardless of its state
+    void remove(int id);
+
+    /**
+     * Marks the connection as connected, which frees up its place for the next attempt.
+     * The delay is not reset until the connection is established, so a peer that accepts
+     * connections only to drop them again is retried with an increasing delay.
+     */
+    void setConnected(int id);
+
+    /// Marks the connection as established after the handshake, which resets its delay
+    void setEstablished(int id);
+
+    /**
+     * Marks the connection attempt as failed or the connection as lost and schedules the
+     * next attempt. Calling this for a connection that is already waiting does nothing.
+     */
+    void setDisconnected(int id, Clock::time_point now);
+
+    /**
+     * Returns the connections whose attempt timed out, which are scheduled again, and
+     * the connections that should be dialed now, as far as the limit of concurrent
+     * attempts allows. The returned connections are considered to be dialing.
+     */
+    Actions update(Clock::time_point now);
+
+    /**
+     * Returns the time at which update has to be called next, or `std::nullopt` if
+     * nothing will happen until one of the other functions is called.
+     */
+    std::optional<Clock::time_point> nextUpdate() const;
+
+    /// Returns whether there is a connection attempt in progress for the \p id
+    bool isDialing(int id) const;
+
+    /// Returns the number of connection attempts that are in progress
+    std::size_t nDialing() const;
+
+private:
+    enum class State { Waiting, Dialing, Connected, Established };
+
+    struct Connection {
+        State state = State::Waiting;
+        /// The time of the next attempt while waiting or the timeout while dialing
+        Clock::time_point time;
+        /// The number of attempts that failed or that were lost before the handshake
+        /// since the last established connection
+        int nFailures = 0;
+    };
+
+    /// Returns the jittered delay before the next attempt after \p nFailures failures
+    std::chrono::milliseconds delay(int nFailures);
+
+    Options _options;
+    std::map<int, Connection> _connections;
+    std::size_t _nDialing = 0;
+    std::mt19937_64 _random;
+};
+
+} // namespace common
+
+#endif // __COMMON__RECONNECTSCHEDULER_H__
@@ -87,11 +87,11 @@ namespace app {
 //   - For bugfixes only
 
 namespace api {
-    constexpr int MajorVersion = 2;
+    constexpr int MajorVersion = 3;
     constexpr int MinorVersion = 0;
     constexpr int PatchVersion = 0;
 
-    constexpr std::string_view Version = "2.1.0";
+    constexpr std::string_view Version = "3.0.0";
 } // namespace api
 
 #endif // __COMMON__VERSION_H__
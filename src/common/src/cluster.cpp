@@ -45,6 +45,7 @@ namespace {
     constexpr std::string_view KeyEnabled = "enabled";
     constexpr std::string_view KeyNodes = "nodes";
     constexpr std::string_view KeyDescription = "description";
+    constexpr std::string_view KeyLaunchConcurrency = "launchConcurrency";
 } // namespace
 
 void from_json(const nlohmann::json& j, Cluster& c) {
@@ -57,6 +58,10 @@ void from_json(const nlohmann::json& j, Cluster& c) {
     }
 
     j.at(KeyNodes).get_to(c.nodes);
+
+    if (auto it = j.find(KeyLaunchConcurrency);  it != j.end()) {
+        it->get_to(c.launchConcurrency);
+    }
 }
 
 void to_json(nlohmann::json& j, const Cluster& c) {
@@ -66,14 +71,19 @@ void to_json(nlohmann::json& j, const Cluster& c) {
         j[KeyDescription] = c.description;
     }
     j[KeyNodes] = c.nodes;
+    if (c.launchConcurrency != Cluster().launchConcurrency) {
+        j[KeyLaunchConcurrency] = c.launchConcurrency;
+    }
 }
 
 std::pair<std::vector<Cluster>, bool> loadClustersFromDirectory(
-                                                               std::string_view directory)
+                                                               std::string_view directory,
+                                                    common::JsonFileCache<Cluster>* cache)
 {
     std::pair<std::vector<Cluster>, bool> res = common::loadJsonFromDirectory<Cluster>(
         directory,
-        validation::loadValidator(":/schema/config/cluster.schema.json")
+        &validation::sharedValidator(":/schema/config/cluster.schema.json"),
+        cache
     );
 
     // Inject the unique identifiers into the nodes
@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "framecipher.h"
+
+#include <QByteArray>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    // Labels that are used to derive independent keys from the same secret
+    constexpr std::string_view EncryptionLabel = "C-Troll frame encryption";
+    constexpr std::string_view AuthenticationLabel = "C-Troll frame authentication";
+
+    // The number of bytes that ChaCha20 produces per block
+    constexpr std::size_t BlockSize = 64;
+
+    QByteArray rawData(std::string_view data) {
+        return QByteArray::fromRawData(data.data(), static_cast<qsizetype>(data.size()));
+    }
+
+    QByteArray deriveKey(std::string_view secret, std::string_view label) {
+        return QMessageAuthenticationCode::hash(
+            rawData(label),
+            rawData(secret),
+            QCryptographicHash::Sha256
+        );
+    }
+
+    std::uint32_t load32(const std::uint8_t* p) {
+        return static_cast<std::uint32_t>(p[0]) |
+            (static_cast<std::uint32_t>(p[1]) << 8) |
+            (static_cast<std::uint32_t>(p[2]) << 16) |
+            (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    void quarterRound(std::array<std::uint32_t, 16>& x, int a, int b, int c, int d) {
+        x[a] += x[b];  x[d] = std::rotl(x[d] ^ x[a], 16);
+        x[c] += x[d];  x[b] = std::rotl(x[b] ^ x[c], 12);
+        x[a] += x[b];  x[d] = std::rotl(x[d] ^ x[a], 8);
+        x[c] += x[d];  x[b] = std::rotl(x[b] ^ x[c], 7);
+    }
+} // namespace
+
+namespace common {
+
+FrameCipher::FrameCipher(std::string_view secret)
+    : _mac(QCryptographicHash::Sha256)
+{
+    const QByteArray encryptionKey = deriveKey(secret, EncryptionLabel);
+    std::copy_n(encryptionKey.constData(), KeySize, _encryptionKey.begin());
+    _mac.setKey(deriveKey(secret, AuthenticationLabel));
+}
+
+void FrameCipher::encrypt(std::string_view plaintext, std::string_view associatedData,
+                          std::string& result)
+{
+    result.resize(NonceSize + plaintext.size() + TagSize);
+
+    std::array<quint32, NonceSize / sizeof(quint32)> random;
+    QRandomGenerator::system()->generate(random.begin(), random.end());
+    std::array<std::uint8_t, NonceSize> nonce;
+    std::memcpy(nonce.data(), random.data(), NonceSize);
+    std::copy(nonce.begin(), nonce.end(), result.begin());
+
+    std::span<char> ciphertext = std::span<char>(
+        result.data() + NonceSize,
+        plaintext.size()
+    );
+    std::copy(plaintext.begin(), plaintext.end(), ciphertext.begin());
+    applyKeystream(_encryptionKey, nonce, 0, ciphertext);
+
+    const std::array<std::uint8_t, TagSize> tag = computeTag(
+        associatedData,
+        std::string_view(result.data(), NonceSize + plaintext.size())
+    );
+    std::copy(tag.begin(), tag.end(), result.begin() + NonceSize + plaintext.size());
+}
+
+void FrameCipher::decrypt(std::string_view frame, std::string_view associatedData,
+                          std::string& result)
+{
+    if (frame.size() < Overhead) {
+        throw std::runtime_error("Encrypted frame is too short");
+    }
+
+    const std::size_t size = frame.size() - Overhead;
+    const std::array<std::uint8_t, TagSize> tag =
+        computeTag(associatedData, frame.substr(0, NonceSize + size));
+
+    // Compare the whole tag regardless of where the first difference is so that the
+    // time it takes does not reveal how much of a forged tag was correct
+    const std::string_view receivedTag = frame.substr(NonceSize + size);
+    std::uint8_t difference = 0;
+    for (std::size_t i = 0; i < TagSize; i++) {
+        difference |= tag[i] ^ static_cast<std::uint8_t>(receivedTag[i]);
+    }
+    if (difference != 0) {
+        throw std::runtime_error("Encrypted frame failed the authentication");
+    }
+
+    std::array<std::uint8_t, NonceSize> nonce;
+    std::copy_n(frame.begin(), NonceSize, nonce.begin());
+
+    result.assign(frame.substr(NonceSize, size));
+    applyKeystream(_encryptionKey, nonce, 0, result);
+}
+
+void FrameCipher::applyKeystream(std::span<const std::uint8_t, KeySize> key,
+                                 std::span<const std::uint8_t, NonceSize> nonce,
+                                 std::uint32_t counter, std::span<char> data)
+{
+    std::array<std::uint32_t, 16> state = {
+        // "expand 32-byte k"
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        load32(&key[0]), load32(&key[4]), load32(&key[8]), load32(&key[12]),
+        load32(&key[16]), load32(&key[20]), load32(&key[24]), load32(&key[28]),
+        counter, load32(&nonce[0]), load32(&nonce[4]), load32(&nonce[8])
+    };
+
+    for (std::size_t offset = 0; offset < data.size(); offset += BlockSize) {
+        std::array<std::uint32_t, 16> x = state;
+        for (int i = 0; i < 10; i++) {
+            // Column rounds
+            quarterRound(x, 0, 4, 8, 12);
+            quarterRound(x, 1, 5, 9, 13);
+            quarterRound(x, 2, 6, 10, 14);
+            quarterRound(x, 3, 7, 11, 15);
+            // Diagonal rounds
+            quarterRound(x, 0, 5, 10, 15);
+            quarterRound(x, 1, 6, 11, 12);
+            quarterRound(x, 2, 7, 8, 13);
+            quarterRound(x, 3, 4, 9, 14);
+        }
+
+        const std::size_t n = std::min(BlockSize, data.size() - offset);
+        for (std::size_t i = 0; i < n; i++) {
+            const std::uint32_t word = x[i / 4] + state[i / 4];
+            const std::uint8_t byte = static_cast<std::uint8_t>(word >> (8 * (i % 4)));
+            data[offset + i] = static_cast<char>(data[offset + i] ^ byte);
+        }
+
+        state[12]++;
+    }
+}
+
+std::array<std::uint8_t, FrameCipher::TagSize> FrameCipher::computeTag(
+                                                        std::string_view associatedData,
+                                                                  std::string_view data)
+{
+    // The length of the associated data is included so that bytes cannot be moved
+    // between the associated data and the nonce without invalidating the tag
+    const char adSize = static_cast<char>(associatedData.size());
+
+    _mac.reset();
+    _mac.addData(rawData(std::string_view(&adSize, 1)));
+    _mac.addData(rawData(associatedData));
+    _mac.addData(rawData(data));
+    const QByteArray mac = _mac.result();
+
+    std::array<std::uint8_t, TagSize> tag;
+    std::copy_n(mac.constData(), TagSize, tag.begin());
+    return tag;
+}
+
+} // namespace common
@@ -0,0 +1,301 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "framedecoder.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+
+namespace {
+    // The initial size of the ring buffer, needs to be a power of two
+    constexpr std::size_t InitialCapacity = 4096;
+
+    constexpr char Separator = '#';
+
+    // The flag characters that are used in the frame header to denote binary encodings
+    constexpr char FlagCbor = 'c';
+    constexpr char FlagMessagePack = 'm';
+
+    // The flag characters that are used in the frame header to denote a compressed or an
+    // encrypted payload
+    constexpr char FlagCompressed = 'z';
+    constexpr char FlagEncrypted = 'e';
+} // namespace
+
+namespace common {
+
+std::string_view toString(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Json:        return "json";
+        case Encoding::Cbor:        return "cbor";
+        case Encoding::MessagePack: return "msgpack";
+    }
+    throw std::logic_error("Missing case label");
+}
+
+std::optional<Encoding> encodingFromString(std::string_view name) {
+    if (name == "json") {
+        return Encoding::Json;
+    }
+    else if (name == "cbor") {
+        return Encoding::Cbor;
+    }
+    else if (name == "msgpack") {
+        return Encoding::MessagePack;
+    }
+    else {
+        return std::nullopt;
+    }
+}
+
+std::size_t encodeFrameHeader(std::span<char, MaxFrameHeaderSize> buffer,
+                              std::size_t payloadSize, Encoding encoding,
+                              bool isCompressed, bool isEncrypted)
+{
+    char* end = buffer.data();
+    end = std::to_chars(end, buffer.data() + buffer.size(), payloadSize).ptr;
+    switch (encoding) {
+        case Encoding::Json:
+            break;
+        case Encoding::Cbor:
+            *end = FlagCbor;
+            end++;
+            break;
+        case Encoding::MessagePack:
+            *end = FlagMessagePack;
+            end++;
+            break;
+    }
+    if (isCompressed) {
+        *end = FlagCompressed;
+        end++;
+    }
+    if (isEncrypted) {
+        *end = FlagEncrypted;
+        end++;
+    }
+    *end = Separator;
+    end++;
+    return static_cast<std::size_t>(end - buffer.data());
+}
+
+FrameDecoder::FrameDecoder(std::size_t maxFrameSize)
+    : _maxFrameSize(maxFrameSize)
+    , _buffer(InitialCapacity)
+{}
+
+void FrameDecoder::append(std::span<const char> data) {
+    while (!data.empty()) {
+        std::span<char> region = writeRegion(data.size());
+        std::copy_n(data.begin(), region.size(), region.begin());
+        commit(region.size());
+        data = data.subspan(region.size());
+    }
+}
+
+std::span<char> FrameDecoder::writeRegion(std::size_t maxSize) {
+    if (_head == _tail) {
+        // If the buffer is empty we can start from the beginning again, which maximizes
+        // the chance that the next frame ends up being contiguous
+        _head = 0;
+        _tail = 0;
+    }
+
+    if (_buffer.size() - size() < maxSize) {
+        grow(maxSize);
+    }
+
+    const std::size_t begin = index(_tail);
+    const std::size_t free = _buffer.size() - size();
+    const std::size_t contiguous = std::min(free, _buffer.size() - begin);
+    return std::span<char>(_buffer.data() + begin, std::min(maxSize, contiguous));
+}
+
+void FrameDecoder::commit(std::size_t size) {
+    assert(this->size() + size <= _buffer.size());
+    _tail += size;
+}
+
+std::optional<Frame> FrameDecoder::nextFrame() {
+    if (!_payloadSize.has_value()) {
+        _payloadSize = parseHeader();
+        if (!_payloadSize.has_value()) {
+            // We haven't received the full header yet
+            return std::nullopt;
+        }
+    }
+
+    const std::size_t payloadSize = *_payloadSize;
+    if (size() < payloadSize) {
+        // The rest of the frame will arrive in a later read
+        return std::nullopt;
+    }
+
+    const std::size_t begin = index(_head);
+    std::string_view frame;
+    if (begin + payloadSize <= _buffer.size()) {
+        // The common case where the payload is stored contiguously in the buffer
+        frame = std::string_view(_buffer.data() + begin, payloadSize);
+    }
+    else {
+        // The payload wraps around the end of the buffer, so we need to stitch it
+        const std::size_t first = _buffer.size() - begin;
+        _scratch.resize(payloadSize);
+        std::copy_n(_buffer.data() + begin, first, _scratch.data());
+        std::copy_n(_buffer.data(), payloadSize - first, _scratch.data() + first);
+        frame = std::string_view(_scratch.data(), payloadSize);
+    }
+
+    _head += payloadSize;
+    _payloadSize = std::nullopt;
+    return Frame{
+        .payload = frame,
+        .encoding = _encoding,
+        .isCompressed = _isCompressed,
+        .isEncrypted = _isEncrypted
+    };
+}
+
+void FrameDecoder::clear() {
+    _head = 0;
+    _tail = 0;
+    _payloadSize = std::nullopt;
+
+    // Release the memory in case a large frame caused the buffer to grow
+    if (_buffer.size() > InitialCapacity) {
+        _buffer = std::vector<char>(InitialCapacity);
+    }
+    _scratch = std::vector<char>();
+}
+
+std::size_t FrameDecoder::size() const {
+    return _tail - _head;
+}
+
+std::optional<std::size_t> FrameDecoder::pendingFrameSize() const {
+    return _payloadSize;
+}
+
+std::size_t FrameDecoder::maxFrameSize() const {
+    return _maxFrameSize;
+}
+
+std::size_t FrameDecoder::index(std::size_t position) const {
+    return position & (_buffer.size() - 1);
+}
+
+void FrameDecoder::grow(std::size_t minimumFree) {
+    const std::size_t used = size();
+    std::size_t capacity = _buffer.size();
+    while (capacity - used < minimumFree) {
+        capacity *= 2;
+    }
+
+    std::vector<char> buffer = std::vector<char>(capacity);
+    const std::size_t begin = index(_head);
+    const std::size_t first = std::min(used, _buffer.size() - begin);
+    std::copy_n(_buffer.data() + begin, first, buffer.data());
+    std::copy_n(_buffer.data(), used - first, buffer.data() + first);
+
+    _buffer = std::move(buffer);
+    _head = 0;
+    _tail = used;
+}
+
+std::optional<std::size_t> FrameDecoder::parseHeader() {
+    const std::size_t available = std::min(size(), MaxFrameHeaderSize);
+
+    std::size_t value = 0;
+    std::size_t nDigits = 0;
+    Encoding encoding = Encoding::Json;
+    bool hasEncodingFlag = false;
+    bool isCompressed = false;
+    bool isEncrypted = false;
+    for (std::size_t i = 0; i < available; i++) {
+        const char c = _buffer[index(_head + i)];
+        if (c == Separator) {
+            if (nDigits == 0) {
+                throw std::runtime_error("Received frame header without a length");
+            }
+
+            // Consume the header so that the head points at the start of the payload
+            _head += i + 1;
+            _encoding = encoding;
+            _isCompressed = isCompressed;
+            _isEncrypted = isEncrypted;
+            return value;
+        }
+
+        const bool hasFlag = hasEncodingFlag || isCompressed || isEncrypted;
+        if (c >= '0' && c <= '9' && !hasFlag) {
+            value = value * 10 + static_cast<std::size_t>(c - '0');
+            nDigits++;
+            if (value > _maxFrameSize) {
+                throw std::runtime_error(std::format(
+                    "Frame exceeds the maximum size of {} bytes", _maxFrameSize
+                ));
+            }
+        }
+        else if (c == FlagCbor && nDigits > 0 && !hasEncodingFlag) {
+            encoding = Encoding::Cbor;
+            hasEncodingFlag = true;
+        }
+        else if (c == FlagMessagePack && nDigits > 0 && !hasEncodingFlag) {
+            encoding = Encoding::MessagePack;
+            hasEncodingFlag = true;
+        }
+        else if (c == FlagCompressed && nDigits > 0 && !isCompressed) {
+            isCompressed = true;
+        }
+        else if (c == FlagEncrypted && nDigits > 0 && !isEncrypted) {
+            isEncrypted = true;
+        }
+        else {
+            throw std::runtime_error(std::format(
+                "Received invalid character (code {}) in frame header",
+                static_cast<int>(c)
+            ));
+        }
+    }
+
+    if (available == MaxFrameHeaderSize) {
+        throw std::runtime_error("Received frame header that is too long");
+    }
+    return std::nullopt;
+}
+
+} // namespace common
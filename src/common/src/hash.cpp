@@ -0,0 +1,161 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "hash.h"
+
+#include <bit>
+
+namespace {
+    constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+    constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+    constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+    // The values are always read in little-endian order so that the result does not
+    // depend on the platform
+    std::uint64_t read(const char* p, int nBytes) {
+        std::uint64_t res = 0;
+        for (int i = 0; i < nBytes; i++) {
+            const std::uint64_t byte = static_cast<unsigned char>(p[i]);
+            res |= byte << (8 * i);
+        }
+        return res;
+    }
+
+    std::uint64_t round(std::uint64_t acc, std::uint64_t input) {
+        acc += input * Prime2;
+        acc = std::rotl(acc, 31);
+        return acc * Prime1;
+    }
+
+    std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t value) {
+        acc ^= round(0, value);
+        return acc * Prime1 + Prime4;
+    }
+
+    void append(std::string& buffer, std::uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+} // namespace
+
+namespace common {
+
+std::uint64_t xxHash64(std::string_view data, std::uint64_t seed) {
+    const char* p = data.data();
+    const char* end = p + data.size();
+
+    std::uint64_t hash = 0;
+    if (data.size() >= 32) {
+        std::uint64_t v1 = seed + Prime1 + Prime2;
+        std::uint64_t v2 = seed + Prime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - Prime1;
+
+        // Process the data in stripes of 32 bytes with four independent accumulators
+        const char* limit = end - 32;
+        do {
+            v1 = round(v1, read(p, 8));
+            v2 = round(v2, read(p + 8, 8));
+            v3 = round(v3, read(p + 16, 8));
+            v4 = round(v4, read(p + 24, 8));
+            p += 32;
+        } while (p <= limit);
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) +
+               std::rotl(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<std::uint64_t>(data.size());
+
+    // Consume the remaining bytes that did not fill a complete stripe
+    while (p + 8 <= end) {
+        hash ^= round(0, read(p, 8));
+        hash = std::rotl(hash, 27) * Prime1 + Prime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        hash ^= read(p, 4) * Prime1;
+        hash = std::rotl(hash, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= static_cast<unsigned char>(*p) * Prime5;
+        hash = std::rotl(hash, 11) * Prime1;
+        p++;
+    }
+
+    // Final avalanche so that every input bit affects every output bit
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+HashBuilder& HashBuilder::add(std::string_view value) {
+    append(_buffer, value.size());
+    _buffer.append(value);
+    return *this;
+}
+
+HashBuilder& HashBuilder::add(std::int64_t value) {
+    append(_buffer, static_cast<std::uint64_t>(value));
+    return *this;
+}
+
+HashBuilder& HashBuilder::add(std::uint64_t value) {
+    append(_buffer, value);
+    return *this;
+}
+
+HashBuilder& HashBuilder::add(int value) {
+    return add(static_cast<std::int64_t>(value));
+}
+
+std::uint64_t HashBuilder::value() const {
+    return xxHash64(_buffer);
+}
+
+} // namespace common
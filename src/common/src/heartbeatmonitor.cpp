@@ -0,0 +1,158 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "heartbeatmonitor.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace common {
+
+HeartbeatMonitor::Connection::Connection(std::size_t windowSize)
+    : histogram(windowSize)
+{}
+
+HeartbeatMonitor::HeartbeatMonitor()
+    : HeartbeatMonitor(Options())
+{}
+
+HeartbeatMonitor::HeartbeatMonitor(Options options)
+    : _options(options)
+{
+    assert(_options.interval.count() > 0);
+    assert(_options.maxMissedBeats > 0);
+    assert(_options.windowSize > 0);
+}
+
+void HeartbeatMonitor::add(int id, Clock::time_point now) {
+    assert(!_connections.contains(id));
+    const auto it = _connections.emplace(id, Connection(_options.windowSize)).first;
+    it->second.nextPing = now;
+}
+
+void HeartbeatMonitor::remove(int id) {
+    _connections.erase(id);
+}
+
+bool HeartbeatMonitor::receivePong(int id, std::uint64_t sequence, Clock::time_point now)
+{
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return false;
+    }
+
+    Connection& c = it->second;
+    c.missedBeats = 0;
+
+    const auto pt = std::find_if(
+        c.pending.begin(), c.pending.end(),
+        [sequence](const std::pair<std::uint64_t, Clock::time_point>& p) {
+            return p.first == sequence;
+        }
+    );
+    if (pt == c.pending.end()) {
+        return false;
+    }
+
+    c.last = std::chrono::duration_cast<std::chrono::microseconds>(now - pt->second);
+    c.histogram.add(c.last);
+    // The answers arrive in order, so the earlier heartbeats won't be answered anymore
+    c.pending.erase(c.pending.begin(), pt + 1);
+    return true;
+}
+
+HeartbeatMonitor::Actions HeartbeatMonitor::update(Clock::time_point now) {
+    Actions actions;
+
+    for (auto it = _connections.begin(); it != _connections.end();) {
+        Connection& c = it->second;
+        if (c.nextPing > now) {
+            it++;
+            continue;
+        }
+
+        if (!c.pending.empty()) {
+            // The previous heartbeat has not been answered within the interval
+            c.missedBeats++;
+            if (c.missedBeats >= _options.maxMissedBeats) {
+                actions.dead.push_back(it->first);
+                it = _connections.erase(it);
+                continue;
+            }
+        }
+
+        const std::uint64_t sequence = _nextSequence++;
+        c.pending.emplace_back(sequence, now);
+        if (c.pending.size() > static_cast<std::size_t>(_options.maxMissedBeats)) {
+            c.pending.pop_front();
+        }
+        c.nextPing = now + _options.interval;
+        actions.ping.push_back({ .id = it->first, .sequence = sequence });
+        it++;
+    }
+
+    return actions;
+}
+
+std::optional<HeartbeatMonitor::Clock::time_point> HeartbeatMonitor::nextUpdate() const {
+    std::optional<Clock::time_point> res;
+    for (const auto& [id, c] : _connections) {
+        if (!res.has_value() || c.nextPing < *res) {
+            res = c.nextPing;
+        }
+    }
+    return res;
+}
+
+std::optional<HeartbeatMonitor::Statistics> HeartbeatMonitor::statistics(int id) const {
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return std::nullopt;
+    }
+
+    const Connection& c = it->second;
+    return Statistics {
+        .last = c.last,
+        .p50 = c.histogram.percentile(0.5),
+        .p99 = c.histogram.percentile(0.99),
+        .nSamples = c.histogram.count(),
+        .missedBeats = c.missedBeats
+    };
+}
+
+const HeartbeatMonitor::Options& HeartbeatMonitor::options() const {
+    return _options;
+}
+
+} // namespace common
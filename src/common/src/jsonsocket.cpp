@@ -35,12 +35,56 @@
 #include "jsonsocket.h"
 
 #include "logging.h"
-#include <QCryptographicHash>
+#include <QMetaObject>
 #include <QNetworkProxy>
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 
 namespace {
-    void Debug(std::string msg) {
-        ::Debug("JsonSocket", std::move(msg));
+    // The maximum number of bytes that are read from the socket before decoding frames
+    constexpr qint64 ReadChunkSize = 64 * 1024;
+
+    // qCompress prefixes the zlib stream with the uncompressed size as a 32-bit integer
+    constexpr std::size_t CompressedSizePrefix = 4;
+
+    constexpr std::string_view KeyNoDelay = "noDelay";
+    constexpr std::string_view KeyKeepAlive = "keepAlive";
+    constexpr std::string_view KeyHighWatermark = "highWatermark";
+    constexpr std::string_view KeyLowWatermark = "lowWatermark";
+    constexpr std::string_view KeyMaxQueueSize = "maxQueueSize";
+    constexpr std::string_view KeyCompressionThreshold = "compressionThreshold";
+    constexpr std::string_view KeyCompressionLevel = "compressionLevel";
+
+    // The flags of a frame header that are authenticated together with the encrypted
+    // payload so that they cannot be altered on the way. The direction and the sequence
+    // number of the frame are authenticated, too, so that a frame that was recorded can
+    // neither be replayed later nor reflected back to the side that sent it
+    std::array<char, 11> associatedData(common::Encoding encoding, bool isCompressed,
+                                        bool isFromClient, std::uint64_t sequence)
+    {
+        std::array<char, 11> res = {
+            static_cast<char>(encoding),
+            static_cast<char>(isCompressed),
+            static_cast<char>(isFromClient)
+        };
+        for (std::size_t i = 0; i < sizeof(sequence); i++) {
+            res[3 + i] = static_cast<char>(sequence >> (8 * i));
+        }
+        return res;
+    }
+
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Network,
+            "JsonSocket",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 } // namespace
 
@@ -51,107 +95,566 @@ JsonSocket::JsonSocket(std::unique_ptr<QTcpSocket> socket, std::string secret)
     , _socket(std::move(socket))
 {
     if (!secret.empty()) {
-        QByteArray secretHash = QCryptographicHash::hash(
-            QString::fromStdString(secret).toUtf8(),
-            QCryptographicHash::Sha1
-        );
-
-        quint64 key = secretHash.toULongLong();
-        _crypto = SimpleCrypt(key);
+        _cipher.emplace(secret);
     }
 
     connect(_socket.get(), &QTcpSocket::readyRead, this, &JsonSocket::readToBuffer);
-    connect(_socket.get(), &QTcpSocket::disconnected, this, &JsonSocket::disconnected);
+    connect(
+        _socket.get(), &QTcpSocket::disconnected,
+        this, [this]() {
+            // Anything that is still queued was meant for the previous connection
+            _queue.clear();
+            _queueOffset = 0;
+            _queueSize = 0;
+            _decoder.clear();
+            _sendSequence = 0;
+            _receiveSequence = 0;
+            _encoding = Encoding::Json;
+            if (_isCompressionEnabled || _compressionStatistics.nDecompressedFrames > 0) {
+                const CompressionStatistics& stats = _compressionStatistics;
+                Debug(
+                    "Compression to {}: {} frames at ratio {:.3f} in {} ms; "
+                    "decompressed {} frames in {} ms",
+                    peerAddress(), stats.nCompressedFrames, stats.ratio(),
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        stats.compressionTime
+                    ).count(),
+                    stats.nDecompressedFrames,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        stats.decompressionTime
+                    ).count()
+                );
+            }
+            _isCompressionEnabled = false;
+            _compressionStatistics = CompressionStatistics();
+            updateBackpressure();
+            emit disconnected();
+        }
+    );
+    connect(
+        _socket.get(), &QTcpSocket::connected,
+        this, &JsonSocket::applySocketOptions
+    );
+    connect(
+        _socket.get(), &QTcpSocket::bytesWritten,
+        this, [this]() {
+            // Hand over more of our queue now that the socket has made some progress
+            if (!_queue.empty()) {
+                flushQueue();
+            }
+            else {
+                updateBackpressure();
+            }
+        }
+    );
     _socket->setProxy(QNetworkProxy::NoProxy);
+
+    if (_socket->state() == QAbstractSocket::SocketState::ConnectedState) {
+        // Sockets that were accepted by a server are already connected
+        applySocketOptions();
+    }
+}
+
+JsonSocket::~JsonSocket() {
+    // Try to get the remaining messages out before the socket is destroyed
+    if (!_queue.empty() &&
+        _socket->state() == QAbstractSocket::SocketState::ConnectedState)
+    {
+        for (const EncodedFrame& frame : _queue) {
+            _socket->write(
+                frame->data() + _queueOffset,
+                static_cast<qint64>(frame->size() - _queueOffset)
+            );
+            _queueOffset = 0;
+        }
+        _socket->flush();
+    }
 }
 
 void JsonSocket::connectToHost(const std::string& host, int port) {
-    Debug(std::format("Connecting to {}:{}", host, port));
+    Debug("Connecting to {}:{}", host, port);
+    _isClient = true;
     _socket->connectToHost(QString::fromStdString(host), static_cast<quint16>(port));
 }
 
+void JsonSocket::connectToHost(const QHostAddress& address, int port) {
+    Debug("Connecting to {}:{}", address.toString().toStdString(), port);
+    _isClient = true;
+    _socket->connectToHost(address, static_cast<quint16>(port));
+}
+
+void JsonSocket::abort() {
+    _socket->abort();
+}
+
 QTcpSocket::SocketState JsonSocket::state() const {
     return _socket->state();
 }
 
 void JsonSocket::write(const nlohmann::json& jsonDocument) {
-    std::string jsonText = jsonDocument.dump();
-    std::string length = std::to_string(jsonText.size());
-    std::string msg = std::format("{}#{}", std::move(length), std::move(jsonText));
-
-    bool success;
-    if (_crypto.has_value()) {
-        QByteArray data = _crypto->encryptToByteArray(QString::fromStdString(msg));
-        qint64 res = _socket->write(data);
-        success = (data.size() == res);
+    if (_socket->state() == QAbstractSocket::SocketState::UnconnectedState) {
+        ::Log("JsonSocket", "Error writing message: Socket is not connected");
+        return;
     }
-    else {
-        const size_t messageSize = msg.size();
-        qint64 res = _socket->write(msg.c_str());
-        success = (static_cast<qint64>(messageSize) == res);
+
+    EncodeCache cache;
+    enqueue(encode(jsonDocument, cache));
+}
+
+void JsonSocket::broadcast(std::span<JsonSocket* const> sockets,
+                           const nlohmann::json& jsonDocument)
+{
+    EncodeCache cache;
+    for (JsonSocket* socket : sockets) {
+        assert(socket);
+        if (socket->state() == QAbstractSocket::SocketState::UnconnectedState) {
+            ::Log("JsonSocket", "Error writing message: Socket is not connected");
+            continue;
+        }
+        socket->enqueue(socket->encode(jsonDocument, cache));
     }
-    if (!success) {
-        ::Log("JsonSocket", std::format("Error writing message: {})", msg));
+}
+
+void JsonSocket::write(SharedMessage& message) {
+    if (_socket->state() == QAbstractSocket::SocketState::UnconnectedState) {
+        ::Log("JsonSocket", "Error writing message: Socket is not connected");
+        return;
     }
-    _socket->flush();
+
+    enqueue(encode(message._json, message._cache));
 }
 
-void JsonSocket::readToBuffer() {
-    try {
-        QByteArray incomingData = _socket->readAll();
+JsonSocket::FrameSettings JsonSocket::frameSettings() const {
+    // Compression only applies if it is enabled, so its options do not matter otherwise
+    return {
+        .encoding = _encoding,
+        .isCompressionEnabled = _isCompressionEnabled,
+        .compressionThreshold =
+            _isCompressionEnabled ? _options.compressionThreshold : 0,
+        .compressionLevel = _isCompressionEnabled ? _options.compressionLevel : 0
+    };
+}
+
+JsonSocket::EncodedFrame JsonSocket::encode(const nlohmann::json& jsonDocument,
+                                            EncodeCache& cache)
+{
+    // Encrypted frames carry the sequence number of their connection, so only the
+    // unencrypted frames can be shared between sockets
+    FrameSettings settings = frameSettings();
+    if (!_cipher.has_value()) {
+        auto frameIt = std::find_if(
+            cache.frames.begin(), cache.frames.end(),
+            [&settings](const EncodeCache::Frame& f) { return f.settings == settings; }
+        );
+        if (frameIt != cache.frames.end()) {
+            return frameIt->frame;
+        }
+    }
 
-        if (_crypto.has_value()) {
-            QByteArray payload = _crypto->decryptToByteArray(incomingData);
-            incomingData = payload;
+    std::optional<std::string>& serialized =
+        cache.serialized[static_cast<std::size_t>(_encoding)];
+    if (!serialized.has_value()) {
+        switch (_encoding) {
+            case Encoding::Json:
+                serialized = jsonDocument.dump();
+                break;
+            case Encoding::Cbor:
+            {
+                const std::vector<std::uint8_t> data =
+                    nlohmann::json::to_cbor(jsonDocument);
+                serialized = std::string(data.begin(), data.end());
+                break;
+            }
+            case Encoding::MessagePack:
+            {
+                const std::vector<std::uint8_t> data =
+                    nlohmann::json::to_msgpack(jsonDocument);
+                serialized = std::string(data.begin(), data.end());
+                break;
+            }
+        }
+    }
+
+    std::string_view payload = *serialized;
+    bool isCompressed = false;
+    if (_isCompressionEnabled && serialized->size() >= _options.compressionThreshold) {
+        auto compressedIt = std::find_if(
+            cache.compressed.begin(), cache.compressed.end(),
+            [this](const EncodeCache::Compressed& c) {
+                return c.encoding == _encoding &&
+                    c.threshold == _options.compressionThreshold &&
+                    c.level == _options.compressionLevel;
+            }
+        );
+        if (compressedIt == cache.compressed.end()) {
+            const auto begin = std::chrono::steady_clock::now();
+            QByteArray compressed = qCompress(
+                reinterpret_cast<const uchar*>(serialized->data()),
+                static_cast<qsizetype>(serialized->size()),
+                _options.compressionLevel
+            );
+            const auto end = std::chrono::steady_clock::now();
+            _compressionStatistics.compressionTime += end - begin;
+
+            // Repetitive log output compresses very well, but already compressed data
+            // can grow slightly, in which case we are better off sending the original
+            const std::size_t size = static_cast<std::size_t>(compressed.size());
+            if (size == 0 || size >= serialized->size()) {
+                compressed.clear();
+            }
+
+            EncodeCache::Compressed c = {
+                .encoding = _encoding,
+                .threshold = _options.compressionThreshold,
+                .level = _options.compressionLevel,
+                .data = std::move(compressed)
+            };
+            cache.compressed.push_back(std::move(c));
+            compressedIt = cache.compressed.end() - 1;
         }
 
-        _buffer.resize(static_cast<size_t>(incomingData.size()));
-        std::copy(incomingData.begin(), incomingData.end(), _buffer.begin());
+        if (!compressedIt->data.isEmpty()) {
+            const std::size_t size = static_cast<std::size_t>(compressedIt->data.size());
+            payload = std::string_view(compressedIt->data.constData(), size);
+            isCompressed = true;
+            _compressionStatistics.nCompressedFrames++;
+            _compressionStatistics.bytesBeforeCompression += serialized->size();
+            _compressionStatistics.bytesAfterCompression += size;
+        }
+        else {
+            _compressionStatistics.nIncompressibleFrames++;
+        }
+    }
 
-        parseBuffer();
+    const bool isEncrypted = _cipher.has_value();
+    if (isEncrypted) {
+        const std::array<char, 11> ad =
+            associatedData(_encoding, isCompressed, _isClient, _sendSequence);
+        _cipher->encrypt(payload, std::string_view(ad.data(), ad.size()), _encrypted);
+        _sendSequence++;
+        payload = _encrypted;
     }
-    catch (const std::exception&) {
-        ::Log("JsonSocket::readToBuffer", "Caught exception when trying to read buffer");
-        ::Log("JsonSocket::readToBuffer (Buffer Size", std::to_string(_buffer.size()));
+
+    std::array<char, MaxFrameHeaderSize> header;
+    const std::size_t headerSize = encodeFrameHeader(
+        header, payload.size(), _encoding, isCompressed, isEncrypted
+    );
+
+    std::string frame;
+    frame.reserve(headerSize + payload.size());
+    frame.append(header.data(), headerSize);
+    frame.append(payload);
+    EncodedFrame res = std::make_shared<const std::string>(std::move(frame));
+    if (!isEncrypted) {
+        cache.frames.push_back({ .settings = std::move(settings), .frame = res });
+    }
+    return res;
+}
+
+void JsonSocket::enqueue(EncodedFrame frame) {
+    _queueSize += frame->size();
+    _queue.push_back(std::move(frame));
+
+    if (_queueSize > _options.maxQueueSize) {
         ::Log(
-            "JsonSocket::readToBuffer (Buffer Contents)",
-            std::string(_buffer.begin(), _buffer.end())
+            "JsonSocket",
+            std::format(
+                "Dropping connection to {} as {} bytes are waiting to be sent",
+                peerAddress(), _queueSize
+            )
+        );
+        _socket->abort();
+        return;
+    }
+
+    scheduleFlush();
+}
+
+void JsonSocket::setOptions(Options options) {
+    assert(options.lowWatermark <= options.highWatermark);
+    assert(options.highWatermark <= options.maxQueueSize);
+    _options = std::move(options);
+
+    if (_socket->state() == QAbstractSocket::SocketState::ConnectedState) {
+        applySocketOptions();
+    }
+}
+
+std::size_t JsonSocket::bytesPending() const {
+    const std::size_t inSocket = static_cast<std::size_t>(_socket->bytesToWrite());
+    return _queueSize + inSocket;
+}
+
+bool JsonSocket::hasBackpressure() const {
+    return _hasBackpressure;
+}
+
+void JsonSocket::setEncoding(Encoding encoding) {
+    if (encoding != _encoding) {
+        Debug(
+            "Switching connection to {} to {}", peerAddress(), toString(encoding)
         );
-        ::Log("JsonSocket::readToBuffer (payload size)", std::to_string(_payloadSize));
+    }
+    _encoding = encoding;
+}
+
+Encoding JsonSocket::encoding() const {
+    return _encoding;
+}
 
-        _payloadSize = -1;
-        _buffer.clear();
+void JsonSocket::setCompressionEnabled(bool enabled) {
+    if (enabled != _isCompressionEnabled) {
+        Debug(
+            "{} compression for connection to {}",
+            enabled ? "Enabling" : "Disabling", peerAddress()
+        );
     }
+    _isCompressionEnabled = enabled;
 }
 
-void JsonSocket::parseBuffer() {
-    // If it is the first package to arrive, we extract the expected length of the message
-    if (_payloadSize == -1) {
-        const auto it = std::find(_buffer.begin(), _buffer.end(), '#');
-        if (it != _buffer.end()) {
-            std::string sizeString = std::string(_buffer.begin(), it);
-            _payloadSize = std::stoi(sizeString);
-            _buffer.erase(_buffer.begin(), it + 1);
+bool JsonSocket::isCompressionEnabled() const {
+    return _isCompressionEnabled;
+}
+
+const JsonSocket::CompressionStatistics& JsonSocket::compressionStatistics() const {
+    return _compressionStatistics;
+}
+
+void JsonSocket::setPayloadHandler(PayloadHandler handler) {
+    _payloadHandler = std::move(handler);
+}
+
+double JsonSocket::CompressionStatistics::ratio() const {
+    if (bytesBeforeCompression == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(bytesAfterCompression) /
+        static_cast<double>(bytesBeforeCompression);
+}
+
+void JsonSocket::applySocketOptions() {
+    const int noDelay = _options.noDelay ? 1 : 0;
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, noDelay);
+    const int keepAlive = _options.keepAlive ? 1 : 0;
+    _socket->setSocketOption(QAbstractSocket::KeepAliveOption, keepAlive);
+}
+
+void JsonSocket::scheduleFlush() {
+    if (_isFlushScheduled) {
+        return;
+    }
+
+    // Collect all messages that are written until we get back to the event loop
+    _isFlushScheduled = true;
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            _isFlushScheduled = false;
+            flushQueue();
+        },
+        Qt::QueuedConnection
+    );
+}
+
+void JsonSocket::flushQueue() {
+    // We only hand over as much data to the QTcpSocket as fits below the high watermark
+    // so that a slow peer cannot grow its internal buffer without bound
+    const std::size_t inSocket = static_cast<std::size_t>(_socket->bytesToWrite());
+    std::size_t room =
+        inSocket < _options.highWatermark ? _options.highWatermark - inSocket : 0;
+
+    while (room > 0 && !_queue.empty()) {
+        const std::string& frame = *_queue.front();
+        const std::size_t size = std::min(room, frame.size() - _queueOffset);
+        const qint64 res = _socket->write(
+            frame.data() + _queueOffset,
+            static_cast<qint64>(size)
+        );
+        if (res < 0) {
+            ::Log(
+                "JsonSocket",
+                std::format(
+                    "Error writing messages: {}", _socket->errorString().toStdString()
+                )
+            );
+            break;
+        }
+
+        const std::size_t nWritten = static_cast<std::size_t>(res);
+        _queueOffset += nWritten;
+        _queueSize -= nWritten;
+        room -= nWritten;
+        if (_queueOffset < frame.size()) {
+            // The socket did not take the whole frame, so we try again once it has made
+            // some progress
+            break;
         }
+        _queue.pop_front();
+        _queueOffset = 0;
     }
 
-    if (_payloadSize > 0 && (_payloadSize <= static_cast<int>(_buffer.size()))) {
-        std::vector<char> data = std::vector<char>(
-            _buffer.begin(),
-            _buffer.begin() + _payloadSize
+    updateBackpressure();
+}
+
+void JsonSocket::updateBackpressure() {
+    const std::size_t pending = bytesPending();
+    if (!_hasBackpressure && pending >= _options.highWatermark) {
+        _hasBackpressure = true;
+        ::Log(
+            "JsonSocket",
+            std::format(
+                "Peer {} is falling behind ({} bytes pending)", peerAddress(), pending
+            )
         );
-        std::string json = std::string(data.data(), static_cast<size_t>(_payloadSize));
-        _buffer.erase(_buffer.begin(), _buffer.begin() + _payloadSize);
-        _payloadSize = -1;
+        emit backpressureChanged(true);
+    }
+    else if (_hasBackpressure && pending <= _options.lowWatermark) {
+        _hasBackpressure = false;
+        Debug("Peer {} has caught up", peerAddress());
+        emit backpressureChanged(false);
+    }
+}
 
-        nlohmann::json message = nlohmann::json::parse(json);
-        emit messageReceived(message);
+void JsonSocket::readToBuffer() {
+    try {
+        // We read the data directly into the decoder and extract the frames after every
+        // chunk so that the buffer does not have to grow beyond the largest frame even if
+        // a lot of data is waiting on the socket
+        while (_socket->bytesAvailable() > 0) {
+            const qint64 available = std::min(_socket->bytesAvailable(), ReadChunkSize);
+            std::span<char> region = _decoder.writeRegion(
+                static_cast<std::size_t>(available)
+            );
+            const qint64 nRead = _socket->read(
+                region.data(),
+                static_cast<qint64>(region.size())
+            );
+            if (nRead <= 0) {
+                break;
+            }
+            _decoder.commit(static_cast<std::size_t>(nRead));
 
-        if (!_buffer.empty()) {
-            // This can only happen if we get one TCP package with multiple messages in it
             parseBuffer();
         }
     }
+    catch (const std::exception& e) {
+        ::Log(
+            "JsonSocket::readToBuffer",
+            std::format("Error decoding frame: {}", e.what())
+        );
+        ::Log(
+            "JsonSocket::readToBuffer (Buffer Size)",
+            std::to_string(_decoder.size())
+        );
+        ::Log(
+            "JsonSocket::readToBuffer (payload size)",
+            std::to_string(_decoder.pendingFrameSize().value_or(0))
+        );
+
+        // There is no way to find the beginning of the next frame after the stream got
+        // out of sync, so we drop the connection and let the owner reconnect
+        _decoder.clear();
+        _socket->abort();
+    }
+}
+
+void JsonSocket::parseBuffer() {
+    // This can return multiple messages if we get one TCP package with multiple messages
+    while (std::optional<Frame> frame = _decoder.nextFrame()) {
+        nlohmann::json message;
+        try {
+            std::string_view payload = unpackFrame(*frame);
+            if (_payloadHandler && _payloadHandler(payload, frame->encoding)) {
+                continue;
+            }
+
+            switch (frame->encoding) {
+                case Encoding::Json:
+                    message = nlohmann::json::parse(payload.begin(), payload.end());
+                    break;
+                case Encoding::Cbor:
+                    message = nlohmann::json::from_cbor(payload.begin(), payload.end());
+                    break;
+                case Encoding::MessagePack:
+                    message =
+                        nlohmann::json::from_msgpack(payload.begin(), payload.end());
+                    break;
+            }
+        }
+        catch (const std::exception& e) {
+            // The framing is still intact, so we can just skip this message
+            ::Log("JsonSocket", std::format("Dropping malformed message: {}", e.what()));
+            continue;
+        }
+
+        emit messageReceived(std::move(message));
+    }
+}
+
+std::string_view JsonSocket::unpackFrame(const Frame& frame) {
+    std::string_view payload = frame.payload;
+    if (_cipher.has_value()) {
+        if (!frame.isEncrypted) {
+            throw std::runtime_error(
+                "Received unencrypted frame on a secured connection"
+            );
+        }
+
+        // The frames of the peer were sent in the opposite direction to ours
+        const std::array<char, 11> ad = associatedData(
+            frame.encoding, frame.isCompressed, !_isClient, _receiveSequence
+        );
+        _cipher->decrypt(payload, std::string_view(ad.data(), ad.size()), _decrypted);
+        _receiveSequence++;
+        payload = _decrypted;
+    }
+    else if (frame.isEncrypted) {
+        throw std::runtime_error("Received encrypted frame, but no secret is configured");
+    }
+
+    if (frame.isCompressed) {
+        payload = decompress(payload);
+    }
+    return payload;
+}
+
+std::string_view JsonSocket::decompress(std::string_view payload) {
+    if (payload.size() < CompressedSizePrefix) {
+        throw std::runtime_error("Compressed frame is too short");
+    }
+
+    // Check the announced size before qUncompress allocates memory for it so that a
+    // corrupted frame cannot make us allocate an arbitrary amount of memory
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < CompressedSizePrefix; i++) {
+        size = (size << 8) | static_cast<unsigned char>(payload[i]);
+    }
+    if (size > _decoder.maxFrameSize()) {
+        throw std::runtime_error(std::format(
+            "Decompressed frame would exceed the maximum size ({} bytes)", size
+        ));
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    _decompressed = qUncompress(
+        reinterpret_cast<const uchar*>(payload.data()),
+        static_cast<qsizetype>(payload.size())
+    );
+    const auto end = std::chrono::steady_clock::now();
+    _compressionStatistics.decompressionTime += end - begin;
+
+    if (_decompressed.isEmpty() && size > 0) {
+        throw std::runtime_error("Failed to decompress frame");
+    }
+
+    _compressionStatistics.nDecompressedFrames++;
+    _compressionStatistics.bytesBeforeDecompression += payload.size();
+    _compressionStatistics.bytesAfterDecompression +=
+        static_cast<std::size_t>(_decompressed.size());
+    return std::string_view(
+        _decompressed.constData(),
+        static_cast<std::size_t>(_decompressed.size())
+    );
 }
 
 std::string JsonSocket::localAddress() const {
@@ -162,4 +665,56 @@ std::string JsonSocket::peerAddress() const {
     return _socket->peerAddress().toString().toLocal8Bit().constData();
 }
 
+SharedMessage::SharedMessage(nlohmann::json json)
+    : _json(std::move(json))
+{}
+
+void to_json(nlohmann::json& j, const JsonSocket::Options& o) {
+    j[KeyNoDelay] = o.noDelay;
+    j[KeyKeepAlive] = o.keepAlive;
+    j[KeyHighWatermark] = o.highWatermark;
+    j[KeyLowWatermark] = o.lowWatermark;
+    j[KeyMaxQueueSize] = o.maxQueueSize;
+    j[KeyCompressionThreshold] = o.compressionThreshold;
+    j[KeyCompressionLevel] = o.compressionLevel;
+}
+
+void from_json(const nlohmann::json& j, JsonSocket::Options& o) {
+    if (auto it = j.find(KeyNoDelay);  it != j.end()) {
+        it->get_to(o.noDelay);
+    }
+    if (auto it = j.find(KeyKeepAlive);  it != j.end()) {
+        it->get_to(o.keepAlive);
+    }
+    if (auto it = j.find(KeyHighWatermark);  it != j.end()) {
+        it->get_to(o.highWatermark);
+    }
+    if (auto it = j.find(KeyLowWatermark);  it != j.end()) {
+        it->get_to(o.lowWatermark);
+    }
+    if (auto it = j.find(KeyMaxQueueSize);  it != j.end()) {
+        it->get_to(o.maxQueueSize);
+    }
+    if (auto it = j.find(KeyCompressionThreshold);  it != j.end()) {
+        it->get_to(o.compressionThreshold);
+    }
+    if (auto it = j.find(KeyCompressionLevel);  it != j.end()) {
+        it->get_to(o.compressionLevel);
+    }
+
+    if (o.lowWatermark > o.highWatermark) {
+        throw std::runtime_error(
+            "The low watermark must not be larger than the high watermark"
+        );
+    }
+    if (o.highWatermark > o.maxQueueSize) {
+        throw std::runtime_error(
+            "The high watermark must not be larger than the maximum queue size"
+        );
+    }
+    if (o.compressionLevel < -1 || o.compressionLevel > 9) {
+        throw std::runtime_error("The compression level must be between -1 and 9");
+    }
+}
+
 } // namespace common
@@ -36,6 +36,9 @@
 
 #include <nlohmann/json-schema.hpp>
 #include <QFile>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace validation {
 
@@ -65,4 +68,17 @@ nlohmann::json_schema::json_validator loadValidator(std::string path) {
     return nlohmann::json_schema::json_validator(schema);
 }
 
+const nlohmann::json_schema::json_validator& sharedValidator(const std::string& path) {
+    using Validator = nlohmann::json_schema::json_validator;
+    static std::mutex Mutex;
+    static std::map<std::string, std::unique_ptr<Validator>> Validators;
+
+    std::unique_lock lock(Mutex);
+    std::unique_ptr<Validator>& validator = Validators[path];
+    if (!validator) {
+        validator = std::make_unique<Validator>(loadValidator(path));
+    }
+    return *validator;
+}
+
 } // namespace validation
@@ -0,0 +1,125 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "latencyhistogram.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace common {
+
+LatencyHistogram::LatencyHistogram(std::size_t windowSize)
+    : _windowSize(windowSize)
+{
+    assert(_windowSize > 0);
+    _window.reserve(_windowSize);
+}
+
+void LatencyHistogram::add(std::chrono::microseconds value) {
+    const std::uint64_t v = static_cast<std::uint64_t>(std::max<std::int64_t>(
+        value.count(),
+        0
+    ));
+    const std::uint8_t b = static_cast<std::uint8_t>(bucket(v));
+
+    if (_window.size() < _windowSize) {
+        _window.push_back(b);
+    }
+    else {
+        _counts[_window[_next]]--;
+        _window[_next] = b;
+        _next = (_next + 1) % _windowSize;
+    }
+    _counts[b]++;
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double fraction) const {
+    if (_window.empty()) {
+        return std::chrono::microseconds(0);
+    }
+
+    // The rank of the value in the sorted window, starting at 1
+    const double f = std::clamp(fraction, 0.0, 1.0);
+    const std::size_t rank = std::max<std::size_t>(
+        static_cast<std::size_t>(std::ceil(f * static_cast<double>(_window.size()))),
+        1
+    );
+
+    std::size_t n = 0;
+    for (int i = 0; i < NBuckets; i++) {
+        n += _counts[i];
+        if (n >= rank) {
+            return std::chrono::microseconds(upperBound(i));
+        }
+    }
+    throw std::logic_error("Inconsistent histogram");
+}
+
+std::size_t LatencyHistogram::count() const {
+    return _window.size();
+}
+
+void LatencyHistogram::clear() {
+    _counts.fill(0);
+    _window.clear();
+    _next = 0;
+}
+
+int LatencyHistogram::bucket(std::uint64_t value) {
+    value = std::min<std::uint64_t>(value, (std::uint64_t(1) << MaxExponent) - 1);
+    if (value < SubBuckets) {
+        // The smallest values are stored exactly
+        return static_cast<int>(value);
+    }
+
+    // The highest bit selects the power of two, the next three bits the bucket within it
+    const int exponent = std::bit_width(value) - 1;
+    const int sub = static_cast<int>(value >> (exponent - 3)) - SubBuckets;
+    return SubBuckets * (exponent - 2) + sub;
+}
+
+std::uint64_t LatencyHistogram::upperBound(int bucket) {
+    if (bucket < SubBuckets) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+
+    const int exponent = bucket / SubBuckets + 2;
+    const std::uint64_t sub = static_cast<std::uint64_t>(bucket % SubBuckets);
+    return ((SubBuckets + sub + 1) << (exponent - 3)) - 1;
+}
+
+} // namespace common
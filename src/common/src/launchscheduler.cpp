@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "launchscheduler.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace common {
+
+LaunchScheduler::LaunchScheduler()
+    : LaunchScheduler(Options())
+{}
+
+LaunchScheduler::LaunchScheduler(Options options)
+    : _options(options)
+{
+    assert(_options.launchTimeout.count() > 0);
+}
+
+int LaunchScheduler::add(Rollout rollout, Clock::time_point now, bool isHeld) {
+    const int id = _nextId++;
+    if (rollout.items.empty() && !isHeld) {
+        // There is nothing to launch, but the identifier is still valid to be cancelled
+        return id;
+    }
+
+    _rollouts[id] = {
+        .rollout = std::move(rollout),
+        .isHeld = isHeld,
+        .nextLaunch = now
+    };
+    return id;
+}
+
+void LaunchScheduler::release(int id, Clock::time_point now) {
+    const auto it = _rollouts.find(id);
+    if (it == _rollouts.end()) {
+        return;
+    }
+
+    it->second.isHeld = false;
+    it->second.nextLaunch = now;
+    if (it->second.rollout.items.empty()) {
+        _rollouts.erase(it);
+    }
+}
+
+std::vector<int> LaunchScheduler::cancel(int id) {
+    const auto it = _rollouts.find(id);
+    if (it == _rollouts.end()) {
+        return {};
+    }
+
+    const std::vector<int>& items = it->second.rollout.items;
+    std::vector<int> res = std::vector<int>(items.begin() + it->second.next, items.end());
+    _rollouts.erase(it);
+    return res;
+}
+
+void LaunchScheduler::setLimit(int group, std::size_t limit) {
+    _limits[group] = limit;
+}
+
+void LaunchScheduler::setLaunched(int id, int item) {
+    const auto it = _inFlight.find({ id, item });
+    if (it == _inFlight.end()) {
+        // The launch might have timed out already
+        return;
+    }
+
+    _nInFlight[it->second.group]--;
+    _inFlight.erase(it);
+}
+
+std::vector<LaunchScheduler::Launch> LaunchScheduler::update(Clock::time_point now) {
+    // Launches that were never confirmed, for example because the connection was lost,
+    // must not block their group forever
+    for (auto it = _inFlight.begin(); it != _inFlight.end();) {
+        if (it->second.timeout <= now) {
+            _nInFlight[it->second.group]--;
+            it = _inFlight.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+
+    // The rollouts are handled in the order in which they were added, so that an older
+    // rollout gets the free places of a group first
+    std::vector<Launch> res;
+    for (auto it = _rollouts.begin(); it != _rollouts.end();) {
+        State& s = it->second;
+        while (!s.isHeld && s.nextLaunch <= now && s.next < s.rollout.items.size() &&
+               hasCapacity(s.rollout.group))
+        {
+            const int item = s.rollout.items[s.next];
+            s.next++;
+            s.nextLaunch = now + s.rollout.delay;
+
+            // Launching the same item of a rollout twice replaces the previous launch
+            const bool isNew = _inFlight.insert_or_assign(
+                { it->first, item },
+                InFlight{ s.rollout.group, now + _options.launchTimeout }
+            ).second;
+            if (isNew) {
+                _nInFlight[s.rollout.group]++;
+            }
+            res.push_back({ .rollout = it->first, .item = item });
+        }
+
+        if (s.next == s.rollout.items.size()) {
+            it = _rollouts.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    return res;
+}
+
+std::optional<LaunchScheduler::Clock::time_point> LaunchScheduler::nextUpdate() const {
+    std::optional<Clock::time_point> res;
+    auto consider = [&res](Clock::time_point t) {
+        if (!res.has_value() || t < *res) {
+            res = t;
+        }
+    };
+
+    for (const auto& [id, s] : _rollouts) {
+        if (s.isHeld) {
+            continue;
+        }
+
+        if (hasCapacity(s.rollout.group)) {
+            consider(s.nextLaunch);
+        }
+        else {
+            // A full group only gets a free place once a launch is confirmed, which
+            // comes with its own update, or when a launch times out
+            for (const auto& [key, f] : _inFlight) {
+                if (f.group == s.rollout.group) {
+                    consider(f.timeout);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+bool LaunchScheduler::contains(int id) const {
+    return _rollouts.contains(id);
+}
+
+bool LaunchScheduler::isInFlight(int id, int item) const {
+    return _inFlight.contains({ id, item });
+}
+
+std::size_t LaunchScheduler::nInFlight(int group) const {
+    const auto it = _nInFlight.find(group);
+    return it != _nInFlight.end() ? it->second : 0;
+}
+
+bool LaunchScheduler::hasCapacity(int group) const {
+    const auto it = _limits.find(group);
+    return it == _limits.end() || it->second == 0 || nInFlight(group) < it->second;
+}
+
+} // namespace common
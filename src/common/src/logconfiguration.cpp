@@ -34,11 +34,32 @@
 
 #include "logconfiguration.h"
 
+#include <array>
+#include <format>
+#include <stdexcept>
 #include <string_view>
 
 namespace {
     constexpr std::string_view KeyLogRotationFrequency = "frequency";
     constexpr std::string_view KeyLogRotationKeepPrevious = "keepPrevious";
+
+    // The names are indexed by the values of the respective enums
+    constexpr std::array<std::string_view, common::NumLogCategories> CategoryNames = {
+        "General", "Network", "Messages", "Processes", "Ui", "Rest"
+    };
+    constexpr std::array<std::string_view, 3> LevelNames = { "Debug", "Info", "None" };
+
+    template <typename T, std::size_t N>
+    T fromName(const std::array<std::string_view, N>& names, std::string_view name,
+               std::string_view kind)
+    {
+        for (std::size_t i = 0; i < names.size(); i++) {
+            if (names[i] == name) {
+                return static_cast<T>(i);
+            }
+        }
+        throw std::runtime_error(std::format("Unknown log {} '{}'", kind, name));
+    }
 } // namespace
 
 namespace common {
@@ -58,4 +79,28 @@ void from_json(const nlohmann::json& j, LogRotation& lr) {
     }
 }
 
+void to_json(nlohmann::json& j, const LogLevels& ll) {
+    j = nlohmann::json::object();
+    for (const auto& [category, level] : ll.levels) {
+        j[CategoryNames[static_cast<std::size_t>(category)]] =
+            LevelNames[static_cast<std::size_t>(level)];
+    }
+}
+
+void from_json(const nlohmann::json& j, LogLevels& ll) {
+    for (auto it = j.begin(); it != j.end(); it++) {
+        const LogCategory category =
+            fromName<LogCategory>(CategoryNames, it.key(), "category");
+        const LogLevel level =
+            fromName<LogLevel>(LevelNames, it->get<std::string>(), "level");
+        ll.levels[category] = level;
+    }
+}
+
+void applyLogLevels(const LogLevels& ll) {
+    for (const auto& [category, level] : ll.levels) {
+        Log::setLevel(category, level);
+    }
+}
+
 } // namespace common
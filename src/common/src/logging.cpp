@@ -34,22 +34,37 @@
 
 #include "logging.h"
 
+#include <QCoreApplication>
+#include <QMetaObject>
 #include <Windows.h>
 #include <assert.h>
+#include <cstdlib>
 #include <filesystem>
+#include <utility>
 
 namespace {
     constexpr std::string_view LogPrefix = "log_";
     constexpr std::string_view LogPostfix = ".txt";
 
     std::string currentTime() {
-        SYSTEMTIME t = {};
-        GetLocalTime(&t);
+        using namespace std::chrono;
 
-        return std::format(
-            "{:0>4}-{:0>2}-{:0>2} {:0>2}:{:0>2}:{:0>2}.{:0<3}",
-            t.wYear, t.wMonth, t.wDay, t.wHour, t.wMinute, t.wSecond, t.wMilliseconds
-        );
+        // Converting to the local time zone and formatting the date is comparatively
+        // expensive, so each thread only does it once per second and then just appends
+        // the milliseconds for all messages within the same second
+        thread_local sys_seconds cachedSecond;
+        thread_local std::string cachedPrefix;
+
+        const system_clock::time_point now = system_clock::now();
+        const sys_seconds second = floor<seconds>(now);
+        if (second != cachedSecond || cachedPrefix.empty()) {
+            const zoned_time local = zoned_time(current_zone(), second);
+            cachedPrefix = std::format("{:%Y-%m-%d %H:%M:%S}", local.get_local_time());
+            cachedSecond = second;
+        }
+
+        const long long ms = duration_cast<milliseconds>(now - second).count();
+        return std::format("{}.{:0>3}", cachedPrefix, ms);
     }
 
     std::string currentDate() {
@@ -82,22 +97,36 @@ namespace common {
 
 Log* Log::_log = nullptr;
 
+std::array<std::atomic<LogLevel>, NumLogCategories> Log::_levels = {
+    LogLevel::Info, LogLevel::Info, LogLevel::Info,
+    LogLevel::Info, LogLevel::Info, LogLevel::Info
+};
+
 void Log::initialize(std::string application, bool createLogFile, bool shouldLogDebug,
                      std::function<void(std::string)> loggingFunction)
 {
     assert(!application.empty());
     _log = new Log(std::move(application), createLogFile, shouldLogDebug);
     _log->_loggingFunction = std::move(loggingFunction);
+
+    // Start the writer only after the logging function is set as it is used there
+    _log->_isWriterRunning = true;
+    _log->_writer = std::jthread([](std::stop_token stopToken) {
+        _log->runWriter(stopToken);
+    });
+    std::atexit(&Log::shutdown);
 }
 
 Log* Log::ref() {
     return _log;
 }
 
-Log::Log(std::string componentName, bool createLogFile, bool shouldLogDebug)
-    : _shouldLogDebug(shouldLogDebug)
-{
+Log::Log(std::string componentName, bool createLogFile, bool shouldLogDebug) {
     assert(!componentName.empty());
+    for (std::atomic<LogLevel>& level : _levels) {
+        level = shouldLogDebug ? LogLevel::Debug : LogLevel::Info;
+    }
+
     if (createLogFile) {
         _filePath = std::format("{}{}{}", LogPrefix, componentName, LogPostfix);
         _file = std::ofstream(_filePath);
@@ -108,24 +137,22 @@ void Log::logMessage(std::string category, std::string message) {
     message = std::format("{}  ({}): {}", currentTime(), category, message);
 
     if (_log) {
-        // First the file
-        if (!_log->_filePath.empty()) {
-            std::unique_lock lock(_log->_access);
-            _log->_file << message << '\n';
-            _log->_file.flush();
+        if (_log->_isWriterRunning.load(std::memory_order_acquire)) {
+            _log->enqueue(std::move(message));
+        }
+        else {
+            _log->writeImmediately(message);
         }
-
-        _log->_loggingFunction(message);
     }
     else {
         std::cout << message << '\n';
+        OutputDebugString((message + '\n').c_str());
     }
-
-    OutputDebugString((message + '\n').c_str());
 }
 
 void Log::logDebugMessage(std::string category, std::string message) {
-    if (_log && _log->_shouldLogDebug) {
+    // Whether debug messages are wanted is decided by the callers through isEnabled
+    if (_log) {
         logMessage(std::move(category), "{Debug} " + std::move(message));
     }
 
@@ -151,11 +178,230 @@ void Log::performLogRotation(bool keepLog) {
 }
 
 bool Log::shouldLogDebugMessage() const {
-    return _shouldLogDebug;
+    return isEnabled(LogCategory::General, LogLevel::Debug);
+}
+
+void Log::setLevel(LogCategory category, LogLevel level) {
+    _levels[static_cast<std::size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+LogLevel Log::level(LogCategory category) {
+    return _levels[static_cast<std::size_t>(category)].load(std::memory_order_relaxed);
 }
 
 void Log::setLoggingFunction(std::function<void(std::string)> loggingFunction) {
     _loggingFunction = std::move(loggingFunction);
 }
 
+void Log::setOptions(Options options) {
+    _maxPendingBytes = options.maxPendingBytes;
+    {
+        std::unique_lock lock(_wakeMutex);
+        _options = options;
+    }
+    _wake.notify_one();
+}
+
+Log::Statistics Log::statistics() const {
+    Statistics res;
+    res.nWritten = _nWritten.load(std::memory_order_relaxed);
+    res.nDropped = _nDropped.load(std::memory_order_relaxed);
+    return res;
+}
+
+void Log::shutdown() {
+    if (!_log || !_log->_isWriterRunning) {
+        return;
+    }
+
+    // Messages that are logged from now on are written immediately. The writer drains
+    // everything that was queued before it finishes
+    _log->_isWriterRunning = false;
+    _log->_writer.request_stop();
+    _log->_writer.join();
+}
+
+void Log::enqueue(std::string message) {
+    const std::size_t size = message.size();
+    const std::size_t maxSize = _maxPendingBytes.load(std::memory_order_relaxed);
+    if (_pendingBytes.fetch_add(size, std::memory_order_relaxed) + size > maxSize) {
+        // The writer can't keep up, so we rather lose this message than grow without
+        // bounds. The writer reports the number of dropped messages once it caught up
+        _pendingBytes.fetch_sub(size, std::memory_order_relaxed);
+        _nDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Entry* entry = new Entry;
+    entry->message = std::move(message);
+    Entry* head = _pending.load(std::memory_order_relaxed);
+    do {
+        entry->next = head;
+    } while (!_pending.compare_exchange_weak(
+        head, entry,
+        std::memory_order_release, std::memory_order_relaxed
+    ));
+
+    if (!head) {
+        // The queue was empty, so the writer might be sleeping. Taking the mutex makes
+        // sure that the writer is either waiting already or will see the new message
+        { std::unique_lock lock(_wakeMutex); }
+        _wake.notify_one();
+    }
+}
+
+void Log::writeImmediately(const std::string& message) {
+    if (!_filePath.empty()) {
+        std::unique_lock lock(_access);
+        _file << message << '\n';
+        _file.flush();
+    }
+    OutputDebugString((message + '\n').c_str());
+    _nWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Log::runWriter(std::stop_token stopToken) {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point lastFlush = Clock::now();
+    std::size_t unflushedBytes = 0;
+    auto hasPending = [this]() {
+        return _pending.load(std::memory_order_relaxed) != nullptr;
+    };
+
+    while (true) {
+        Options options;
+        {
+            std::unique_lock lock(_wakeMutex);
+            if (unflushedBytes > 0) {
+                // Wake up in time to flush what was written, even if nothing else comes
+                _wake.wait_until(
+                    lock, stopToken, lastFlush + _options.flushInterval, hasPending
+                );
+            }
+            else {
+                _wake.wait(lock, stopToken, hasPending);
+            }
+
+            if (hasPending()) {
+                // Give the messages that are logged right after the first one a chance
+                // to become part of the same batch
+                _wake.wait_for(
+                    lock, stopToken, _options.batchInterval, []() { return false; }
+                );
+            }
+            options = _options;
+        }
+
+        const bool isStopping = stopToken.stop_requested();
+        Entry* entries = _pending.exchange(nullptr, std::memory_order_acquire);
+        if (entries) {
+            unflushedBytes += writeBatch(entries, isStopping);
+        }
+
+        const Clock::time_point now = Clock::now();
+        const bool shouldFlush = isStopping || unflushedBytes >= options.flushSize ||
+            now - lastFlush >= options.flushInterval;
+        if (unflushedBytes > 0 && shouldFlush) {
+            std::unique_lock lock(_access);
+            _file.flush();
+            unflushedBytes = 0;
+            lastFlush = now;
+        }
+
+        if (isStopping && !_pending.load(std::memory_order_acquire)) {
+            break;
+        }
+    }
+}
+
+std::size_t Log::writeBatch(Entry* entries, bool isStopping) {
+    // The queue is stored newest first, so we have to reverse it to restore the order
+    // in which the messages were logged
+    Entry* head = nullptr;
+    while (entries) {
+        Entry* next = entries->next;
+        entries->next = head;
+        head = entries;
+        entries = next;
+    }
+
+    std::vector<std::string> batch;
+    const std::uint64_t nDropped = _nDropped.load(std::memory_order_relaxed);
+    if (nDropped != _nReportedDropped) {
+        batch.push_back(std::format(
+            "{}  (Log): Dropped {} messages as the log could not keep up",
+            currentTime(), nDropped - _nReportedDropped
+        ));
+        _nReportedDropped = nDropped;
+    }
+    std::size_t nBytes = 0;
+    while (head) {
+        nBytes += head->message.size();
+        batch.push_back(std::move(head->message));
+        Entry* next = head->next;
+        delete head;
+        head = next;
+    }
+
+    std::size_t nWrittenBytes = 0;
+    if (!_filePath.empty()) {
+        std::unique_lock lock(_access);
+        for (const std::string& message : batch) {
+            _file << message << '\n';
+            nWrittenBytes += message.size() + 1;
+        }
+    }
+    for (const std::string& message : batch) {
+        OutputDebugString((message + '\n').c_str());
+    }
+    _nWritten.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    if (isStopping || !QCoreApplication::instance()) {
+        // There is no event loop (anymore) that could deliver the messages
+        _pendingBytes.fetch_sub(nBytes, std::memory_order_relaxed);
+        return nWrittenBytes;
+    }
+
+    {
+        // The messages still count against the pending bytes until the main thread has
+        // passed them to the logging function. Otherwise a main thread that can't keep
+        // up would let this batch grow without bounds
+        std::unique_lock lock(_loggingFunctionAccess);
+        _loggingFunctionBytes += nBytes;
+        _loggingFunctionBatch.insert(
+            _loggingFunctionBatch.end(),
+            std::make_move_iterator(batch.begin()),
+            std::make_move_iterator(batch.end())
+        );
+    }
+    if (!_isDeliveryScheduled.exchange(true)) {
+        // Only a single delivery is in flight at any time, so if the main thread is
+        // busy, the batches are merged until it gets around to process them
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [this]() { deliverToLoggingFunction(); },
+            Qt::QueuedConnection
+        );
+    }
+    return nWrittenBytes;
+}
+
+void Log::deliverToLoggingFunction() {
+    std::vector<std::string> batch;
+    std::size_t nBytes = 0;
+    {
+        std::unique_lock lock(_loggingFunctionAccess);
+        std::swap(batch, _loggingFunctionBatch);
+        nBytes = std::exchange(_loggingFunctionBytes, 0);
+        _isDeliveryScheduled = false;
+    }
+
+    for (std::string& message : batch) {
+        _loggingFunction(std::move(message));
+    }
+    batch.clear();
+    _pendingBytes.fetch_sub(nBytes, std::memory_order_relaxed);
+}
+
 } // namespace common
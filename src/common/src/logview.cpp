@@ -0,0 +1,331 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "logview.h"
+
+#include <QComboBox>
+#include <QListView>
+#include <QScrollBar>
+#include <QStyledItemDelegate>
+#include <QVBoxLayout>
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
+namespace {
+    /// New messages are collected for this long before they are added to the model
+    constexpr std::chrono::milliseconds RepaintInterval = std::chrono::milliseconds(16);
+
+    // The messages produced by the Log look like `<date> <time>  (<category>): <text>`
+    std::string_view extractCategory(std::string_view message) {
+        const std::size_t begin = message.find("  (");
+        if (begin == std::string_view::npos) {
+            return "";
+        }
+        const std::size_t end = message.find("): ", begin + 3);
+        if (end == std::string_view::npos) {
+            return "";
+        }
+        return message.substr(begin + 3, end - begin - 3);
+    }
+
+    // All lines are rendered as a single line of text, so they all have the same height
+    // and there is no need to measure the text of every line
+    class UniformLineDelegate : public QStyledItemDelegate {
+    public:
+        using QStyledItemDelegate::QStyledItemDelegate;
+
+        QSize sizeHint(const QStyleOptionViewItem& option,
+                       const QModelIndex& index) const override
+        {
+            QSize size = QStyledItemDelegate::sizeHint(option, index);
+            size.setHeight(option.fontMetrics.height() + 2);
+            return size;
+        }
+    };
+} // namespace
+
+namespace common {
+
+LogModel::LogModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(RepaintInterval);
+    connect(&_flushTimer, &QTimer::timeout, this, &LogModel::flushPending);
+}
+
+int LogModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    if (_filter.has_value()) {
+        return static_cast<int>(_filtered.size());
+    }
+    return static_cast<int>(_nextSeq - _firstSeq);
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const std::size_t row = static_cast<std::size_t>(index.row());
+    const std::uint64_t seq = _filter.has_value() ? _filtered[row] : _firstSeq + row;
+    return line(seq).text;
+}
+
+void LogModel::append(std::string message) {
+    _pending.push_back(std::move(message));
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+void LogModel::setMaxLines(std::size_t maxLines) {
+    assert(maxLines > 0);
+    if (maxLines == _maxLines) {
+        return;
+    }
+
+    beginResetModel();
+    // Keep the newest lines that still fit and store them from the start of the buffer
+    const std::uint64_t nKept = std::min<std::uint64_t>(_nextSeq - _firstSeq, maxLines);
+    std::vector<Line> lines;
+    lines.reserve(nKept);
+    for (std::uint64_t seq = _nextSeq - nKept; seq < _nextSeq; seq++) {
+        lines.push_back(std::move(_lines[seq % _maxLines]));
+    }
+    _lines = std::move(lines);
+    _maxLines = maxLines;
+    _firstSeq = 0;
+    _nextSeq = nKept;
+
+    _filtered.clear();
+    if (_filter.has_value()) {
+        for (std::uint64_t seq = _firstSeq; seq < _nextSeq; seq++) {
+            if (line(seq).category == *_filter) {
+                _filtered.push_back(seq);
+            }
+        }
+    }
+    endResetModel();
+}
+
+std::size_t LogModel::maxLines() const {
+    return _maxLines;
+}
+
+void LogModel::setCategoryFilter(const QString& category) {
+    beginResetModel();
+    _filtered.clear();
+    if (category.isEmpty()) {
+        _filter = std::nullopt;
+    }
+    else {
+        _filter = findOrAddCategory(category.toStdString());
+        for (std::uint64_t seq = _firstSeq; seq < _nextSeq; seq++) {
+            if (line(seq).category == *_filter) {
+                _filtered.push_back(seq);
+            }
+        }
+    }
+    endResetModel();
+}
+
+void LogModel::flushPending() {
+    if (_pending.empty()) {
+        return;
+    }
+
+    // If more messages arrived than we can store, the oldest of them would be replaced
+    // right away, so we don't even add them
+    const std::size_t nSkipped =
+        _pending.size() > _maxLines ? _pending.size() - _maxLines : 0;
+
+    std::vector<Line> lines;
+    lines.reserve(_pending.size() - nSkipped);
+    std::size_t nMatching = 0;
+    for (std::size_t i = nSkipped; i < _pending.size(); i++) {
+        Line l;
+        l.category = findOrAddCategory(extractCategory(_pending[i]));
+        l.text = QString::fromStdString(_pending[i]);
+        if (!_filter.has_value() || l.category == *_filter) {
+            nMatching++;
+        }
+        lines.push_back(std::move(l));
+    }
+    _pending.clear();
+
+    // First remove the oldest lines whose place in the ring buffer is needed
+    const std::uint64_t nStored = _nextSeq - _firstSeq;
+    if (nStored + lines.size() > _maxLines) {
+        const std::uint64_t firstSeq = _firstSeq + (nStored + lines.size() - _maxLines);
+        if (_filter.has_value()) {
+            std::size_t nRemoved = 0;
+            while (nRemoved < _filtered.size() && _filtered[nRemoved] < firstSeq) {
+                nRemoved++;
+            }
+
+            if (nRemoved > 0) {
+                beginRemoveRows(QModelIndex(), 0, static_cast<int>(nRemoved - 1));
+                _filtered.erase(_filtered.begin(), _filtered.begin() + nRemoved);
+                _firstSeq = firstSeq;
+                endRemoveRows();
+            }
+            else {
+                _firstSeq = firstSeq;
+            }
+        }
+        else {
+            const int nRemoved = static_cast<int>(firstSeq - _firstSeq);
+            beginRemoveRows(QModelIndex(), 0, nRemoved - 1);
+            _firstSeq = firstSeq;
+            endRemoveRows();
+        }
+    }
+
+    // Then add the new lines to the end, which only touches the rows that are inserted
+    const int firstRow = rowCount();
+    if (nMatching > 0) {
+        beginInsertRows(
+            QModelIndex(),
+            firstRow,
+            firstRow + static_cast<int>(nMatching) - 1
+        );
+    }
+    for (Line& l : lines) {
+        const std::uint64_t seq = _nextSeq;
+        _nextSeq++;
+        if (_filter.has_value() && l.category == *_filter) {
+            _filtered.push_back(seq);
+        }
+
+        const std::size_t idx = static_cast<std::size_t>(seq % _maxLines);
+        if (idx < _lines.size()) {
+            _lines[idx] = std::move(l);
+        }
+        else {
+            _lines.push_back(std::move(l));
+        }
+    }
+    if (nMatching > 0) {
+        endInsertRows();
+    }
+}
+
+std::uint32_t LogModel::findOrAddCategory(std::string_view category) {
+    if (auto it = _categoryIndices.find(category);  it != _categoryIndices.end()) {
+        return it->second;
+    }
+
+    const std::uint32_t idx = static_cast<std::uint32_t>(_categories.size());
+    _categories.push_back(QString::fromUtf8(category.data(), category.size()));
+    _categoryIndices.emplace(std::string(category), idx);
+    emit categoryAdded(_categories.back());
+    return idx;
+}
+
+const LogModel::Line& LogModel::line(std::uint64_t seq) const {
+    assert(seq >= _firstSeq && seq < _nextSeq);
+    return _lines[static_cast<std::size_t>(seq % _maxLines)];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+
+LogView::LogView(QWidget* parent)
+    : QWidget(parent)
+{
+    QBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    _categories = new QComboBox;
+    // The empty user data of the first entry shows all categories
+    _categories->addItem("All categories");
+    layout->addWidget(_categories);
+
+    _model = new LogModel(this);
+    _view = new QListView;
+    _view->setModel(_model);
+    _view->setItemDelegate(new UniformLineDelegate(_view));
+    _view->setUniformItemSizes(true);
+    _view->setWordWrap(false);
+    _view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    layout->addWidget(_view, 1);
+
+    connect(
+        _model, &LogModel::categoryAdded,
+        this, [this](const QString& category) {
+            _categories->addItem(category, category);
+        }
+    );
+    connect(
+        _categories, &QComboBox::currentIndexChanged,
+        this, [this](int index) {
+            _model->setCategoryFilter(_categories->itemData(index).toString());
+            _view->scrollToBottom();
+        }
+    );
+
+    // Only follow the new messages if the user has not scrolled away from the bottom
+    connect(
+        _model, &QAbstractItemModel::rowsAboutToBeInserted,
+        this, [this]() {
+            const QScrollBar* bar = _view->verticalScrollBar();
+            _isAtBottom = bar->value() == bar->maximum();
+        }
+    );
+    connect(
+        _model, &QAbstractItemModel::rowsInserted,
+        this, [this]() {
+            if (_isAtBottom) {
+                _view->scrollToBottom();
+            }
+        }
+    );
+}
+
+void LogView::appendMessage(std::string message) {
+    _model->append(std::move(message));
+}
+
+void LogView::setMaxLines(std::size_t maxLines) {
+    _model->setMaxLines(maxLines);
+}
+
+} // namespace common
@@ -0,0 +1,564 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "messagedecoder.h"
+
+#include "version.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr std::string_view KeyProcessId = "processId";
+    constexpr std::string_view KeyMessage = "message";
+    constexpr std::string_view KeyOutputType = "outputType";
+    constexpr std::string_view KeyOffset = "offset";
+    constexpr std::string_view KeyStatus = "status";
+    constexpr std::string_view KeyProcesses = "processes";
+
+    constexpr std::string_view KeyProgramId = "programId";
+    constexpr std::string_view KeyConfigurationId = "configurationId";
+    constexpr std::string_view KeyClusterId = "clusterId";
+    constexpr std::string_view KeyNodeId = "nodeId";
+    constexpr std::string_view KeyDataHash = "datahash";
+    constexpr std::string_view KeyProgramHash = "programHash";
+    constexpr std::string_view KeyClusterHash = "clusterHash";
+    constexpr std::string_view KeyNodeHash = "nodeHash";
+
+    // The fields of all messages that can be decoded. They are stored independent of the
+    // message type since the type might only be known after all other fields were read
+    enum class Field {
+        None,
+        Type,
+        Version,
+        Secret,
+        ProcessId,
+        Message,
+        OutputType,
+        Offset,
+        Status,
+        Processes
+    };
+
+    enum class ProcessField {
+        None,
+        ProcessId,
+        ProgramId,
+        ConfigurationId,
+        ClusterId,
+        NodeId,
+        DataHash,
+        ProgramHash,
+        ClusterHash,
+        NodeHash
+    };
+
+    Field toField(std::string_view key) {
+        if (key == common::Message::KeyType)    { return Field::Type; }
+        if (key == common::Message::KeyVersion) { return Field::Version; }
+        if (key == common::Message::KeySecret)  { return Field::Secret; }
+        if (key == KeyProcessId)                { return Field::ProcessId; }
+        if (key == KeyMessage)                  { return Field::Message; }
+        if (key == KeyOutputType)               { return Field::OutputType; }
+        if (key == KeyOffset)                   { return Field::Offset; }
+        if (key == KeyStatus)                   { return Field::Status; }
+        if (key == KeyProcesses)                { return Field::Processes; }
+        return Field::None;
+    }
+
+    ProcessField toProcessField(std::string_view key) {
+        if (key == KeyProcessId)       { return ProcessField::ProcessId; }
+        if (key == KeyProgramId)       { return ProcessField::ProgramId; }
+        if (key == KeyConfigurationId) { return ProcessField::ConfigurationId; }
+        if (key == KeyClusterId)       { return ProcessField::ClusterId; }
+        if (key == KeyNodeId)          { return ProcessField::NodeId; }
+        if (key == KeyDataHash)        { return ProcessField::DataHash; }
+        if (key == KeyProgramHash)     { return ProcessField::ProgramHash; }
+        if (key == KeyClusterHash)     { return ProcessField::ClusterHash; }
+        if (key == KeyNodeHash)        { return ProcessField::NodeHash; }
+        return ProcessField::None;
+    }
+
+    // Receives the SAX events from nlohmann's parser and stores the values of the known
+    // fields. As soon as we encounter something that this reader doesn't understand, the
+    // values that were read so far are turned into a JSON document and all remaining
+    // events are added to that document instead. This way every payload is only parsed
+    // once, regardless of whether it can be decoded directly or not
+    class Reader {
+    public:
+        using json = nlohmann::json;
+
+        bool null() {
+            switchToDocument();
+            return addValue(nullptr);
+        }
+
+        bool boolean(bool value) {
+            switchToDocument();
+            return addValue(value);
+        }
+
+        bool number_integer(json::number_integer_t value) {
+            if (!_isDocument && integer(static_cast<std::uint64_t>(value))) {
+                return true;
+            }
+            switchToDocument();
+            return addValue(value);
+        }
+
+        bool number_unsigned(json::number_unsigned_t value) {
+            if (!_isDocument && integer(value)) {
+                return true;
+            }
+            switchToDocument();
+            return addValue(value);
+        }
+
+        bool number_float(json::number_float_t value, const json::string_t&) {
+            switchToDocument();
+            return addValue(value);
+        }
+
+        bool string(json::string_t& value) {
+            if (!_isDocument && _depth == 1) {
+                switch (_field) {
+                    case Field::Type:
+                        type = std::move(value);
+                        return true;
+                    case Field::Secret:
+                        secret = std::move(value);
+                        return true;
+                    case Field::Message:
+                        message = std::move(value);
+                        return true;
+                    case Field::OutputType:
+                        outputType = std::move(value);
+                        return true;
+                    case Field::Status:
+                        status = std::move(value);
+                        return true;
+                    default:
+                        break;
+                }
+            }
+            switchToDocument();
+            return addValue(std::move(value));
+        }
+
+        bool binary(json::binary_t& value) {
+            switchToDocument();
+            return addValue(std::move(value));
+        }
+
+        bool start_object(std::size_t) {
+            if (!_isDocument) {
+                if (_depth == 0) {
+                    _depth = 1;
+                    return true;
+                }
+                else if (_depth == 2 && _field == Field::Processes) {
+                    // A new entry in the list of processes
+                    _depth = 3;
+                    processes->emplace_back();
+                    _processFields = 0;
+                    return true;
+                }
+                switchToDocument();
+            }
+            _stack.push_back(addValue(json::value_t::object));
+            return true;
+        }
+
+        bool key(json::string_t& key) {
+            if (!_isDocument) {
+                if (_depth == 1) {
+                    _field = toField(key);
+                    if (_field != Field::None) {
+                        _key = std::move(key);
+                        return true;
+                    }
+                }
+                else if (_depth == 3) {
+                    _processField = toProcessField(key);
+                    if (_processField != ProcessField::None) {
+                        _key = std::move(key);
+                        return true;
+                    }
+                }
+                switchToDocument();
+            }
+            _key = std::move(key);
+            return true;
+        }
+
+        bool end_object() {
+            if (_isDocument) {
+                _stack.pop_back();
+            }
+            else if (_depth == 3) {
+                if ((_processFields & RequiredProcessFields) != RequiredProcessFields) {
+                    throw std::runtime_error("Missing value in process information");
+                }
+                _depth = 2;
+            }
+            else {
+                _depth = 0;
+            }
+            return true;
+        }
+
+        bool start_array(std::size_t) {
+            if (!_isDocument) {
+                if (_depth == 1 && _field == Field::Version) {
+                    _depth = 2;
+                    _hasVersion = true;
+                    nVersion = 0;
+                    return true;
+                }
+                else if (_depth == 1 && _field == Field::Processes) {
+                    _depth = 2;
+                    processes.emplace();
+                    return true;
+                }
+                switchToDocument();
+            }
+            _stack.push_back(addValue(json::value_t::array));
+            return true;
+        }
+
+        bool end_array() {
+            if (_isDocument) {
+                _stack.pop_back();
+            }
+            else {
+                _depth = 1;
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&,
+                         const nlohmann::detail::exception& e)
+        {
+            throw std::runtime_error(e.what());
+        }
+
+        bool isDocument() const {
+            return _isDocument;
+        }
+
+        /**
+         * Returns the JSON document of the payload. If the reader did not have to switch
+         * to the document while parsing, it is created from the values that were read.
+         */
+        json document() {
+            if (!_isDocument) {
+                _document = fieldsToDocument();
+            }
+            return std::move(_document);
+        }
+
+        std::optional<std::string> type;
+        std::array<int, 3> version = { 0, 0, 0 };
+        std::size_t nVersion = 0;
+        std::optional<std::string> secret;
+        std::optional<int> processId;
+        std::optional<std::string> message;
+        std::optional<std::string> outputType;
+        std::optional<std::uint64_t> offset;
+        std::optional<std::string> status;
+        std::optional<std::vector<common::TrayStatusMessage::ProcessInfo>> processes;
+
+    private:
+        // The entity hashes are optional and not part of the required fields
+        static constexpr int RequiredProcessFields = 0b111111;
+
+        bool integer(std::uint64_t value) {
+            if (_depth == 1 && _field == Field::ProcessId) {
+                processId = static_cast<int>(value);
+                return true;
+            }
+            else if (_depth == 1 && _field == Field::Offset) {
+                offset = value;
+                return true;
+            }
+            else if (_depth == 2 && _field == Field::Version) {
+                if (nVersion >= version.size()) {
+                    return false;
+                }
+                version[nVersion] = static_cast<int>(value);
+                nVersion++;
+                return true;
+            }
+            else if (_depth == 3) {
+                common::TrayStatusMessage::ProcessInfo& p = processes->back();
+                const int v = static_cast<int>(value);
+                switch (_processField) {
+                    case ProcessField::ProcessId:       p.processId = v;        break;
+                    case ProcessField::ProgramId:       p.programId = v;        break;
+                    case ProcessField::ConfigurationId: p.configurationId = v;  break;
+                    case ProcessField::ClusterId:       p.clusterId = v;        break;
+                    case ProcessField::NodeId:          p.nodeId = v;           break;
+                    case ProcessField::DataHash:        p.dataHash = value;     break;
+                    case ProcessField::ProgramHash:     p.programHash = value;  break;
+                    case ProcessField::ClusterHash:     p.clusterHash = value;  break;
+                    case ProcessField::NodeHash:        p.nodeHash = value;     break;
+                    case ProcessField::None:
+                        return false;
+                }
+                _processFields |= processFieldBit(_processField);
+                return true;
+            }
+            return false;
+        }
+
+        static int processFieldBit(ProcessField field) {
+            return 1 << (static_cast<int>(field) - 1);
+        }
+
+        static json processToDocument(const common::TrayStatusMessage::ProcessInfo& p,
+                                      int fields)
+        {
+            const std::array<std::pair<ProcessField, json>, 9> values = {{
+                { ProcessField::ProcessId, p.processId },
+                { ProcessField::ProgramId, p.programId },
+                { ProcessField::ConfigurationId, p.configurationId },
+                { ProcessField::ClusterId, p.clusterId },
+                { ProcessField::NodeId, p.nodeId },
+                { ProcessField::DataHash, p.dataHash },
+                { ProcessField::ProgramHash, p.programHash },
+                { ProcessField::ClusterHash, p.clusterHash },
+                { ProcessField::NodeHash, p.nodeHash }
+            }};
+            constexpr std::array<std::string_view, 9> Keys = {
+                KeyProcessId, KeyProgramId, KeyConfigurationId, KeyClusterId, KeyNodeId,
+                KeyDataHash, KeyProgramHash, KeyClusterHash, KeyNodeHash
+            };
+
+            json res = json::object();
+            for (std::size_t i = 0; i < values.size(); i++) {
+                if (fields & processFieldBit(values[i].first)) {
+                    res[Keys[i]] = values[i].second;
+                }
+            }
+            return res;
+        }
+
+        // Creates a JSON object that contains all of the values that were read so far
+        json fieldsToDocument() {
+            json res = json::object();
+            if (type.has_value()) {
+                res[common::Message::KeyType] = std::move(*type);
+            }
+            if (_hasVersion) {
+                json& v = res[common::Message::KeyVersion];
+                v = json::array();
+                for (std::size_t i = 0; i < nVersion; i++) {
+                    v.push_back(version[i]);
+                }
+            }
+            if (secret.has_value()) {
+                res[common::Message::KeySecret] = std::move(*secret);
+            }
+            if (processId.has_value()) {
+                res[KeyProcessId] = *processId;
+            }
+            if (message.has_value()) {
+                res[KeyMessage] = std::move(*message);
+            }
+            if (outputType.has_value()) {
+                res[KeyOutputType] = std::move(*outputType);
+            }
+            if (offset.has_value()) {
+                res[KeyOffset] = *offset;
+            }
+            if (status.has_value()) {
+                res[KeyStatus] = std::move(*status);
+            }
+            if (processes.has_value()) {
+                json& ps = res[KeyProcesses];
+                ps = json::array();
+                for (std::size_t i = 0; i < processes->size(); i++) {
+                    // Only the last entry can be incomplete if we are still inside it
+                    const bool isCurrent = _depth == 3 && i == processes->size() - 1;
+                    constexpr int AllFields = (1 << 9) - 1;
+                    ps.push_back(
+                        processToDocument((*processes)[i],
+                        isCurrent ? _processFields : AllFields)
+                    );
+                }
+            }
+            return res;
+        }
+
+        // Moves the values that were read so far into the document and continues at the
+        // same position inside the document
+        void switchToDocument() {
+            if (_isDocument) {
+                return;
+            }
+
+            _isDocument = true;
+            if (_depth == 0) {
+                // The payload is not even an object, so there is nothing to move
+                return;
+            }
+
+            _document = fieldsToDocument();
+            _stack.push_back(&_document);
+            if (_depth >= 2) {
+                _stack.push_back(&_document[_field == Field::Version ?
+                    common::Message::KeyVersion : KeyProcesses]);
+            }
+            if (_depth == 3) {
+                _stack.push_back(&_stack.back()->back());
+            }
+        }
+
+        // Adds the value to the current array or as the value of the last key of the
+        // current object and returns a pointer to the new value
+        template <typename T>
+        json* addValue(T&& value) {
+            if (_stack.empty()) {
+                _document = json(std::forward<T>(value));
+                return &_document;
+            }
+
+            json& parent = *_stack.back();
+            if (parent.is_array()) {
+                parent.emplace_back(std::forward<T>(value));
+                return &parent.back();
+            }
+            json& element = parent[_key];
+            element = json(std::forward<T>(value));
+            return &element;
+        }
+
+        int _depth = 0;
+        Field _field = Field::None;
+        ProcessField _processField = ProcessField::None;
+        int _processFields = 0;
+        bool _hasVersion = false;
+        /// The most recent key, which is where the next value of an object is stored
+        std::string _key;
+
+        bool _isDocument = false;
+        json _document;
+        /// The objects and arrays of the document that are currently open
+        std::vector<json*> _stack;
+    };
+
+    template <typename T>
+    T& required(std::optional<T>& value, std::string_view key) {
+        if (!value.has_value()) {
+            throw std::runtime_error(std::format("Missing field '{}'", key));
+        }
+        return *value;
+    }
+
+    nlohmann::json::input_format_t inputFormat(common::Encoding encoding) {
+        switch (encoding) {
+            case common::Encoding::Json:
+                return nlohmann::json::input_format_t::json;
+            case common::Encoding::Cbor:
+                return nlohmann::json::input_format_t::cbor;
+            case common::Encoding::MessagePack:
+                return nlohmann::json::input_format_t::msgpack;
+        }
+        throw std::logic_error("Missing case label");
+    }
+} // namespace
+
+namespace common {
+
+DecodedMessage decodeMessage(std::string_view payload, Encoding encoding) {
+    Reader reader;
+    nlohmann::json::sax_parse(
+        payload.begin(),
+        payload.end(),
+        &reader,
+        inputFormat(encoding)
+    );
+
+    const bool isDecodable = !reader.isDocument() && reader.type.has_value() &&
+        (*reader.type == ProcessOutputMessage::Type ||
+         *reader.type == ProcessStatusMessage::Type ||
+         *reader.type == TrayStatusMessage::Type);
+    if (!isDecodable) {
+        // Either the reader encountered something it doesn't know how to decode, or
+        // this is a message that is handled through its JSON document anyway
+        return reader.document();
+    }
+
+    if (reader.nVersion == 0) {
+        throw std::runtime_error(std::format("Missing field '{}'", Message::KeyVersion));
+    }
+    if (reader.version[0] != api::MajorVersion) {
+        throw std::runtime_error(std::format(
+            "Mismatching version number. Expected {} got {}.{}.{}",
+            api::MajorVersion, reader.version[0], reader.version[1], reader.version[2]
+        ));
+    }
+
+    const std::string& type = *reader.type;
+    if (type == ProcessOutputMessage::Type) {
+        ProcessOutputMessage msg;
+        msg.secret = std::move(reader.secret).value_or("");
+        msg.processId = required(reader.processId, KeyProcessId);
+        msg.message = std::move(required(reader.message, KeyMessage));
+        msg.outputType = outputTypeFromString(required(reader.outputType, KeyOutputType));
+        msg.offset = reader.offset;
+        return msg;
+    }
+    else if (type == ProcessStatusMessage::Type) {
+        ProcessStatusMessage msg;
+        msg.secret = std::move(reader.secret).value_or("");
+        msg.processId = required(reader.processId, KeyProcessId);
+        msg.status = statusFromString(required(reader.status, KeyStatus));
+        return msg;
+    }
+    else {
+        TrayStatusMessage msg;
+        msg.secret = std::move(reader.secret).value_or("");
+        msg.processes = std::move(required(reader.processes, KeyProcesses));
+        return msg;
+    }
+}
+
+} // namespace common
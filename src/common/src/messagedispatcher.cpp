@@ -0,0 +1,124 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "messagedispatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    template <typename... Ts>
+    constexpr std::array<std::string_view, sizeof...(Ts)> typeNames(
+                                                              common::MessageList<Ts...>)
+    {
+        return { Ts::Type... };
+    }
+
+    constexpr std::array<std::string_view, common::Messages::Size> TypeNames =
+        typeNames(common::Messages{});
+
+    using NameEntry = std::pair<std::string_view, common::MessageTypeId>;
+
+    // The type names sorted alphabetically so that we can binary search for them
+    constexpr std::array<NameEntry, common::Messages::Size> SortedTypeNames = []() {
+        std::array<NameEntry, common::Messages::Size> res;
+        for (std::size_t i = 0; i < TypeNames.size(); i++) {
+            res[i] = { TypeNames[i], i };
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }();
+
+    static_assert(
+        std::adjacent_find(
+            SortedTypeNames.begin(), SortedTypeNames.end(),
+            [](const NameEntry& lhs, const NameEntry& rhs) {
+                return lhs.first == rhs.first;
+            }
+        ) == SortedTypeNames.end(),
+        "Message types must have unique names"
+    );
+} // namespace
+
+namespace common {
+
+std::string_view messageTypeName(MessageTypeId id) {
+    return TypeNames.at(id);
+}
+
+std::optional<MessageTypeId> findMessageType(std::string_view type) {
+    const auto it = std::lower_bound(
+        SortedTypeNames.begin(), SortedTypeNames.end(),
+        type,
+        [](const NameEntry& entry, std::string_view t) { return entry.first < t; }
+    );
+    if (it == SortedTypeNames.end() || it->first != type) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+MessageHeader decodeMessageHeader(const nlohmann::json& message) {
+    MessageHeader header;
+    if (!message.is_object()) {
+        return header;
+    }
+
+    const auto type = message.find(Message::KeyType);
+    const auto version = message.find(Message::KeyVersion);
+    if (type == message.end() || !type->is_string() ||
+        version == message.end() || !version->is_array() || version->empty() ||
+        !version->front().is_number_integer())
+    {
+        return header;
+    }
+
+    if (version->front().get<int>() != api::MajorVersion) {
+        header.status = MessageHeader::Status::IncompatibleVersion;
+        return header;
+    }
+
+    const std::string& name = type->get_ref<const std::string&>();
+    std::optional<MessageTypeId> id = findMessageType(name);
+    if (!id.has_value()) {
+        header.status = MessageHeader::Status::UnknownType;
+        return header;
+    }
+
+    header.status = MessageHeader::Status::Valid;
+    header.typeId = *id;
+    return header;
+}
+
+} // namespace common
@@ -54,6 +54,10 @@ void to_json(nlohmann::json& j, const ErrorOccurredMessage& m) {
 
 void from_json(const nlohmann::json& j, ErrorOccurredMessage& m) {
     validateMessage(j, ErrorOccurredMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, ErrorOccurredMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 
     j.at(KeyError).get_to(m.error);
@@ -53,6 +53,10 @@ void to_json(nlohmann::json& j, const ExitCommandMessage& m) {
 
 void from_json(const nlohmann::json& j, ExitCommandMessage& m) {
     validateMessage(j, ExitCommandMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, ExitCommandMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
     j.at(KeyId).get_to(m.id);
 }
@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "messages/fetchoutputmessage.h"
+
+namespace {
+    constexpr std::string_view KeyIdentifier = "processId";
+    constexpr std::string_view KeyOutputType = "outputType";
+    constexpr std::string_view KeyOffset = "offset";
+    constexpr std::string_view KeyMaxBytes = "maxBytes";
+    constexpr std::string_view KeyFollow = "follow";
+} // namespace
+
+namespace common {
+
+FetchOutputMessage::FetchOutputMessage()
+    : Message(std::string(FetchOutputMessage::Type))
+{}
+
+void to_json(nlohmann::json& j, const FetchOutputMessage& m) {
+    j[Message::KeyType] = FetchOutputMessage::Type;
+    j[Message::KeyVersion] = { api::MajorVersion, api::MinorVersion, api::PatchVersion };
+    j[Message::KeySecret] = m.secret;
+    j[KeyIdentifier] = m.processId;
+    j[KeyOutputType] = toString(m.outputType);
+    if (m.offset.has_value()) {
+        j[KeyOffset] = *m.offset;
+    }
+    j[KeyMaxBytes] = m.maxBytes;
+    if (m.follow) {
+        j[KeyFollow] = m.follow;
+    }
+}
+
+void from_json(const nlohmann::json& j, FetchOutputMessage& m) {
+    validateMessage(j, FetchOutputMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, FetchOutputMessage& m, SkipValidation) {
+    from_json(j, static_cast<Message&>(m));
+
+    j.at(KeyIdentifier).get_to(m.processId);
+    const std::string& type = j.at(KeyOutputType).get_ref<const std::string&>();
+    m.outputType = outputTypeFromString(type);
+    if (auto it = j.find(KeyOffset);  it != j.end()) {
+        m.offset = it->get<std::uint64_t>();
+    }
+    j.at(KeyMaxBytes).get_to(m.maxBytes);
+    if (auto it = j.find(KeyFollow);  it != j.end()) {
+        it->get_to(m.follow);
+    }
+}
+
+} // namespace common
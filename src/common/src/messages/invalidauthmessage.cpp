@@ -47,6 +47,10 @@ void to_json(nlohmann::json& j, const InvalidAuthMessage&) {
 
 void from_json(const nlohmann::json& j, InvalidAuthMessage& m) {
     validateMessage(j, InvalidAuthMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, InvalidAuthMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 }
 
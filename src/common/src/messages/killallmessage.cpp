@@ -48,6 +48,10 @@ void to_json(nlohmann::json& j, const KillAllMessage& m) {
 
 void from_json(const nlohmann::json& j, KillAllMessage& m) {
     validateMessage(j, KillAllMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, KillAllMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 }
 
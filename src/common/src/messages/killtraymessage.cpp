@@ -48,6 +48,10 @@ void to_json(nlohmann::json& j, const KillTrayMessage& m) {
 
 void from_json(const nlohmann::json& j, KillTrayMessage& m) {
     validateMessage(j, KillTrayMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, KillTrayMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 }
 
@@ -44,15 +44,16 @@ Message::Message(std::string type_)
 
 void validateMessage(const nlohmann::json& message, std::string_view expectedType) {
     // Sanity checks
-    const std::string type = message.at(Message::KeyType).get<std::string>();
+    const std::string& type = message.at(Message::KeyType).get_ref<const std::string&>();
     if (type != expectedType) {
         throw std::logic_error(std::format(
             "Validation failed. Expected type '{}', got '{}'", expectedType, type
         ));
     }
 
-    const ApiVersion version = message.at(Message::KeyVersion).get<ApiVersion>();
-    if (version[0] != api::MajorVersion) {
+    const nlohmann::json& versionEntry = message.at(Message::KeyVersion);
+    if (versionEntry.at(0).get<int>() != api::MajorVersion) {
+        const ApiVersion version = versionEntry.get<ApiVersion>();
         throw std::runtime_error(std::format(
             "Mismatching version number. Expected {} got {}.{}.{}",
             api::MajorVersion, version[0], version[1], version[2]
@@ -40,45 +40,60 @@ namespace {
     constexpr std::string_view KeyIdentifier = "processId";
     constexpr std::string_view KeyMessage = "message";
     constexpr std::string_view KeyOutputType = "outputType";
+    constexpr std::string_view KeyOffset = "offset";
 } // namespace
 
 namespace common {
 
+std::string_view toString(ProcessOutputMessage::OutputType type) {
+    switch (type) {
+        case ProcessOutputMessage::OutputType::StdOut: return "stdout";
+        case ProcessOutputMessage::OutputType::StdErr: return "stderr";
+    }
+    throw std::logic_error("Missing case label");
+}
+
+ProcessOutputMessage::OutputType outputTypeFromString(std::string_view type) {
+    if (type == "stdout") {
+        return ProcessOutputMessage::OutputType::StdOut;
+    }
+    else if (type == "stderr") {
+        return ProcessOutputMessage::OutputType::StdErr;
+    }
+    else {
+        throw std::runtime_error(std::format("Unknown output type '{}'", type));
+    }
+}
+
 ProcessOutputMessage::ProcessOutputMessage()
     : Message(std::string(ProcessOutputMessage::Type))
 {}
 
 void to_json(nlohmann::json& j, const ProcessOutputMessage& m) {
-    std::string t = [](ProcessOutputMessage::OutputType type) {
-        switch (type) {
-            case ProcessOutputMessage::OutputType::StdOut: return "stdout";
-            case ProcessOutputMessage::OutputType::StdErr: return "stderr";
-        }
-        throw std::logic_error("Missing case label");
-    }(m.outputType);
-
     j[Message::KeyType] = ProcessOutputMessage::Type;
     j[Message::KeyVersion] = { api::MajorVersion, api::MinorVersion, api::PatchVersion };
     j[KeyIdentifier] = m.processId;
     j[KeyMessage] = m.message;
-    j[KeyOutputType] = std::move(t);
+    j[KeyOutputType] = toString(m.outputType);
+    if (m.offset.has_value()) {
+        j[KeyOffset] = *m.offset;
+    }
 }
 
 void from_json(const nlohmann::json& j, ProcessOutputMessage& m) {
     validateMessage(j, ProcessOutputMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, ProcessOutputMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 
     j.at(KeyIdentifier).get_to(m.processId);
     j.at(KeyMessage).get_to(m.message);
-    std::string type = j.at(KeyOutputType).get<std::string>();
-    if (type == "stdout") {
-        m.outputType = ProcessOutputMessage::OutputType::StdOut;
-    }
-    else if (type == "stderr") {
-        m.outputType = ProcessOutputMessage::OutputType::StdErr;
-    }
-    else {
-        throw std::runtime_error(std::format("Unknown output type '{}'", type));
+    const std::string& type = j.at(KeyOutputType).get_ref<const std::string&>();
+    m.outputType = outputTypeFromString(type);
+    if (auto it = j.find(KeyOffset);  it != j.end()) {
+        m.offset = it->get<std::uint64_t>();
     }
 }
 
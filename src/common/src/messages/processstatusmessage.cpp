@@ -37,59 +37,62 @@
 namespace {
     constexpr std::string_view KeyProcessId = "processId";
     constexpr std::string_view KeyStatus = "status";
+} // namespace
 
-    constexpr std::string_view fromStatus(common::ProcessStatusMessage::Status status) {
-        using PSM = common::ProcessStatusMessage;
-        switch (status) {
-            case PSM::Status::Unknown:       return "Unknown";
-            case PSM::Status::Starting:      return "Starting";
-            case PSM::Status::Running:       return "Running";
-            case PSM::Status::NormalExit:    return "NormalExit";
-            case PSM::Status::CrashExit:     return "CrashExit";
-            case PSM::Status::FailedToStart: return "FailedToStart";
-            case PSM::Status::TimedOut:      return "TimedOut";
-            case PSM::Status::WriteError:    return "WriteError";
-            case PSM::Status::ReadError:     return "ReadError";
-            case PSM::Status::UnknownError:  return "UnknownError";
-        }
-        throw std::logic_error("Unhandled case label");
-    }
+namespace common {
 
-    constexpr common::ProcessStatusMessage::Status toStatus(std::string_view status) {
-        if (status == "Unknown") {
-            return common::ProcessStatusMessage::Status::Unknown;
-        }
-        else if (status == "Starting") {
-            return common::ProcessStatusMessage::Status::Starting;
-        }
-        else if (status == "Running") {
-            return common::ProcessStatusMessage::Status::Running;
-        }
-        else if (status == "NormalExit") {
-            return common::ProcessStatusMessage::Status::NormalExit;
-        }
-        else if (status == "CrashExit") {
-            return common::ProcessStatusMessage::Status::CrashExit;
-        }
-        else if (status == "FailedToStart") {
-            return common::ProcessStatusMessage::Status::FailedToStart;
-        }
-        else if (status == "TimedOut") {
-            return common::ProcessStatusMessage::Status::TimedOut;
-        }
-        else if (status == "WriteError") {
-            return common::ProcessStatusMessage::Status::WriteError;
-        }
-        else if (status == "ReadError") {
-            return common::ProcessStatusMessage::Status::ReadError;
-        }
-        else {
-            throw std::runtime_error("Unknown status");
-        }
+std::string_view toString(ProcessStatusMessage::Status status) {
+    using PSM = ProcessStatusMessage;
+    switch (status) {
+        case PSM::Status::Unknown:       return "Unknown";
+        case PSM::Status::Starting:      return "Starting";
+        case PSM::Status::Running:       return "Running";
+        case PSM::Status::NormalExit:    return "NormalExit";
+        case PSM::Status::CrashExit:     return "CrashExit";
+        case PSM::Status::FailedToStart: return "FailedToStart";
+        case PSM::Status::TimedOut:      return "TimedOut";
+        case PSM::Status::WriteError:    return "WriteError";
+        case PSM::Status::ReadError:     return "ReadError";
+        case PSM::Status::UnknownError:  return "UnknownError";
     }
-} // namespace
+    throw std::logic_error("Unhandled case label");
+}
 
-namespace common {
+ProcessStatusMessage::Status statusFromString(std::string_view status) {
+    if (status == "Unknown") {
+        return ProcessStatusMessage::Status::Unknown;
+    }
+    else if (status == "Starting") {
+        return ProcessStatusMessage::Status::Starting;
+    }
+    else if (status == "Running") {
+        return ProcessStatusMessage::Status::Running;
+    }
+    else if (status == "NormalExit") {
+        return ProcessStatusMessage::Status::NormalExit;
+    }
+    else if (status == "CrashExit") {
+        return ProcessStatusMessage::Status::CrashExit;
+    }
+    else if (status == "FailedToStart") {
+        return ProcessStatusMessage::Status::FailedToStart;
+    }
+    else if (status == "TimedOut") {
+        return ProcessStatusMessage::Status::TimedOut;
+    }
+    else if (status == "WriteError") {
+        return ProcessStatusMessage::Status::WriteError;
+    }
+    else if (status == "ReadError") {
+        return ProcessStatusMessage::Status::ReadError;
+    }
+    else if (status == "UnknownError") {
+        return ProcessStatusMessage::Status::UnknownError;
+    }
+    else {
+        throw std::runtime_error(std::format("Unknown status '{}'", status));
+    }
+}
 
 ProcessStatusMessage::ProcessStatusMessage()
     : Message(std::string(ProcessStatusMessage::Type))
@@ -99,16 +102,19 @@ void to_json(nlohmann::json& j, const ProcessStatusMessage& m) {
     j[Message::KeyType] = ProcessStatusMessage::Type;
     j[Message::KeyVersion] = { api::MajorVersion, api::MinorVersion, api::PatchVersion };
     j[KeyProcessId] = m.processId;
-    j[KeyStatus] = fromStatus(m.status);
+    j[KeyStatus] = toString(m.status);
 }
 
 void from_json(const nlohmann::json& j, ProcessStatusMessage& m) {
     validateMessage(j, ProcessStatusMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, ProcessStatusMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 
     j.at(KeyProcessId).get_to(m.processId);
-    std::string status = j.at(KeyStatus).get<std::string>();
-    m.status = toStatus(status);
+    m.status = statusFromString(j.at(KeyStatus).get_ref<const std::string&>());
 }
 
 } // namespace common
@@ -48,6 +48,10 @@ void to_json(nlohmann::json& j, const RestartNodeMessage& m) {
 
 void from_json(const nlohmann::json& j, RestartNodeMessage& m) {
     validateMessage(j, RestartNodeMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, RestartNodeMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 }
 
@@ -48,6 +48,10 @@ void to_json(nlohmann::json& j, const ShutdownNodeMessage& m) {
 
 void from_json(const nlohmann::json& j, ShutdownNodeMessage& m) {
     validateMessage(j, ShutdownNodeMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, ShutdownNodeMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 }
 
@@ -37,6 +37,8 @@
 namespace {
     constexpr std::string_view KeyId = "id";
     constexpr std::string_view KeyForwardOutErr = "forwardOutErr";
+    constexpr std::string_view KeyOutputPolicy = "outputPolicy";
+    constexpr std::string_view KeyOutputOnDemand = "outputOnDemand";
     constexpr std::string_view KeyAutoRestart = "autorestart";
     constexpr std::string_view KeyExecutable = "executable";
     constexpr std::string_view KeyWorkingDirectory = "workingDirectory";
@@ -47,6 +49,9 @@ namespace {
     constexpr std::string_view KeyClusterId = "clusterId";
     constexpr std::string_view KeyNodeId = "nodeId";
     constexpr std::string_view KeyDataHash = "datahash";
+    constexpr std::string_view KeyProgramHash = "programHash";
+    constexpr std::string_view KeyClusterHash = "clusterHash";
+    constexpr std::string_view KeyNodeHash = "nodeHash";
 } // namespace
 
 namespace common {
@@ -63,6 +68,12 @@ void to_json(nlohmann::json& j, const StartCommandMessage& m) {
     if (m.forwardStdOutStdErr) {
         j[KeyForwardOutErr] = m.forwardStdOutStdErr;
     }
+    if (m.outputPolicy != StartCommandMessage().outputPolicy) {
+        j[KeyOutputPolicy] = toString(m.outputPolicy);
+    }
+    if (m.outputOnDemand) {
+        j[KeyOutputOnDemand] = m.outputOnDemand;
+    }
     if (m.autoRestart) {
         j[KeyAutoRestart] = m.autoRestart;
     }
@@ -76,16 +87,35 @@ void to_json(nlohmann::json& j, const StartCommandMessage& m) {
     j[KeyClusterId] = m.clusterId;
     j[KeyNodeId] = m.nodeId;
     j[KeyDataHash] = m.dataHash;
+    if (m.programHash != 0) {
+        j[KeyProgramHash] = m.programHash;
+    }
+    if (m.clusterHash != 0) {
+        j[KeyClusterHash] = m.clusterHash;
+    }
+    if (m.nodeHash != 0) {
+        j[KeyNodeHash] = m.nodeHash;
+    }
 }
 
 void from_json(const nlohmann::json& j, StartCommandMessage& m) {
     validateMessage(j, StartCommandMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, StartCommandMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 
     j.at(KeyId).get_to(m.id);
     if (auto it = j.find(KeyForwardOutErr);  it != j.end()) {
         it->get_to(m.forwardStdOutStdErr);
     }
+    if (auto it = j.find(KeyOutputPolicy);  it != j.end()) {
+        m.outputPolicy = outputPolicyFromString(it->get<std::string>());
+    }
+    if (auto it = j.find(KeyOutputOnDemand);  it != j.end()) {
+        it->get_to(m.outputOnDemand);
+    }
     if (auto it = j.find(KeyAutoRestart);  it != j.end()) {
         it->get_to(m.autoRestart);
     }
@@ -102,6 +132,15 @@ void from_json(const nlohmann::json& j, StartCommandMessage& m) {
     j.at(KeyClusterId).get_to(m.clusterId);
     j.at(KeyNodeId).get_to(m.nodeId);
     j.at(KeyDataHash).get_to(m.dataHash);
+    if (auto it = j.find(KeyProgramHash);  it != j.end()) {
+        it->get_to(m.programHash);
+    }
+    if (auto it = j.find(KeyClusterHash);  it != j.end()) {
+        it->get_to(m.clusterHash);
+    }
+    if (auto it = j.find(KeyNodeHash);  it != j.end()) {
+        it->get_to(m.nodeHash);
+    }
 }
 
 } // namespace common
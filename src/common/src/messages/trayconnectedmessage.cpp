@@ -34,20 +34,55 @@
 
 #include "messages/trayconnectedmessage.h"
 
+namespace {
+    constexpr std::string_view KeyEncodings = "encodings";
+    constexpr std::string_view KeyCompressions = "compressions";
+    constexpr std::string_view KeyOutputCredits = "outputCredits";
+    constexpr std::string_view KeyHeartbeat = "heartbeat";
+} // namespace
+
 namespace common {
 
 TrayConnectedMessage::TrayConnectedMessage()
     : Message(std::string(TrayConnectedMessage::Type))
 {}
 
-void to_json(nlohmann::json& j, const TrayConnectedMessage&) {
+void to_json(nlohmann::json& j, const TrayConnectedMessage& m) {
     j[Message::KeyType] = TrayConnectedMessage::Type;
     j[Message::KeyVersion] = { api::MajorVersion, api::MinorVersion, api::PatchVersion };
+    if (!m.encodings.empty()) {
+        j[KeyEncodings] = m.encodings;
+    }
+    if (!m.compressions.empty()) {
+        j[KeyCompressions] = m.compressions;
+    }
+    if (m.supportsOutputCredits) {
+        j[KeyOutputCredits] = m.supportsOutputCredits;
+    }
+    if (m.supportsHeartbeat) {
+        j[KeyHeartbeat] = m.supportsHeartbeat;
+    }
 }
 
 void from_json(const nlohmann::json& j, TrayConnectedMessage& m) {
     validateMessage(j, TrayConnectedMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, TrayConnectedMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
+    if (auto it = j.find(KeyEncodings);  it != j.end()) {
+        it->get_to(m.encodings);
+    }
+    if (auto it = j.find(KeyCompressions);  it != j.end()) {
+        it->get_to(m.compressions);
+    }
+    if (auto it = j.find(KeyOutputCredits);  it != j.end()) {
+        it->get_to(m.supportsOutputCredits);
+    }
+    if (auto it = j.find(KeyHeartbeat);  it != j.end()) {
+        it->get_to(m.supportsHeartbeat);
+    }
 }
 
 } // namespace common
@@ -43,6 +43,9 @@ namespace {
     constexpr std::string_view KeyClusterId = "clusterId";
     constexpr std::string_view KeyNodeId = "nodeId";
     constexpr std::string_view KeyDataHash = "datahash";
+    constexpr std::string_view KeyProgramHash = "programHash";
+    constexpr std::string_view KeyClusterHash = "clusterHash";
+    constexpr std::string_view KeyNodeHash = "nodeHash";
 } // namespace
 
 namespace common {
@@ -58,6 +61,15 @@ static void to_json(nlohmann::json& j, const TrayStatusMessage::ProcessInfo& p)
     j[KeyClusterId] = p.clusterId;
     j[KeyNodeId] = p.nodeId;
     j[KeyDataHash] = p.dataHash;
+    if (p.programHash != 0) {
+        j[KeyProgramHash] = p.programHash;
+    }
+    if (p.clusterHash != 0) {
+        j[KeyClusterHash] = p.clusterHash;
+    }
+    if (p.nodeHash != 0) {
+        j[KeyNodeHash] = p.nodeHash;
+    }
 }
 
 static void from_json(const nlohmann::json & j, TrayStatusMessage::ProcessInfo& p) {
@@ -67,6 +79,15 @@ static void from_json(const nlohmann::json & j, TrayStatusMessage::ProcessInfo&
     j.at(KeyClusterId).get_to(p.clusterId);
     j.at(KeyNodeId).get_to(p.nodeId);
     j.at(KeyDataHash).get_to(p.dataHash);
+    if (auto it = j.find(KeyProgramHash);  it != j.end()) {
+        it->get_to(p.programHash);
+    }
+    if (auto it = j.find(KeyClusterHash);  it != j.end()) {
+        it->get_to(p.clusterHash);
+    }
+    if (auto it = j.find(KeyNodeHash);  it != j.end()) {
+        it->get_to(p.nodeHash);
+    }
 }
 
 void to_json(nlohmann::json& j, const TrayStatusMessage& m) {
@@ -77,6 +98,10 @@ void to_json(nlohmann::json& j, const TrayStatusMessage& m) {
 
 void from_json(const nlohmann::json& j, TrayStatusMessage& m) {
     validateMessage(j, TrayStatusMessage::Type);
+    from_json(j, m, SkipValidation());
+}
+
+void from_json(const nlohmann::json& j, TrayStatusMessage& m, SkipValidation) {
     from_json(j, static_cast<Message&>(m));
 
     j.at(KeyProcesses).get_to(m.processes);
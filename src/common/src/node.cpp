@@ -73,10 +73,13 @@ void to_json(nlohmann::json& j, const Node& n) {
     }
 }
 
-std::pair<std::vector<Node>, bool> loadNodesFromDirectory(std::string_view directory) {
+std::pair<std::vector<Node>, bool> loadNodesFromDirectory(std::string_view directory,
+                                                       common::JsonFileCache<Node>* cache)
+{
     std::pair<std::vector<Node>, bool> res = common::loadJsonFromDirectory<Node>(
         directory,
-        validation::loadValidator(":/schema/config/node.schema.json")
+        &validation::sharedValidator(":/schema/config/node.schema.json"),
+        cache
     );
 
     std::vector<Node> nodes = res.first;
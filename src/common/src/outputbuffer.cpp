@@ -0,0 +1,173 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "outputbuffer.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace {
+    std::size_t countLines(std::string_view text) {
+        return static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+    }
+} // namespace
+
+namespace common {
+
+OutputBuffer::OutputBuffer()
+    : OutputBuffer(Limits())
+{}
+
+OutputBuffer::OutputBuffer(Limits limits)
+    : _limits(limits)
+{
+    assert(_limits.maxBytes > 0);
+    assert(_limits.maxLines > 0);
+}
+
+void OutputBuffer::append(std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+
+    Chunk chunk;
+    chunk.text = std::string(text);
+    chunk.nLines = countLines(text);
+    _nBytes += chunk.text.size();
+    _nLines += chunk.nLines;
+    _chunks.push_back(std::move(chunk));
+    trim();
+}
+
+std::string OutputBuffer::text(std::uint64_t offset) const {
+    offset = std::max(offset, _beginOffset);
+    if (offset >= endOffset()) {
+        return "";
+    }
+
+    // Usually only the last few chunks are requested, so we search from the back
+    std::uint64_t chunkOffset = endOffset();
+    auto it = _chunks.end();
+    while (chunkOffset > offset) {
+        --it;
+        chunkOffset -= it->text.size();
+    }
+
+    std::string res;
+    res.reserve(static_cast<std::size_t>(endOffset() - offset));
+    res.append(it->text, static_cast<std::size_t>(offset - chunkOffset));
+    for (++it; it != _chunks.end(); ++it) {
+        res.append(it->text);
+    }
+    return res;
+}
+
+std::uint64_t OutputBuffer::beginOffset() const {
+    return _beginOffset;
+}
+
+std::uint64_t OutputBuffer::endOffset() const {
+    return _beginOffset + _nBytes;
+}
+
+std::size_t OutputBuffer::size() const {
+    return _nBytes;
+}
+
+std::size_t OutputBuffer::lineCount() const {
+    return _nLines;
+}
+
+void OutputBuffer::setLimits(Limits limits) {
+    assert(limits.maxBytes > 0);
+    assert(limits.maxLines > 0);
+    _limits = limits;
+    trim();
+}
+
+const OutputBuffer::Limits& OutputBuffer::limits() const {
+    return _limits;
+}
+
+void OutputBuffer::clear() {
+    _beginOffset += _nBytes;
+    _chunks.clear();
+    _nBytes = 0;
+    _nLines = 0;
+}
+
+void OutputBuffer::trim() {
+    auto isOverLimit = [this]() {
+        return _nBytes > _limits.maxBytes || _nLines > _limits.maxLines;
+    };
+
+    // First remove entire chunks, but always keep the newest one
+    while (isOverLimit() && _chunks.size() > 1) {
+        const Chunk& front = _chunks.front();
+        _beginOffset += front.text.size();
+        _nBytes -= front.text.size();
+        _nLines -= front.nLines;
+        _chunks.pop_front();
+    }
+
+    if (!isOverLimit()) {
+        return;
+    }
+
+    // The newest chunk on its own is too large, so we keep only its end
+    Chunk& chunk = _chunks.front();
+    std::size_t cut = 0;
+    if (_nBytes > _limits.maxBytes) {
+        cut = _nBytes - _limits.maxBytes;
+    }
+    if (_nLines > _limits.maxLines) {
+        // Skip past the newline characters of all lines that have to go
+        std::size_t nSkipped = 0;
+        std::size_t pos = 0;
+        while (nSkipped < _nLines - _limits.maxLines) {
+            pos = chunk.text.find('\n', pos) + 1;
+            nSkipped++;
+        }
+        cut = std::max(cut, pos);
+    }
+
+    const std::string_view removed = std::string_view(chunk.text).substr(0, cut);
+    chunk.nLines -= countLines(removed);
+    chunk.text.erase(0, cut);
+    _beginOffset += cut;
+    _nBytes = chunk.text.size();
+    _nLines = chunk.nLines;
+}
+
+} // namespace common
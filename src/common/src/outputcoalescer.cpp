@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "outputcoalescer.h"
+
+#include <assert.h>
+#include <format>
+
+namespace common {
+
+OutputRateLimit::OutputRateLimit(std::size_t maxBytesPerSecond)
+    : _maxBytesPerSecond(maxBytesPerSecond)
+{}
+
+bool OutputRateLimit::accept(std::size_t nBytes, Clock::time_point now) {
+    if (_maxBytesPerSecond == 0) {
+        return true;
+    }
+
+    if (now - _windowStart >= std::chrono::seconds(1)) {
+        _windowStart = now;
+        _windowBytes = 0;
+    }
+
+    // We accept or drop whole chunks so that the output that does get through is not cut
+    // at arbitrary places. This means the limit can be exceeded by one chunk
+    if (_windowBytes >= _maxBytesPerSecond) {
+        return false;
+    }
+    _windowBytes += nBytes;
+    return true;
+}
+
+OutputCoalescer::OutputCoalescer()
+    : OutputCoalescer(Options())
+{}
+
+OutputCoalescer::OutputCoalescer(Options options)
+    : _options(options)
+    , _rateLimit(options.maxBytesPerSecond)
+{
+    assert(_options.interval.count() >= 0);
+    assert(_options.flushSize > 0);
+}
+
+bool OutputCoalescer::append(std::string_view text, Clock::time_point now) {
+    return append(text, now, _rateLimit);
+}
+
+bool OutputCoalescer::append(std::string_view text, Clock::time_point now,
+                             OutputRateLimit& rateLimit)
+{
+    if (text.empty()) {
+        return false;
+    }
+
+    if (!rateLimit.accept(text.size(), now)) {
+        if (!hasPending()) {
+            _firstPending = now;
+        }
+        _nDropped += text.size();
+        _nTotalDropped += text.size();
+        return false;
+    }
+
+    if (!hasPending()) {
+        _firstPending = now;
+    }
+    _pending.append(text);
+    return _pending.size() >= _options.flushSize;
+}
+
+bool OutputCoalescer::hasPending() const {
+    return !_pending.empty() || _nDropped > 0;
+}
+
+OutputCoalescer::Clock::time_point OutputCoalescer::deadline() const {
+    return _firstPending + _options.interval;
+}
+
+std::string OutputCoalescer::take() {
+    std::string res = std::move(_pending);
+    _pending.clear();
+
+    if (_nDropped > 0) {
+        if (!res.empty() && res.back() != '\n') {
+            res.push_back('\n');
+        }
+        res += std::format("[{} bytes dropped]\n", _nDropped);
+        _nDropped = 0;
+    }
+    return res;
+}
+
+std::uint64_t OutputCoalescer::totalDropped() const {
+    return _nTotalDropped;
+}
+
+} // namespace common
@@ -0,0 +1,270 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "outputflowcontrol.h"
+
+#include <assert.h>
+#include <format>
+#include <stdexcept>
+
+namespace {
+    constexpr std::string_view KeepHead = "keepHead";
+    constexpr std::string_view KeepTail = "keepTail";
+    constexpr std::string_view Sample = "sample";
+} // namespace
+
+namespace common {
+
+std::string_view toString(OutputPolicy policy) {
+    switch (policy) {
+        case OutputPolicy::KeepHead: return KeepHead;
+        case OutputPolicy::KeepTail: return KeepTail;
+        case OutputPolicy::Sample:   return Sample;
+    }
+    throw std::logic_error("Missing case label");
+}
+
+OutputPolicy outputPolicyFromString(std::string_view policy) {
+    if (policy == KeepHead) {
+        return OutputPolicy::KeepHead;
+    }
+    else if (policy == KeepTail) {
+        return OutputPolicy::KeepTail;
+    }
+    else if (policy == Sample) {
+        return OutputPolicy::Sample;
+    }
+    else {
+        throw std::runtime_error(std::format("Unknown output policy '{}'", policy));
+    }
+}
+
+SharedOutput::SharedOutput(ProcessOutputMessage msg)
+    : message(std::move(msg))
+{}
+
+OutputFlowControl::OutputFlowControl(std::size_t maxQueuedBytes)
+    : _maxQueuedBytes(maxQueuedBytes)
+{
+    assert(_maxQueuedBytes > 0);
+}
+
+std::vector<SharedOutputPtr> OutputFlowControl::push(SharedOutputPtr output,
+                                                     OutputPolicy policy)
+{
+    assert(output);
+    std::vector<SharedOutputPtr> result;
+    if (output->message.message.empty()) {
+        return result;
+    }
+
+    // The output of a process has to stay in order, so it can only bypass the queue if
+    // nothing of the same process is waiting
+    auto it = _queues.find(output->message.processId);
+    if (!_isPaused && _credits > 0 && it == _queues.end()) {
+        send(std::move(output), result);
+        return result;
+    }
+
+    if (it == _queues.end()) {
+        it = _queues.emplace(output->message.processId, Queue()).first;
+    }
+    it->second.policy = policy;
+    enqueue(it->second, std::move(output));
+    return result;
+}
+
+std::vector<SharedOutputPtr> OutputFlowControl::grant(std::uint64_t credits) {
+    _credits += static_cast<std::int64_t>(credits);
+    return release();
+}
+
+std::vector<SharedOutputPtr> OutputFlowControl::setPaused(bool isPaused) {
+    _isPaused = isPaused;
+    return release();
+}
+
+bool OutputFlowControl::isPaused() const {
+    return _isPaused;
+}
+
+std::vector<SharedOutputPtr> OutputFlowControl::release() {
+    std::vector<SharedOutputPtr> result;
+    if (_isPaused) {
+        return result;
+    }
+
+    bool hasProgress = true;
+    while (_credits > 0 && hasProgress) {
+        hasProgress = false;
+        for (auto& [processId, queue] : _queues) {
+            if (_credits <= 0) {
+                break;
+            }
+
+            // When the newest output is kept, the gap is in front of the queued output
+            if (queue.policy == OutputPolicy::KeepTail || queue.messages.empty()) {
+                appendDroppedMarkers(queue, processId, result);
+            }
+            if (queue.messages.empty()) {
+                continue;
+            }
+
+            SharedOutputPtr output = std::move(queue.messages.front());
+            queue.messages.pop_front();
+            queue.nBytes -= output->message.message.size();
+            _nQueuedBytes -= output->message.message.size();
+            send(std::move(output), result);
+            hasProgress = true;
+
+            if (queue.messages.empty()) {
+                appendDroppedMarkers(queue, processId, result);
+            }
+        }
+    }
+
+    std::erase_if(
+        _queues,
+        [](const std::pair<const int, Queue>& p) {
+            return p.second.messages.empty() &&
+                p.second.nDropped[0] == 0 && p.second.nDropped[1] == 0;
+        }
+    );
+    return result;
+}
+
+std::int64_t OutputFlowControl::credits() const {
+    return _credits;
+}
+
+std::size_t OutputFlowControl::queuedBytes() const {
+    return _nQueuedBytes;
+}
+
+std::uint64_t OutputFlowControl::totalDropped() const {
+    return _nTotalDropped;
+}
+
+void OutputFlowControl::enqueue(Queue& queue, SharedOutputPtr output) {
+    const std::size_t size = output->message.message.size();
+    switch (queue.policy) {
+        case OutputPolicy::KeepHead:
+            if (!queue.messages.empty() && queue.nBytes + size > _maxQueuedBytes) {
+                drop(queue, output->message);
+                return;
+            }
+            break;
+        case OutputPolicy::KeepTail:
+            break;
+        case OutputPolicy::Sample:
+            queue.sampleCounter++;
+            if (queue.sampleCounter % queue.sampleStride != 0) {
+                drop(queue, output->message);
+                return;
+            }
+            break;
+    }
+
+    queue.nBytes += size;
+    _nQueuedBytes += size;
+    queue.messages.push_back(std::move(output));
+
+    if (queue.nBytes <= _maxQueuedBytes || queue.messages.size() == 1) {
+        return;
+    }
+
+    if (queue.policy == OutputPolicy::KeepTail) {
+        while (queue.nBytes > _maxQueuedBytes && queue.messages.size() > 1) {
+            const ProcessOutputMessage& front = queue.messages.front()->message;
+            drop(queue, front);
+            queue.nBytes -= front.message.size();
+            _nQueuedBytes -= front.message.size();
+            queue.messages.pop_front();
+        }
+    }
+    else if (queue.policy == OutputPolicy::Sample) {
+        // Thin out the queue by discarding every other message and only accept half as
+        // many new messages from here on, which keeps the sample evenly spaced
+        std::deque<SharedOutputPtr> kept;
+        for (std::size_t i = 0; i < queue.messages.size(); i++) {
+            SharedOutputPtr& m = queue.messages[i];
+            if (i % 2 == 0) {
+                kept.push_back(std::move(m));
+            }
+            else {
+                drop(queue, m->message);
+                queue.nBytes -= m->message.message.size();
+                _nQueuedBytes -= m->message.message.size();
+            }
+        }
+        queue.messages = std::move(kept);
+        queue.sampleStride *= 2;
+    }
+}
+
+void OutputFlowControl::drop(Queue& queue, const ProcessOutputMessage& message) {
+    const std::size_t size = message.message.size();
+    queue.nDropped[static_cast<int>(message.outputType)] += size;
+    _nTotalDropped += size;
+}
+
+void OutputFlowControl::appendDroppedMarkers(Queue& queue, int processId,
+                                             std::vector<SharedOutputPtr>& result)
+{
+    using OutputType = ProcessOutputMessage::OutputType;
+    for (OutputType type : { OutputType::StdOut, OutputType::StdErr }) {
+        std::uint64_t& nDropped = queue.nDropped[static_cast<int>(type)];
+        if (nDropped == 0) {
+            continue;
+        }
+
+        // The markers are sent even if the credits are used up, but they are paid for
+        // like any other output as the receiver grants the credits back for them, too
+        ProcessOutputMessage marker;
+        marker.processId = processId;
+        marker.outputType = type;
+        marker.message = std::format("[{} bytes dropped]\n", nDropped);
+        send(std::make_shared<SharedOutput>(std::move(marker)), result);
+        nDropped = 0;
+    }
+}
+
+void OutputFlowControl::send(SharedOutputPtr output,
+                             std::vector<SharedOutputPtr>& result)
+{
+    _credits -= static_cast<std::int64_t>(output->message.message.size());
+    result.push_back(std::move(output));
+}
+
+} // namespace common
@@ -48,6 +48,8 @@ namespace {
     constexpr std::string_view KeyTags = "tags";
     constexpr std::string_view KeyDescription = "description";
     constexpr std::string_view KeyForwardMessages = "shouldForwardMessages";
+    constexpr std::string_view KeyOutputPolicy = "outputPolicy";
+    constexpr std::string_view KeyOutputOnDemand = "outputOnDemand";
     constexpr std::string_view KeyAutoRestart = "shouldAutorestart";
     constexpr std::string_view KeyEnabled = "enabled";
     constexpr std::string_view KeyDelay = "delay";
@@ -112,6 +114,12 @@ void from_json(const nlohmann::json& j, Program& p) {
     if (auto it = j.find(KeyForwardMessages);  it != j.end()) {
         it->get_to(p.shouldForwardMessages);
     }
+    if (auto it = j.find(KeyOutputPolicy);  it != j.end()) {
+        p.outputPolicy = common::outputPolicyFromString(it->get<std::string>());
+    }
+    if (auto it = j.find(KeyOutputOnDemand);  it != j.end()) {
+        it->get_to(p.outputOnDemand);
+    }
     if (auto it = j.find(KeyAutoRestart);  it != j.end()) {
         it->get_to(p.shouldAutoRestart);
     }
@@ -168,6 +176,12 @@ void to_json(nlohmann::json& j, const Program& p) {
     if (p.shouldForwardMessages != Program().shouldForwardMessages) {
         j[KeyForwardMessages] = p.shouldForwardMessages;
     }
+    if (p.outputPolicy != Program().outputPolicy) {
+        j[KeyOutputPolicy] = common::toString(p.outputPolicy);
+    }
+    if (p.outputOnDemand != Program().outputOnDemand) {
+        j[KeyOutputOnDemand] = p.outputOnDemand;
+    }
     if (p.shouldAutoRestart != Program().shouldAutoRestart) {
         j[KeyAutoRestart] = p.shouldAutoRestart;
     }
@@ -185,11 +199,13 @@ void to_json(nlohmann::json& j, const Program& p) {
 }
 
 std::pair<std::vector<Program>, bool> loadProgramsFromDirectory(
-                                                               std::string_view directory)
+                                                               std::string_view directory,
+                                                    common::JsonFileCache<Program>* cache)
 {
     std::pair<std::vector<Program>, bool> res = common::loadJsonFromDirectory<Program>(
         directory,
-        validation::loadValidator(":/schema/config/program.schema.json")
+        &validation::sharedValidator(":/schema/config/program.schema.json"),
+        cache
     );
 
     // Inject the unique identifiers into the nodes
@@ -0,0 +1,199 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "reconnectscheduler.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace common {
+
+ReconnectScheduler::ReconnectScheduler()
+    : ReconnectScheduler(Options())
+{}
+
+ReconnectScheduler::ReconnectScheduler(Options options, std::uint64_t seed)
+    : _options(options)
+    , _random(seed)
+{
+    assert(_options.initialDelay.count() > 0);
+    assert(_options.maxDelay >= _options.initialDelay);
+    assert(_options.maxConcurrentDials > 0);
+}
+
+void ReconnectScheduler::add(int id, Clock::time_point now) {
+    assert(!_connections.contains(id));
+    _connections[id] = { .state = State::Waiting, .time = now };
+}
+
+void ReconnectScheduler::remove(int id) {
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return;
+    }
+
+    if (it->second.state == State::Dialing) {
+        _nDialing--;
+    }
+    _connections.erase(it);
+}
+
+void ReconnectScheduler::setConnected(int id) {
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return;
+    }
+
+    if (it->second.state == State::Dialing) {
+        _nDialing--;
+    }
+    if (it->second.state != State::Established) {
+        it->second.state = State::Connected;
+    }
+}
+
+void ReconnectScheduler::setEstablished(int id) {
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return;
+    }
+
+    if (it->second.state == State::Dialing) {
+        _nDialing--;
+    }
+    it->second.state = State::Established;
+    it->second.nFailures = 0;
+}
+
+void ReconnectScheduler::setDisconnected(int id, Clock::time_point now) {
+    const auto it = _connections.find(id);
+    if (it == _connections.end()) {
+        return;
+    }
+
+    Connection& c = it->second;
+    if (c.state == State::Waiting) {
+        return;
+    }
+    if (c.state == State::Dialing) {
+        _nDialing--;
+    }
+    if (c.state != State::Established) {
+        // A connection that is lost before the handshake counts as a failed attempt
+        c.nFailures++;
+    }
+    c.state = State::Waiting;
+    c.time = now + delay(c.nFailures);
+}
+
+ReconnectScheduler::Actions ReconnectScheduler::update(Clock::time_point now) {
+    Actions actions;
+
+    std::vector<std::pair<Clock::time_point, int>> due;
+    for (auto& [id, c] : _connections) {
+        if (c.state == State::Dialing && c.time <= now) {
+            // The attempt took too long and is counted as a failure
+            actions.abort.push_back(id);
+            _nDialing--;
+            c.nFailures++;
+            c.state = State::Waiting;
+            c.time = now + delay(c.nFailures);
+        }
+        else if (c.state == State::Waiting && c.time <= now) {
+            due.emplace_back(c.time, id);
+        }
+    }
+
+    // The connections that have been waiting the longest are dialed first
+    std::sort(due.begin(), due.end());
+    for (const auto& [time, id] : due) {
+        if (_nDialing >= _options.maxConcurrentDials) {
+            break;
+        }
+
+        Connection& c = _connections[id];
+        c.state = State::Dialing;
+        c.time = now + _options.dialTimeout;
+        _nDialing++;
+        actions.dial.push_back(id);
+    }
+
+    return actions;
+}
+
+std::optional<ReconnectScheduler::Clock::time_point>
+ReconnectScheduler::nextUpdate() const
+{
+    // Waiting connections don't need an update while all attempts are in use, as one of
+    // the attempts has to finish or time out first
+    const bool canDial = _nDialing < _options.maxConcurrentDials;
+
+    std::optional<Clock::time_point> res;
+    for (const auto& [id, c] : _connections) {
+        const bool needsUpdate =
+            c.state == State::Dialing || (c.state == State::Waiting && canDial);
+        if (needsUpdate && (!res.has_value() || c.time < *res)) {
+            res = c.time;
+        }
+    }
+    return res;
+}
+
+bool ReconnectScheduler::isDialing(int id) const {
+    const auto it = _connections.find(id);
+    return it != _connections.end() && it->second.state == State::Dialing;
+}
+
+std::size_t ReconnectScheduler::nDialing() const {
+    return _nDialing;
+}
+
+std::chrono::milliseconds ReconnectScheduler::delay(int nFailures) {
+    // Doubles with every failure, without overflowing for long outages
+    const int exponent = std::min(nFailures, 20);
+    const std::chrono::milliseconds base = std::min<std::chrono::milliseconds>(
+        _options.initialDelay * (1ll << exponent),
+        _options.maxDelay
+    );
+
+    // Equal jitter: at least half of the delay is kept so that attempts are never
+    // repeated right away, the other half is random
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> dist(
+        base.count() / 2,
+        base.count()
+    );
+    return std::chrono::milliseconds(dist(_random));
+}
+
+} // namespace common
@@ -36,12 +36,24 @@
 
 #include "database.h"
 #include "logging.h"
+#include "messagedecoder.h"
 #include "messages.h"
 #include "node.h"
+#include <QHostInfo>
 #include <QTimer>
 #include <assert.h>
+#include <algorithm>
+#include <type_traits>
+#include <variant>
 
 namespace {
+    /// The number of bytes of process output that each tray is allowed to send ahead of
+    /// what we have handled. New credits are granted once half of it has been handled
+    constexpr std::uint64_t OutputCreditWindow = 1024 * 1024;
+
+    /// The duration for which a resolved host name is used before it is looked up again
+    constexpr std::chrono::minutes HostLookupCacheDuration = std::chrono::minutes(5);
+
     constexpr std::string_view stateToString(QAbstractSocket::SocketState state) {
         switch (state) {
             case QAbstractSocket::SocketState::UnconnectedState: return "Unconnected";
@@ -56,6 +68,74 @@ namespace {
     }
 } // namespace
 
+ClusterConnectionHandler::ClusterConnectionHandler() {
+    _reconnectTimer = new QTimer(this);
+    _reconnectTimer->setSingleShot(true);
+    connect(
+        _reconnectTimer, &QTimer::timeout,
+        this, &ClusterConnectionHandler::updateConnections
+    );
+    _heartbeatTimer = new QTimer(this);
+    _heartbeatTimer->setSingleShot(true);
+    _heartbeatTimer->setTimerType(Qt::PreciseTimer);
+    connect(
+        _heartbeatTimer, &QTimer::timeout,
+        this, &ClusterConnectionHandler::updateHeartbeats
+    );
+
+    _dispatcher.on<common::ProcessStatusMessage>(
+        [this](common::ProcessStatusMessage message, Node::ID) {
+            emit receivedTrayProcess(std::move(message));
+        }
+    );
+    _dispatcher.on<common::TrayStatusMessage>(
+        [this](common::TrayStatusMessage message, Node::ID nodeId) {
+            emit receivedTrayStatus(nodeId, std::move(message));
+        }
+    );
+    _dispatcher.on<common::TrayConnectedMessage>(
+        [this](const common::TrayConnectedMessage& message, Node::ID nodeId) {
+            handleTrayConnected(message, nodeId);
+        }
+    );
+    _dispatcher.on<common::InvalidAuthMessage>(
+        [this](common::InvalidAuthMessage message, Node::ID nodeId) {
+            emit receivedInvalidAuthStatus(nodeId, std::move(message));
+        }
+    );
+    _dispatcher.on<common::ProcessOutputMessage>(
+        [this](common::ProcessOutputMessage message, Node::ID nodeId) {
+            const std::size_t size = message.message.size();
+            emit receivedProcessMessage(nodeId, std::move(message));
+            // Credits are only handed back once the output has been handled, so a busy
+            // user interface automatically slows down the trays
+            consumeOutputCredits(nodeId, size);
+        }
+    );
+    _dispatcher.on<common::PongMessage>(
+        [this](const common::PongMessage& message, Node::ID nodeId) {
+            handlePong(message, nodeId);
+        }
+    );
+    _dispatcher.on<common::ErrorOccurredMessage>(
+        [this](common::ErrorOccurredMessage message, Node::ID nodeId) {
+            emit receivedErrorMessage(nodeId, std::move(message));
+        }
+    );
+    _dispatcher.setFallback(
+        [](const nlohmann::json& message, Node::ID nodeId) {
+            const Node* n = data::findNode(nodeId);
+            assert(n);
+            std::vector<const Cluster*> clusters = data::findClusterForNode(*n);
+
+            for (const Cluster* c : clusters) {
+                assert(c);
+                Log(std::format("Received [{} / {}]", c->name, n->name), message.dump());
+            }
+        }
+    );
+}
+
 ClusterConnectionHandler::~ClusterConnectionHandler() {
     // We need to do the deletion this way since there will be messages pending for the
     // JsonSocket on the event queue (particuarly the signalling that the connection is
@@ -68,63 +148,311 @@ ClusterConnectionHandler::~ClusterConnectionHandler() {
     _sockets.clear();
 }
 
-void ClusterConnectionHandler::initialize() {
+void ClusterConnectionHandler::initialize(common::HeartbeatMonitor::Options heartbeat,
+                                          common::JsonSocket::Options socket)
+{
+    _heartbeats = common::HeartbeatMonitor(heartbeat);
+    _socketOptions = std::move(socket);
+
+    // The connections are dialed by the reconnect scheduler, which limits how many of
+    // them are attempted at the same time
     for (const Node* node : data::nodes()) {
-        // This handler keeps the sockets to the tray applications open
-        std::unique_ptr<QTcpSocket> socket = std::make_unique<QTcpSocket>();
+        addNode(*node);
+    }
+}
+
+void ClusterConnectionHandler::addNode(const Node& node) {
+    assert(!_sockets.contains(node.id));
 
-        connect(
-            socket.get(), &QAbstractSocket::stateChanged,
-            [this, id = node->id](QAbstractSocket::SocketState state) {
+    // This handler keeps the sockets to the tray applications open
+    std::unique_ptr<QTcpSocket> socket = std::make_unique<QTcpSocket>();
+    QTcpSocket* tcpSocket = socket.get();
+
+    std::unique_ptr<common::JsonSocket> jsonSocket =
+        std::make_unique<common::JsonSocket>(std::move(socket), node.secret);
+    common::JsonSocket* s = jsonSocket.get();
+    s->setOptions(_socketOptions);
+
+    connect(
+        tcpSocket, &QAbstractSocket::stateChanged,
+        this,
+        [this, id = node.id, s](QAbstractSocket::SocketState state) {
+            // A socket that was replaced or removed might still report that it closes
+            const auto it = _sockets.find(id);
+            if (it != _sockets.end() && it->second.get() == s) {
                 handleSocketStateChange(id, state);
             }
+        }
+    );
+    connect(
+        s, &common::JsonSocket::backpressureChanged,
+        this,
+        [this, id = node.id](bool hasBackpressure) {
+            // The credits that were held back while the tray could not keep up with
+            // the outgoing messages are granted now
+            if (!hasBackpressure) {
+                consumeOutputCredits(id, 0);
+            }
+        }
+    );
+    // The process output and status messages make up most of the traffic, so all
+    // payloads go through the MessageDecoder, which decodes those straight into their
+    // structs without going through a JSON document
+    s->setPayloadHandler(
+        [this, id = node.id](std::string_view payload, common::Encoding encoding) {
+            handlePayload(payload, encoding, id);
+            return true;
+        }
+    );
+    _sockets[node.id] = std::move(jsonSocket);
+    _reconnects.add(node.id.v, std::chrono::steady_clock::now());
+    scheduleConnectionUpdate();
+}
+
+void ClusterConnectionHandler::removeNode(Node::ID id) {
+    const auto it = _sockets.find(id);
+    if (it == _sockets.end()) {
+        return;
+    }
+
+    // Same as in the destructor, there might still be events pending for the socket
+    QObject::disconnect(it->second.get());
+    it->second.release()->deleteLater();
+    _sockets.erase(it);
+    _consumedOutput.erase(id);
+    _heartbeats.remove(id.v);
+    data::setNodeDisconnecting(id);
+
+    // A connection attempt for this node might have been in progress
+    _reconnects.remove(id.v);
+    scheduleConnectionUpdate();
+}
+
+void ClusterConnectionHandler::updateConnections() {
+    using Clock = common::ReconnectScheduler::Clock;
+    const Clock::time_point now = Clock::now();
+
+    common::ReconnectScheduler::Actions actions = _reconnects.update(now);
+    for (int id : actions.abort) {
+        const auto it = _sockets.find(Node::ID(id));
+        assert(it != _sockets.end());
+        const Node* node = data::findNode(Node::ID(id));
+        assert(node);
+
+        Log(
+            "Status",
+            std::format("Connection attempt to {} timed out", node->name)
         );
+        _resolvedHosts.erase(node->ipAddress);
+        it->second->abort();
+    }
+    for (int id : actions.dial) {
+        dial(Node::ID(id), now);
+    }
 
-        std::unique_ptr<common::JsonSocket> jsonSocket =
-            std::make_unique<common::JsonSocket>(std::move(socket), node->secret);
+    if (std::optional<Clock::time_point> next = _reconnects.nextUpdate()) {
+        const std::chrono::milliseconds wait = std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now),
+            std::chrono::milliseconds(0)
+        );
+        _reconnectTimer->start(wait);
+    }
+}
 
-        connect(
-            jsonSocket.get(), &common::JsonSocket::messageReceived,
-            [this, id = node->id](nlohmann::json message) {
-                try {
-                    handleMessage(message, id);
-                }
-                catch (const std::exception& e) {
-                    Log(
-                        "ClusterConnectionHandler::initialize",
-                        std::format(
-                            "Caught exception {} when receiving message {}",
-                            e.what(), message.dump()
-                        )
-                    );
-                }
-            }
+void ClusterConnectionHandler::scheduleConnectionUpdate() {
+    _reconnectTimer->start(0);
+}
+
+std::optional<common::HeartbeatMonitor::Statistics>
+ClusterConnectionHandler::heartbeatStatistics(Node::ID id) const
+{
+    return _heartbeats.statistics(id.v);
+}
+
+void ClusterConnectionHandler::updateHeartbeats() {
+    using Clock = common::HeartbeatMonitor::Clock;
+    const Clock::time_point now = Clock::now();
+
+    common::HeartbeatMonitor::Actions actions = _heartbeats.update(now);
+    for (const common::HeartbeatMonitor::Ping& ping : actions.ping) {
+        const Node::ID nodeId = Node::ID(ping.id);
+        const Node* node = data::findNode(nodeId);
+        assert(node);
+
+        common::PingMessage msg;
+        msg.sequence = ping.sequence;
+        if (!node->secret.empty()) {
+            msg.secret = node->secret;
+        }
+
+        // Same as the output credits, the heartbeats are sent continuously and are not
+        // written to the log
+        const auto it = _sockets.find(nodeId);
+        assert(it != _sockets.end());
+        it->second->write(msg);
+
+        std::optional<common::HeartbeatMonitor::Statistics> stats =
+            _heartbeats.statistics(ping.id);
+        if (stats.has_value() && stats->missedBeats > 0) {
+            emit heartbeatStatisticsChanged(nodeId, *stats);
+        }
+    }
+    for (int id : actions.dead) {
+        const auto it = _sockets.find(Node::ID(id));
+        assert(it != _sockets.end());
+        const Node* node = data::findNode(Node::ID(id));
+        assert(node);
+
+        // The connection might be half-open, in which case it would take the operating
+        // system a long time to notice. Aborting it reestablishes it right away
+        Log(
+            "Status",
+            std::format(
+                "Tray on {} did not answer {} heartbeats, reconnecting",
+                node->name, _heartbeats.options().maxMissedBeats
+            )
         );
-        common::JsonSocket* s = jsonSocket.get();
-        _sockets[node->id] = std::move(jsonSocket);
-        s->connectToHost(node->ipAddress, node->port);
+        it->second->abort();
     }
-    QTimer* timer = new QTimer(this);
-    connect(
-        timer, &QTimer::timeout,
-        [this]() {
-            using K = Node::ID;
-            using V = std::unique_ptr<common::JsonSocket>;
-            for (const std::pair<const K, V>& p : _sockets) {
-                // Try to reconnect all sockets that are currently unconnected
-                if (p.second->state() == QAbstractSocket::SocketState::UnconnectedState) {
-                    const Node* node = data::findNode(p.first);
-                    p.second->connectToHost(node->ipAddress, node->port);
-                }
+
+    if (std::optional<Clock::time_point> next = _heartbeats.nextUpdate()) {
+        const std::chrono::milliseconds wait = std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now),
+            std::chrono::milliseconds(0)
+        );
+        _heartbeatTimer->start(wait);
+    }
+}
+
+void ClusterConnectionHandler::handlePong(const common::PongMessage& message,
+                                          Node::ID nodeId)
+{
+    const auto now = common::HeartbeatMonitor::Clock::now();
+    _heartbeats.receivePong(nodeId.v, message.sequence, now);
+
+    std::optional<common::HeartbeatMonitor::Statistics> stats =
+        _heartbeats.statistics(nodeId.v);
+    if (stats.has_value()) {
+        emit heartbeatStatisticsChanged(nodeId, *stats);
+    }
+}
+
+void ClusterConnectionHandler::dial(Node::ID nodeId,
+                                    std::chrono::steady_clock::time_point now)
+{
+    const auto it = _sockets.find(nodeId);
+    assert(it != _sockets.end());
+    const Node* node = data::findNode(nodeId);
+    assert(node);
+
+    // Nodes that are specified by their IP address don't need a lookup at all
+    QHostAddress address;
+    if (address.setAddress(QString::fromStdString(node->ipAddress))) {
+        it->second->connectToHost(address, node->port);
+        return;
+    }
+
+    const auto jt = _resolvedHosts.find(node->ipAddress);
+    if (jt != _resolvedHosts.end() && jt->second.expiry > now) {
+        it->second->connectToHost(jt->second.address, node->port);
+        return;
+    }
+
+    // Multiple nodes on the same host share a single lookup
+    std::vector<Node::ID>& pending = _pendingLookups[node->ipAddress];
+    if (std::find(pending.begin(), pending.end(), nodeId) == pending.end()) {
+        pending.push_back(nodeId);
+    }
+    if (pending.size() == 1) {
+        QHostInfo::lookupHost(
+            QString::fromStdString(node->ipAddress),
+            this,
+            [this, host = node->ipAddress](const QHostInfo& info) {
+                handleHostLookup(host, info);
             }
+        );
+    }
+}
+
+void ClusterConnectionHandler::handleHostLookup(const std::string& host,
+                                                const QHostInfo& info)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    const auto pt = _pendingLookups.find(host);
+    if (pt == _pendingLookups.end()) {
+        return;
+    }
+    const std::vector<Node::ID> nodes = std::move(pt->second);
+    _pendingLookups.erase(pt);
+
+    const bool success = info.error() == QHostInfo::NoError && !info.addresses().empty();
+    if (success) {
+        _resolvedHosts[host] = {
+            info.addresses().front(),
+            now + HostLookupCacheDuration
+        };
+    }
+    else {
+        Log(
+            "Error",
+            std::format(
+                "Could not resolve host {}: {}", host, info.errorString().toStdString()
+            )
+        );
+    }
+
+    for (Node::ID nodeId : nodes) {
+        // The node might have been removed, have changed its address, or its connection
+        // attempt might have timed out while the lookup was running
+        const auto it = _sockets.find(nodeId);
+        const Node* node = data::findNode(nodeId);
+        if (it == _sockets.end() || !node || node->ipAddress != host ||
+            !_reconnects.isDialing(nodeId.v))
+        {
+            continue;
         }
-    );
-    timer->start(std::chrono::milliseconds(2500));
+
+        if (success) {
+            it->second->connectToHost(info.addresses().front(), node->port);
+        }
+        else {
+            _reconnects.setDisconnected(nodeId.v, now);
+        }
+    }
+
+    if (!success) {
+        scheduleConnectionUpdate();
+    }
 }
 
 void ClusterConnectionHandler::handleSocketStateChange(Node::ID nodeId,
                                                        QAbstractSocket::SocketState state)
 {
+    if (state == QAbstractSocket::SocketState::UnconnectedState) {
+        const Node* node = data::findNode(nodeId);
+        assert(node);
+
+        if (_reconnects.isDialing(nodeId.v)) {
+            // The connection attempt failed, maybe because the host has a new address
+            _resolvedHosts.erase(node->ipAddress);
+        }
+        else if (node->isConnecting || node->isConnected) {
+            // An aborted connection does not pass through the closing state
+            data::setNodeDisconnecting(nodeId);
+            _consumedOutput.erase(nodeId);
+            _heartbeats.remove(nodeId.v);
+            for (const Cluster* cluster : data::findClusterForNode(*node)) {
+                emit connectedStatusChanged(cluster->id, node->id);
+            }
+        }
+
+        // The attempt is repeated, or the lost connection reestablished, after a delay
+        _reconnects.setDisconnected(nodeId.v, std::chrono::steady_clock::now());
+        scheduleConnectionUpdate();
+        return;
+    }
+
     if (state != QAbstractSocket::SocketState::ConnectedState &&
         state != QAbstractSocket::SocketState::ClosingState)
     {
@@ -142,9 +470,14 @@ void ClusterConnectionHandler::handleSocketStateChange(Node::ID nodeId,
 
     if (state == QAbstractSocket::SocketState::ConnectedState) {
         data::setNodeConnecting(nodeId, true);
+        _reconnects.setConnected(nodeId.v);
+        // This frees up a slot for the next connection attempt
+        scheduleConnectionUpdate();
     }
     else if (state == QAbstractSocket::SocketState::ClosingState) {
         data::setNodeDisconnecting(nodeId);
+        _consumedOutput.erase(nodeId);
+        _heartbeats.remove(nodeId.v);
     }
 
     std::vector<const Cluster*> clusters = data::findClusterForNode(*node);
@@ -153,66 +486,180 @@ void ClusterConnectionHandler::handleSocketStateChange(Node::ID nodeId,
     }
 }
 
-void ClusterConnectionHandler::handleMessage(nlohmann::json message, Node::ID nodeId) {
+void ClusterConnectionHandler::handlePayload(std::string_view payload,
+                                             common::Encoding encoding, Node::ID nodeId)
+{
+    // A payload that can't be decoded is malformed, which the JsonSocket reports when it
+    // drops the message. Here we only have to deal with errors in the handlers
+    common::DecodedMessage message = common::decodeMessage(payload, encoding);
+    try {
+        std::visit(
+            [this, nodeId](auto& m) {
+                using T = std::decay_t<decltype(m)>;
+                if constexpr (std::is_same_v<T, nlohmann::json>) {
+                    handleMessage(m, nodeId);
+                }
+                else {
+                    _dispatcher.dispatchMessage(std::move(m), nodeId);
+                }
+            },
+            message
+        );
+    }
+    catch (const std::exception& e) {
+        // The decoded messages were moved into their handler, but their type is enough
+        // to know what went wrong
+        const std::string content = std::visit(
+            [](const auto& m) {
+                using T = std::decay_t<decltype(m)>;
+                if constexpr (std::is_same_v<T, nlohmann::json>) {
+                    return m.dump();
+                }
+                else {
+                    return std::string(T::Type);
+                }
+            },
+            message
+        );
+        Log(
+            "ClusterConnectionHandler::handlePayload",
+            std::format(
+                "Caught exception {} when receiving message {}", e.what(), content
+            )
+        );
+    }
+}
+
+void ClusterConnectionHandler::handleMessage(const nlohmann::json& message,
+                                             Node::ID nodeId)
+{
     const auto it = _sockets.find(nodeId);
     assert(it != _sockets.end());
     assert(data::findNode(nodeId)->isConnecting || data::findNode(nodeId)->isConnected);
 
 #ifdef QT_DEBUG
     assert(data::findNode(nodeId));
-    std::string content = common::isValidMessage<common::ProcessOutputMessage>(message) ?
-        std::string(common::ProcessOutputMessage::Type) :
-        message.dump();
-
-    std::string cat = std::format(
-        "Received [{}:{} ({})]",
-        data::findNode(nodeId)->ipAddress, data::findNode(nodeId)->port,
-        data::findNode(nodeId)->name
+    ::Debug(
+        common::LogCategory::Messages,
+        "ClusterConnectionHandler",
+        [&message, nodeId]() {
+            const Node* node = data::findNode(nodeId);
+            std::string content =
+                common::isValidMessage<common::ProcessOutputMessage>(message) ?
+                std::string(common::ProcessOutputMessage::Type) :
+                message.dump();
+            return std::format(
+                "Received [{}:{} ({})]: {}",
+                node->ipAddress, node->port, node->name, content
+            );
+        }
     );
-    Debug(std::move(cat), std::move(content));
 #endif // QT_DEBUG
 
-    if (common::isValidMessage<common::ProcessStatusMessage>(message)) {
-        common::ProcessStatusMessage status = message;
-        emit receivedTrayProcess(status);
-    }
-    else if (common::isValidMessage<common::TrayStatusMessage>(message)) {
-        common::TrayStatusMessage status = message;
-        emit receivedTrayStatus(nodeId, status);
+    _dispatcher.dispatch(message, nodeId);
+}
+
+void ClusterConnectionHandler::handleTrayConnected(
+                                              const common::TrayConnectedMessage& message,
+                                                                     Node::ID nodeId)
+{
+    const Node* node = data::findNode(nodeId);
+    assert(node->isConnecting);
+    assert(!node->isConnected);
+    data::setNodeConnecting(nodeId, false);
+    data::setNodeConnected(nodeId, true);
+    // Only a completed handshake shows that the tray accepts us, so the delay between
+    // the connection attempts is reset here and not as soon as the socket is connected
+    _reconnects.setEstablished(nodeId.v);
+
+    // Switch to the first binary encoding that the tray prefers and compress large
+    // messages if the tray can handle it. Older trays don't advertise anything and
+    // we keep talking to them in uncompressed JSON text
+    common::Encoding encoding = common::Encoding::Json;
+    for (const std::string& name : message.encodings) {
+        if (std::optional<common::Encoding> e = common::encodingFromString(name)) {
+            encoding = *e;
+            break;
+        }
     }
-    else if (common::isValidMessage<common::TrayConnectedMessage>(message)) {
-        const Node* node = data::findNode(nodeId);
-        assert(node->isConnecting);
-        assert(!node->isConnected);
-        data::setNodeConnecting(nodeId, false);
-        data::setNodeConnected(nodeId, true);
+    const bool useCompression = std::find(
+        message.compressions.begin(),
+        message.compressions.end(),
+        common::JsonSocket::CompressionZlib
+    ) != message.compressions.end();
 
-        std::vector<const Cluster*> clusters = data::findClusterForNode(*node);
-        for (const Cluster* cluster : clusters) {
-            emit connectedStatusChanged(cluster->id, node->id);
+    if (encoding != common::Encoding::Json || useCompression) {
+        common::SelectEncodingMessage selectMsg;
+        selectMsg.encoding = common::toString(encoding);
+        if (useCompression) {
+            selectMsg.compression = common::JsonSocket::CompressionZlib;
+        }
+        if (!node->secret.empty()) {
+            selectMsg.secret = node->secret;
         }
+        sendMessage(*node, selectMsg);
+
+        // The selection itself still goes out in JSON text as the tray only switches
+        // after it has received the message
+        const auto it = _sockets.find(nodeId);
+        assert(it != _sockets.end());
+        it->second->setEncoding(encoding);
+        it->second->setCompressionEnabled(useCompression);
     }
-    else if (common::isValidMessage<common::InvalidAuthMessage>(message)) {
-        common::InvalidAuthMessage msg = message;
-        emit receivedInvalidAuthStatus(nodeId, msg);
+
+    if (message.supportsOutputCredits) {
+        _consumedOutput[nodeId] = 0;
+        grantOutputCredits(nodeId, OutputCreditWindow);
     }
-    else if (common::isValidMessage<common::ProcessOutputMessage>(message)) {
-        common::ProcessOutputMessage msg = message;
-        emit receivedProcessMessage(nodeId, msg);
+
+    if (message.supportsHeartbeat) {
+        // Each tray should only announce itself once per connection, but a repeated
+        // announcement must not start a second set of heartbeats
+        _heartbeats.remove(nodeId.v);
+        _heartbeats.add(nodeId.v, common::HeartbeatMonitor::Clock::now());
+        _heartbeatTimer->start(0);
     }
-    else if (common::isValidMessage<common::ErrorOccurredMessage>(message)) {
-        common::ErrorOccurredMessage msg = message;
-        emit receivedErrorMessage(nodeId, msg);
+
+    std::vector<const Cluster*> clusters = data::findClusterForNode(*node);
+    for (const Cluster* cluster : clusters) {
+        emit connectedStatusChanged(cluster->id, node->id);
     }
-    else {
-        const Node* n = data::findNode(nodeId);
-        assert(n);
-        std::vector<const Cluster*> clusters = data::findClusterForNode(*n);
+}
 
-        for (const Cluster* c : clusters) {
-            assert(c);
-            Log(std::format("Received [{} / {}]", c->name, n->name), message.dump());
-        }
+void ClusterConnectionHandler::grantOutputCredits(Node::ID nodeId, std::uint64_t credits)
+{
+    const Node* node = data::findNode(nodeId);
+    assert(node);
+
+    common::OutputCreditMessage msg;
+    msg.credits = credits;
+    if (!node->secret.empty()) {
+        msg.secret = node->secret;
+    }
+
+    // These messages are sent continuously while output is forwarded, so they are not
+    // written to the log like the other messages that we send
+    const auto it = _sockets.find(nodeId);
+    assert(it != _sockets.end());
+    it->second->write(msg);
+}
+
+void ClusterConnectionHandler::consumeOutputCredits(Node::ID nodeId, std::size_t nBytes)
+{
+    const auto it = _consumedOutput.find(nodeId);
+    if (it == _consumedOutput.end()) {
+        // The tray does not support output credits
+        return;
+    }
+
+    it->second += nBytes;
+    if (_sockets.at(nodeId)->hasBackpressure()) {
+        // More output would only add to the messages that are already waiting
+        return;
+    }
+    if (it->second >= OutputCreditWindow / 2) {
+        grantOutputCredits(nodeId, it->second);
+        it->second = 0;
     }
 }
 
@@ -38,26 +38,55 @@
 #include <QObject>
 
 #include "cluster.h"
+#include "heartbeatmonitor.h"
 #include "jsonsocket.h"
+#include "messagedispatcher.h"
 #include "messages.h"
 #include "node.h"
+#include "reconnectscheduler.h"
 #include <QAbstractSocket>
+#include <QHostAddress>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
+class QHostInfo;
+class QTimer;
 struct Cluster;
 struct Node;
 
 class ClusterConnectionHandler : public QObject {
 Q_OBJECT
 public:
+    ClusterConnectionHandler();
     ~ClusterConnectionHandler();
 
-    void initialize();
+    /// Opens the connections to all nodes with the \p socket options and exchanges
+    /// heartbeats with the trays that support them according to the \p heartbeat options
+    void initialize(common::HeartbeatMonitor::Options heartbeat,
+        common::JsonSocket::Options socket);
     void sendMessage(const Node& node, nlohmann::json message) const;
 
+    /// Opens a connection to the tray on the \p node, which has to be in the database.
+    /// If the connection fails or is lost, it is reestablished automatically
+    void addNode(const Node& node);
+    /// Closes the connection to the tray on the node with the \p id
+    void removeNode(Node::ID id);
+
+    /// Returns the round-trip times of the heartbeats of the node with the \p id or
+    /// `std::nullopt` if no heartbeats are exchanged with its tray
+    std::optional<common::HeartbeatMonitor::Statistics> heartbeatStatistics(
+        Node::ID id) const;
+
 signals:
     void connectedStatusChanged(Cluster::ID clusterId, Node::ID nodeId);
+    void heartbeatStatisticsChanged(Node::ID nodeId,
+        common::HeartbeatMonitor::Statistics statistics);
 
     void receivedTrayProcess(common::ProcessStatusMessage status);
     void receivedTrayStatus(Node::ID id, common::TrayStatusMessage status);
@@ -66,10 +95,56 @@ signals:
     void receivedErrorMessage(Node::ID, common::ErrorOccurredMessage message);
 
 private:
+    /// Dials the connections that are due and schedules the next time this is necessary
+    void updateConnections();
+    /// Makes sure that updateConnections is called in the next event loop iteration
+    void scheduleConnectionUpdate();
+    void dial(Node::ID nodeId, std::chrono::steady_clock::time_point now);
+    void handleHostLookup(const std::string& host, const QHostInfo& info);
+
+    /// Sends the heartbeats that are due, closes the connections to trays that stopped
+    /// answering them, and schedules the next time this is necessary
+    void updateHeartbeats();
+    void handlePong(const common::PongMessage& message, Node::ID nodeId);
+
     void handleSocketStateChange(Node::ID nodeId, QAbstractSocket::SocketState state);
-    void handleMessage(nlohmann::json message, Node::ID nodeId);
+    void handlePayload(std::string_view payload, common::Encoding encoding,
+        Node::ID nodeId);
+    void handleMessage(const nlohmann::json& message, Node::ID nodeId);
+    void handleTrayConnected(const common::TrayConnectedMessage& message,
+        Node::ID nodeId);
+    void grantOutputCredits(Node::ID nodeId, std::uint64_t credits);
+    void consumeOutputCredits(Node::ID nodeId, std::size_t nBytes);
 
     std::map<Node::ID, std::unique_ptr<common::JsonSocket>> _sockets;
+    /// The options that are applied to the sockets of all nodes
+    common::JsonSocket::Options _socketOptions;
+    common::MessageDispatcher<Node::ID> _dispatcher;
+
+    /// Decides when the trays are dialed, which replaces polling all sockets
+    common::ReconnectScheduler _reconnects;
+    /// A single-shot timer that fires when the next update of the connections is due
+    QTimer* _reconnectTimer = nullptr;
+
+    /// The addresses of the host names of the nodes, so that they are not looked up
+    /// again for every connection attempt
+    struct ResolvedHost {
+        QHostAddress address;
+        std::chrono::steady_clock::time_point expiry;
+    };
+    std::map<std::string, ResolvedHost> _resolvedHosts;
+    /// The nodes that are waiting for the host lookup of their host name
+    std::map<std::string, std::vector<Node::ID>> _pendingLookups;
+
+    /// Keeps track of the heartbeats of all trays that support them
+    common::HeartbeatMonitor _heartbeats;
+    /// A single-shot timer that fires when the next heartbeat is due
+    QTimer* _heartbeatTimer = nullptr;
+
+    /// The number of bytes of process output that were handled since the last credits
+    /// were granted, for every tray that supports output credits. While the connection
+    /// to a tray has backpressure, no new credits are granted to it
+    std::map<Node::ID, std::uint64_t> _consumedOutput;
 };
 
 #endif // __CTROLL__CLUSTERCONNECTIONHANDLER_H__
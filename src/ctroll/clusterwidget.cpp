@@ -45,6 +45,14 @@
 #include <QStyle>
 #include <QStyleOption>
 #include <QVBoxLayout>
+#include <format>
+#include <set>
+
+namespace {
+    std::string formatDuration(std::chrono::microseconds duration) {
+        return std::format("{:.1f}", static_cast<double>(duration.count()) / 1000.0);
+    }
+} // namespace
 
 void ConnectionWidget::setStatus(Status status) {
     std::string string = [](Status s) {
@@ -105,6 +113,11 @@ NodeWidget::NodeWidget(const Node& node, bool showShutdownButton)
 
     QLabel* ip = new QLabel(QString::fromStdString(node.ipAddress));
     topLayout->addWidget(ip);
+
+    _latency = new QLabel;
+    _latency->setObjectName("latency");
+    _latency->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    topLayout->addWidget(_latency);
     layout->addWidget(topRow);
 
     QWidget* bottomRow = new QWidget;
@@ -244,6 +257,37 @@ void NodeWidget::updateConnectionStatus() {
     if (_shutdownNode) {
         _shutdownNode->setEnabled(n->isConnected);
     }
+
+    if (!n->isConnected) {
+        // The round-trip times are measured anew for every connection
+        _latency->clear();
+        _latency->setToolTip("");
+    }
+}
+
+void NodeWidget::updateHeartbeatStatistics(
+                                       const common::HeartbeatMonitor::Statistics& stats)
+{
+    std::string text;
+    if (stats.nSamples > 0) {
+        text = std::format(
+            "{} / {} ms", formatDuration(stats.p50), formatDuration(stats.p99)
+        );
+    }
+    if (stats.missedBeats > 0) {
+        text += std::format(" ({} missed)", stats.missedBeats);
+    }
+    _latency->setText(QString::fromStdString(text));
+    _latency->setProperty("missed", stats.missedBeats > 0);
+    style()->unpolish(_latency);
+    style()->polish(_latency);
+
+    _latency->setToolTip(QString::fromStdString(std::format(
+        "Round-trip time of the last {} heartbeats\n"
+        "Median: {} ms\n99th percentile: {} ms\nLast: {} ms\nMissed heartbeats: {}",
+        stats.nSamples, formatDuration(stats.p50), formatDuration(stats.p99),
+        formatDuration(stats.last), stats.missedBeats
+    )));
 }
 
 
@@ -441,40 +485,103 @@ void ClusterWidget::updateConnectionStatus(Node::ID nodeId) {
     }
 }
 
+void ClusterWidget::updateHeartbeatStatistics(Node::ID nodeId,
+                                      const common::HeartbeatMonitor::Statistics& stats)
+{
+    const auto it = _nodeWidgets.find(nodeId);
+    assert(it != _nodeWidgets.end());
+    it->second->updateHeartbeatStatistics(stats);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
 
-ClustersWidget::ClustersWidget(bool showShutdownButton) {
+ClustersWidget::ClustersWidget(bool showShutdownButton)
+    : _showShutdownButton(showShutdownButton)
+{
     setWidgetResizable(true);
     QWidget* content = new QWidget;
     setWidget(content);
-    QBoxLayout* contentLayout = new QVBoxLayout(content);
-    contentLayout->setContentsMargins(10, 2, 2, 2);
-    contentLayout->setSpacing(20);
+    _layout = new QVBoxLayout(content);
+    _layout->setContentsMargins(10, 2, 2, 2);
+    _layout->setSpacing(20);
     setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Expanding);
 
     for (const Cluster* c : data::clusters()) {
-        ClusterWidget* w = new ClusterWidget(*c, showShutdownButton);
-        connect(
-            w, QOverload<Node::ID>::of(&ClusterWidget::killProcesses),
-            this, QOverload<Node::ID>::of(&ClustersWidget::killProcesses)
-        );
-        connect(
-            w, QOverload<Cluster::ID>::of(&ClusterWidget::killProcesses),
-            this, QOverload<Cluster::ID>::of(&ClustersWidget::killProcesses)
-        );
-        connect(w, &ClusterWidget::killTray, this, &ClustersWidget::killTray);
-        connect(w, &ClusterWidget::killTrays, this, &ClustersWidget::killTrays);
-        connect(w, &ClusterWidget::restartNode, this, &ClustersWidget::restartNode);
-        connect(w, &ClusterWidget::restartNodes, this, &ClustersWidget::restartNodes);
-        connect(w, &ClusterWidget::shutdownNode, this, &ClustersWidget::shutdownNode);
-        connect(w, &ClusterWidget::shutdownNodes, this, &ClustersWidget::shutdownNodes);
+        ClusterWidget* w = createClusterWidget(*c);
         _clusterWidgets[c->id] = w;
-        contentLayout->addWidget(w);
+        _layout->addWidget(w);
     }
 
-    contentLayout->addStretch();
+    _layout->addStretch();
+}
+
+ClusterWidget* ClustersWidget::createClusterWidget(const Cluster& cluster) {
+    ClusterWidget* w = new ClusterWidget(cluster, _showShutdownButton);
+    connect(
+        w, QOverload<Node::ID>::of(&ClusterWidget::killProcesses),
+        this, QOverload<Node::ID>::of(&ClustersWidget::killProcesses)
+    );
+    connect(
+        w, QOverload<Cluster::ID>::of(&ClusterWidget::killProcesses),
+        this, QOverload<Cluster::ID>::of(&ClustersWidget::killProcesses)
+    );
+    connect(w, &ClusterWidget::killTray, this, &ClustersWidget::killTray);
+    connect(w, &ClusterWidget::killTrays, this, &ClustersWidget::killTrays);
+    connect(w, &ClusterWidget::restartNode, this, &ClustersWidget::restartNode);
+    connect(w, &ClusterWidget::restartNodes, this, &ClustersWidget::restartNodes);
+    connect(w, &ClusterWidget::shutdownNode, this, &ClustersWidget::shutdownNode);
+    connect(w, &ClusterWidget::shutdownNodes, this, &ClustersWidget::shutdownNodes);
+    return w;
+}
+
+void ClustersWidget::applyChanges(const data::DataChanges& changes) {
+    for (Cluster::ID id : changes.removedClusters) {
+        const auto it = _clusterWidgets.find(id);
+        assert(it != _clusterWidgets.end());
+        _layout->removeWidget(it->second);
+        it->second->deleteLater();
+        _clusterWidgets.erase(it);
+    }
+
+    // The node widgets are part of the cluster widget, so a cluster has to be recreated
+    // if any of its nodes changed, too
+    std::set<Cluster::ID> changed = std::set<Cluster::ID>(
+        changes.changedClusters.begin(),
+        changes.changedClusters.end()
+    );
+    for (Node::ID id : changes.changedNodes) {
+        const Node* node = data::findNode(id);
+        assert(node);
+        for (const Cluster* cluster : data::findClusterForNode(*node)) {
+            changed.insert(cluster->id);
+        }
+    }
+    for (Cluster::ID id : changed) {
+        const auto it = _clusterWidgets.find(id);
+        if (it == _clusterWidgets.end()) {
+            // The cluster was added and is created below
+            continue;
+        }
+
+        const Cluster* cluster = data::findCluster(id);
+        assert(cluster);
+        ClusterWidget* w = createClusterWidget(*cluster);
+        _layout->insertWidget(_layout->indexOf(it->second), w);
+        _layout->removeWidget(it->second);
+        it->second->deleteLater();
+        it->second = w;
+    }
+
+    for (Cluster::ID id : changes.addedClusters) {
+        const Cluster* cluster = data::findCluster(id);
+        assert(cluster);
+        ClusterWidget* w = createClusterWidget(*cluster);
+        // The last item in the layout is the stretch that keeps the clusters at the top
+        _layout->insertWidget(_layout->count() - 1, w);
+        _clusterWidgets[id] = w;
+    }
 }
 
 void ClustersWidget::connectedStatusChanged(Cluster::ID clusterId, Node::ID nodeId) {
@@ -482,3 +589,15 @@ void ClustersWidget::connectedStatusChanged(Cluster::ID clusterId, Node::ID node
     assert(it != _clusterWidgets.end());
     it->second->updateConnectionStatus(nodeId);
 }
+
+void ClustersWidget::heartbeatStatisticsChanged(Node::ID nodeId,
+                                       common::HeartbeatMonitor::Statistics statistics)
+{
+    const Node* node = data::findNode(nodeId);
+    assert(node);
+    for (const Cluster* cluster : data::findClusterForNode(*node)) {
+        const auto it = _clusterWidgets.find(cluster->id);
+        assert(it != _clusterWidgets.end());
+        it->second->updateHeartbeatStatistics(nodeId, statistics);
+    }
+}
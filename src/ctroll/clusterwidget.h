@@ -40,12 +40,16 @@
 #include <QWidget>
 
 #include "cluster.h"
+#include "heartbeatmonitor.h"
 #include "node.h"
 #include <map>
 
+class QBoxLayout;
 class QLabel;
 class QPushButton;
 
+namespace data { struct DataChanges; }
+
 class ConnectionWidget : public QWidget {
 Q_OBJECT
 public:
@@ -70,6 +74,8 @@ public:
     NodeWidget(const Node& node, bool showShutdownButton);
 
     void updateConnectionStatus();
+    /// Shows the round-trip times and missed heartbeats of the connection to the tray
+    void updateHeartbeatStatistics(const common::HeartbeatMonitor::Statistics& stats);
 
 signals:
     void killProcesses(Node::ID id);
@@ -81,6 +87,7 @@ private:
     const Node::ID _nodeId;
 
     ConnectionWidget* _connectionLabel = nullptr;
+    QLabel* _latency = nullptr;
     QPushButton* _killProcesses = nullptr;
     QPushButton* _killTray = nullptr;
     QPushButton* _restartNode = nullptr;
@@ -97,6 +104,8 @@ public:
     ClusterWidget(const Cluster& cluster, bool showShutdownButton);
 
     void updateConnectionStatus(Node::ID nodeId);
+    void updateHeartbeatStatistics(Node::ID nodeId,
+        const common::HeartbeatMonitor::Statistics& stats);
 
 signals:
     void killProcesses(Node::ID id);
@@ -128,8 +137,13 @@ Q_OBJECT
 public:
     explicit ClustersWidget(bool showShutdownButton);
 
+    /// Recreates the widgets of all clusters that were affected by reloading the data
+    void applyChanges(const data::DataChanges& changes);
+
 public slots:
     void connectedStatusChanged(Cluster::ID clusterId, Node::ID nodeId);
+    void heartbeatStatisticsChanged(Node::ID nodeId,
+        common::HeartbeatMonitor::Statistics statistics);
 
 signals:
     void killProcesses(Node::ID id);
@@ -142,6 +156,10 @@ signals:
     void shutdownNodes(Cluster::ID id);
 
 private:
+    ClusterWidget* createClusterWidget(const Cluster& cluster);
+
+    const bool _showShutdownButton;
+    QBoxLayout* _layout = nullptr;
     std::map<Cluster::ID, ClusterWidget*> _clusterWidgets;
 };
 
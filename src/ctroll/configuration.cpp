@@ -41,6 +41,22 @@ namespace {
 
     constexpr std::string_view KeyLogFile = "logFile";
     constexpr std::string_view KeyLogRotation = "logRotation";
+    constexpr std::string_view KeyLogLevels = "logLevels";
+    constexpr std::string_view KeyLogLines = "logLines";
+
+    constexpr std::string_view KeyProcessOutput = "processOutput";
+    constexpr std::string_view KeyProcessOutputMaxBytes = "maxBytes";
+    constexpr std::string_view KeyProcessOutputMaxLines = "maxLines";
+
+    constexpr std::string_view KeyProcessHistory = "processHistory";
+
+    constexpr std::string_view KeyDataCache = "dataCache";
+
+    constexpr std::string_view KeyHeartbeat = "heartbeat";
+    constexpr std::string_view KeyHeartbeatInterval = "interval";
+    constexpr std::string_view KeyHeartbeatMissedBeats = "missedBeats";
+
+    constexpr std::string_view KeySocket = "socket";
 
     constexpr std::string_view KeyShowShutdownButton = "showShutdownButton";
 
@@ -73,6 +89,54 @@ void to_json(nlohmann::json& j, const Configuration& c) {
         j[KeyLogRotation] = *c.logRotation;
     }
 
+    if (!c.logLevels.levels.empty()) {
+        j[KeyLogLevels] = c.logLevels;
+    }
+
+    if (c.logLines != Configuration().logLines) {
+        j[KeyLogLines] = c.logLines;
+    }
+
+    {
+        const common::OutputBuffer::Limits def;
+        nlohmann::json obj = nlohmann::json::object();
+        if (c.processOutput.maxBytes != def.maxBytes) {
+            obj[KeyProcessOutputMaxBytes] = c.processOutput.maxBytes;
+        }
+        if (c.processOutput.maxLines != def.maxLines) {
+            obj[KeyProcessOutputMaxLines] = c.processOutput.maxLines;
+        }
+        if (!obj.empty()) {
+            j[KeyProcessOutput] = std::move(obj);
+        }
+    }
+
+    if (c.processHistory != Configuration().processHistory) {
+        j[KeyProcessHistory] = c.processHistory;
+    }
+
+    if (c.dataCache != Configuration().dataCache) {
+        j[KeyDataCache] = c.dataCache;
+    }
+
+    {
+        const common::HeartbeatMonitor::Options def;
+        nlohmann::json obj = nlohmann::json::object();
+        if (c.heartbeat.interval != def.interval) {
+            obj[KeyHeartbeatInterval] = static_cast<int>(c.heartbeat.interval.count());
+        }
+        if (c.heartbeat.maxMissedBeats != def.maxMissedBeats) {
+            obj[KeyHeartbeatMissedBeats] = c.heartbeat.maxMissedBeats;
+        }
+        if (!obj.empty()) {
+            j[KeyHeartbeat] = std::move(obj);
+        }
+    }
+
+    if (c.socket != common::JsonSocket::Options()) {
+        j[KeySocket] = c.socket;
+    }
+
     if (c.showShutdownButtons != Configuration().showShutdownButtons) {
         j[KeyShowShutdownButton] = c.showShutdownButtons;
     }
@@ -143,6 +207,76 @@ void from_json(const nlohmann::json& j, Configuration& c) {
         c.logRotation = it->get<common::LogRotation>();
     }
 
+    if (auto it = j.find(KeyLogLevels);  it != j.end()) {
+        it->get_to(c.logLevels);
+    }
+
+    if (auto it = j.find(KeyLogLines);  it != j.end()) {
+        it->get_to(c.logLines);
+
+        if (c.logLines == 0) {
+            throw std::runtime_error("The number of log lines must be positive");
+        }
+    }
+
+    if (auto it = j.find(KeyProcessOutput);  it != j.end()) {
+        const nlohmann::json& output = *it;
+
+        if (auto jt = output.find(KeyProcessOutputMaxBytes);  jt != output.end()) {
+            jt->get_to(c.processOutput.maxBytes);
+
+            if (c.processOutput.maxBytes == 0) {
+                throw std::runtime_error(
+                    "The process output byte limit must be positive"
+                );
+            }
+        }
+        if (auto jt = output.find(KeyProcessOutputMaxLines);  jt != output.end()) {
+            jt->get_to(c.processOutput.maxLines);
+
+            if (c.processOutput.maxLines == 0) {
+                throw std::runtime_error(
+                    "The process output line limit must be positive"
+                );
+            }
+        }
+    }
+
+    if (auto it = j.find(KeyProcessHistory);  it != j.end()) {
+        it->get_to(c.processHistory);
+    }
+
+    if (auto it = j.find(KeyDataCache);  it != j.end()) {
+        it->get_to(c.dataCache);
+    }
+
+    if (auto it = j.find(KeyHeartbeat);  it != j.end()) {
+        const nlohmann::json& heartbeat = *it;
+
+        if (auto jt = heartbeat.find(KeyHeartbeatInterval);  jt != heartbeat.end()) {
+            const int ms = jt->get<int>();
+
+            if (ms <= 0) {
+                throw std::runtime_error("The heartbeat interval must be positive");
+            }
+
+            c.heartbeat.interval = std::chrono::milliseconds(ms);
+        }
+        if (auto jt = heartbeat.find(KeyHeartbeatMissedBeats);  jt != heartbeat.end()) {
+            jt->get_to(c.heartbeat.maxMissedBeats);
+
+            if (c.heartbeat.maxMissedBeats <= 0) {
+                throw std::runtime_error(
+                    "The number of missed heartbeats must be positive"
+                );
+            }
+        }
+    }
+
+    if (auto it = j.find(KeySocket);  it != j.end()) {
+        it->get_to(c.socket);
+    }
+
     if (auto it = j.find(KeyShowShutdownButton);  it != j.end()) {
         it->get_to(c.showShutdownButtons);
     }
@@ -37,7 +37,10 @@
 
 #include "baseconfiguration.h"
 #include "color.h"
+#include "heartbeatmonitor.h"
+#include "jsonsocket.h"
 #include "logconfiguration.h"
+#include "outputbuffer.h"
 #include <nlohmann/json.hpp>
 #include <chrono>
 #include <optional>
@@ -70,6 +73,29 @@ struct Configuration : public BaseConfiguration {
     /// Contains configuration about log rotations
     std::optional<common::LogRotation> logRotation;
 
+    /// The log levels of the categories that should differ from the default
+    common::LogLevels logLevels;
+
+    /// The maximum number of log messages that are shown in the log tab
+    std::size_t logLines = 10000;
+
+    /// The limits for the amount of output that is kept for each individual process
+    common::OutputBuffer::Limits processOutput;
+
+    /// The number of finished processes that are kept in the archive of the database
+    std::size_t processHistory = 1000;
+
+    /// The file in which the parsed data files are stored between runs, so that only the
+    /// files that changed have to be parsed at startup. An empty string disables it
+    std::string dataCache = "data.cache";
+
+    /// The heartbeats that are exchanged with the trays to measure the latency of the
+    /// connections and to detect trays that stopped responding
+    common::HeartbeatMonitor::Options heartbeat;
+
+    /// The options of the connections to the trays
+    common::JsonSocket::Options socket;
+
     bool showShutdownButtons = false;
 
     struct Rest {
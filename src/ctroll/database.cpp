@@ -34,9 +34,22 @@
 
 #include "database.h"
 
+#include "entityindex.h"
+#include "hash.h"
+#include "jsonload.h"
+#include "logging.h"
 #include <jsonvalidation.h>
 #include <QObject>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
 #include <random>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
     std::vector<std::unique_ptr<Cluster>> gClusters;
@@ -44,54 +57,354 @@ namespace {
     std::vector<std::unique_ptr<Program>> gPrograms;
     std::vector<std::unique_ptr<Process>> gProcesses;
 
+    // The lookup tables into the vectors above. They have to be updated whenever an
+    // element is added to or removed from the corresponding vector
+    common::EntityIndex<Cluster> gClusterIndex;
+    common::EntityIndex<Node> gNodeIndex;
+    common::EntityIndex<Program> gProgramIndex;
+    common::EntityIndex<Process> gProcessIndex;
+
+    // The nodes of each cluster and the clusters of each node, keyed by the identifier
+    std::unordered_map<int, std::vector<const Node*>> gClusterNodes;
+    std::unordered_map<int, std::vector<const Cluster*>> gNodeClusters;
+
+    // The processes for each combination of cluster, program, and configuration in the
+    // order in which they were added
+    using ProcessKey = std::tuple<int, int, int>;
+    std::map<ProcessKey, std::vector<Process*>> gProcessGroups;
+    // The processes that are no longer shown in the user interface
+    std::unordered_set<int> gReleasedProcesses;
+    // The finished processes that were removed from gProcesses, oldest first
+    std::deque<data::ArchivedProcess> gArchivedProcesses;
+    std::size_t gProcessHistory = 1000;
+
     std::set<std::string> gTags;
 
     std::vector<Color> gTagColors;
 
-    std::size_t gDataHash = 0;
-} // namespace
+    // The hash of each entity, keyed by its identifier, the hash over all entities of
+    // each type, and the hash over those three. Together they form a Merkle tree that
+    // only has to be updated for the entities that were changed by a reload
+    std::map<int, std::uint64_t> gNodeHashes;
+    std::map<int, std::uint64_t> gClusterHashes;
+    std::map<int, std::uint64_t> gProgramHashes;
+    std::uint64_t gNodesHash = 0;
+    std::uint64_t gClustersHash = 0;
+    std::uint64_t gProgramsHash = 0;
+    std::uint64_t gDataHash = 0;
+
+    // The parsed files from the last load, so that a reload only parses changed files.
+    // They are also stored on disk between runs by saveDataCache and loadDataCache
+    common::JsonFileCache<Node> gNodeFiles;
+    common::JsonFileCache<Cluster> gClusterFiles;
+    common::JsonFileCache<Program> gProgramFiles;
+
+    // The identifiers that are given to the next entity that is added by a reload
+    int gNextNodeId = 0;
+    int gNextClusterId = 0;
+    int gNextProgramId = 0;
+
+    // Has to be increased whenever the layout of the data cache, the schemas, or the
+    // JSON conversion of the nodes, clusters, or programs change
+    constexpr int DataCacheVersion = 3;
+    constexpr std::string_view KeyCacheVersion = "version";
+    constexpr std::string_view KeyCacheNodes = "nodes";
+    constexpr std::string_view KeyCacheClusters = "clusters";
+    constexpr std::string_view KeyCachePrograms = "programs";
+
+    ProcessKey processKey(const Process& process) {
+        return { process.clusterId.v, process.programId.v, process.configurationId.v };
+    }
 
-namespace data {
+    bool hasEnded(common::ProcessStatusMessage::Status status) {
+        using Status = common::ProcessStatusMessage::Status;
+        return status == Status::NormalExit || status == Status::CrashExit ||
+               status == Status::FailedToStart;
+    }
 
-std::vector<const Cluster*> clusters() {
-    std::vector<const Cluster*> clusters;
-    for (const std::unique_ptr<Cluster>& c : gClusters) {
-        assert(c.get());
-        clusters.push_back(c.get());
+    Process* newestProcessOnNode(const std::vector<Process*>& group, Node::ID nodeId) {
+        const auto it = std::find_if(
+            group.rbegin(), group.rend(),
+            [nodeId](const Process* p) { return p->nodeId == nodeId; }
+        );
+        return it != group.rend() ? *it : nullptr;
     }
-    return clusters;
-}
 
-std::vector<const Node*> nodes() {
-    std::vector<const Node*> nodes;
-    for (const std::unique_ptr<Node>& n : gNodes) {
-        assert(n.get());
-        nodes.push_back(n.get());
+    void archiveProcess(Process* process) {
+        std::erase(gProcessGroups[processKey(*process)], process);
+        gReleasedProcesses.erase(process->id.v);
+        gProcessIndex.erase(process);
+
+        if (gProcessHistory > 0) {
+            data::ArchivedProcess archived = {
+                .id = process->id,
+                .programId = process->programId,
+                .configurationId = process->configurationId,
+                .clusterId = process->clusterId,
+                .nodeId = process->nodeId,
+                .status = process->status
+            };
+            gArchivedProcesses.push_back(std::move(archived));
+            while (gArchivedProcesses.size() > gProcessHistory) {
+                gArchivedProcesses.pop_front();
+            }
+        }
+
+        std::erase_if(
+            gProcesses,
+            [process](const std::unique_ptr<Process>& p) { return p.get() == process; }
+        );
     }
-    return nodes;
-}
 
-std::vector<const Program*> programs() {
-    std::vector<const Program*> programs;
-    for (const std::unique_ptr<Program>& p : gPrograms) {
-        assert(p.get());
-        if (p->isEnabled) {
-            programs.push_back(p.get());
+    void archiveIfDone(Process* process) {
+        if (!hasEnded(process->status) || !gReleasedProcesses.contains(process->id.v)) {
+            return;
         }
+
+        // The newest process on each node is kept as the program buttons use it to
+        // restart the program on that node
+        const std::vector<Process*>& group = gProcessGroups[processKey(*process)];
+        if (newestProcessOnNode(group, process->nodeId) == process) {
+            return;
+        }
+
+        archiveProcess(process);
     }
-    return programs;
-}
 
-std::vector<const Process*> processes() {
-    std::vector<const Process*> processes;
-    for (const std::unique_ptr<Process>& p : gProcesses) {
-        assert(p.get());
-        processes.push_back(p.get());
+    std::uint64_t hashEntity(const Node& node) {
+        return common::HashBuilder()
+            .add(node.id.v)
+            .add(node.name)
+            .add(node.ipAddress)
+            .add(node.port)
+            .add(node.secret)
+            .value();
+    }
+
+    std::uint64_t hashEntity(const Cluster& cluster) {
+        common::HashBuilder hash;
+        hash.add(cluster.id.v).add(cluster.name).add(cluster.isEnabled);
+        hash.add(static_cast<std::uint64_t>(cluster.launchConcurrency));
+        hash.add(cluster.nodes.size());
+        for (const std::string& nodeName : cluster.nodes) {
+            const Node* node = gNodeIndex.find(nodeName);
+            assert(node);
+            hash.add(node->id.v);
+        }
+        return hash.value();
+    }
+
+    std::uint64_t hashEntity(const Program& program) {
+        const std::chrono::milliseconds delay =
+            program.delay.value_or(std::chrono::milliseconds(0));
+
+        common::HashBuilder hash;
+        hash.add(program.id.v)
+            .add(program.name)
+            .add(program.executable)
+            .add(program.commandlineParameters)
+            .add(program.workingDirectory)
+            .add(program.shouldForwardMessages)
+            .add(static_cast<int>(program.outputPolicy))
+            .add(program.outputOnDemand)
+            .add(program.shouldAutoRestart)
+            .add(program.isEnabled)
+            .add(program.delay.has_value())
+            .add(static_cast<std::int64_t>(delay.count()))
+            .add(program.preStart);
+
+        hash.add(program.tags.size());
+        for (const std::string& tag : program.tags) {
+            hash.add(tag);
+        }
+        hash.add(program.configurations.size());
+        for (const Program::Configuration& conf : program.configurations) {
+            hash.add(conf.id.v).add(conf.name).add(conf.parameters);
+        }
+        hash.add(program.clusters.size());
+        for (const Program::Cluster& cluster : program.clusters) {
+            const Cluster* c = gClusterIndex.find(cluster.name);
+            assert(c);
+            hash.add(c->id.v).add(cluster.parameters);
+        }
+        return hash.value();
+    }
+
+    std::uint64_t combineHashes(const std::map<int, std::uint64_t>& hashes) {
+        common::HashBuilder hash;
+        for (const auto& [id, h] : hashes) {
+            hash.add(id).add(h);
+        }
+        return hash.value();
+    }
+
+    // Updates the hashes of the \p updated and \p removed entities of one type and the
+    // combined hash for that type, without touching the hashes of all other entities
+    template <typename T>
+    void updateHashes(const common::EntityIndex<T>& index,
+                      const std::vector<typename T::ID>& updated,
+                      const std::vector<typename T::ID>& removed,
+                      std::map<int, std::uint64_t>& hashes, std::uint64_t& combined)
+    {
+        if (updated.empty() && removed.empty()) {
+            return;
+        }
+
+        for (typename T::ID id : removed) {
+            hashes.erase(id.v);
+        }
+        for (typename T::ID id : updated) {
+            const T* entity = index.find(id);
+            assert(entity);
+            hashes[id.v] = hashEntity(*entity);
+        }
+        combined = combineHashes(hashes);
+    }
+
+    void computeHashes() {
+        gNodeHashes.clear();
+        for (const std::unique_ptr<Node>& node : gNodes) {
+            gNodeHashes[node->id.v] = hashEntity(*node);
+        }
+        gNodesHash = combineHashes(gNodeHashes);
+
+        gClusterHashes.clear();
+        for (const std::unique_ptr<Cluster>& cluster : gClusters) {
+            gClusterHashes[cluster->id.v] = hashEntity(*cluster);
+        }
+        gClustersHash = combineHashes(gClusterHashes);
+
+        gProgramHashes.clear();
+        for (const std::unique_ptr<Program>& program : gPrograms) {
+            gProgramHashes[program->id.v] = hashEntity(*program);
+        }
+        gProgramsHash = combineHashes(gProgramHashes);
     }
-    return processes;
+
+    void updateDataHash() {
+        gDataHash = common::HashBuilder()
+            .add(gNodesHash)
+            .add(gClustersHash)
+            .add(gProgramsHash)
+            .value();
+    }
+
+    void rebuildLookups() {
+        gNodeIndex.clear();
+        for (const std::unique_ptr<Node>& node : gNodes) {
+            gNodeIndex.insert(node.get());
+        }
+
+        gClusterIndex.clear();
+        gClusterNodes.clear();
+        gNodeClusters.clear();
+        for (const std::unique_ptr<Cluster>& cluster : gClusters) {
+            std::vector<const Node*>& clusterNodes = gClusterNodes[cluster->id.v];
+            for (const std::string& nodeName : cluster->nodes) {
+                const Node* n = gNodeIndex.find(nodeName);
+                assert(n);
+                clusterNodes.push_back(n);
+
+                // A node that is listed multiple times should only list the cluster once
+                std::vector<const Cluster*>& nodeClusters = gNodeClusters[n->id.v];
+                if (nodeClusters.empty() || nodeClusters.back() != cluster.get()) {
+                    nodeClusters.push_back(cluster.get());
+                }
+            }
+            gClusterIndex.insert(cluster.get());
+        }
+
+        gProgramIndex.clear();
+        gTags.clear();
+        for (const std::unique_ptr<Program>& program : gPrograms) {
+            gProgramIndex.insert(program.get());
+            gTags.insert(program->tags.begin(), program->tags.end());
+        }
+    }
+
+    /**
+     * Assigns the identifiers of the \p current entities to the \p loaded entities with
+     * the same name and new identifiers, starting at \p nextId, to all others. Each of
+     * the current entities is only matched once, even if the names are not unique.
+     *
+     * \return The identifiers of the current entities that have no loaded counterpart
+     */
+    template <typename T>
+    std::vector<typename T::ID> matchByName(
+                                           const std::vector<std::unique_ptr<T>>& current,
+                                                                   std::vector<T>& loaded,
+                                                                              int& nextId)
+    {
+        std::multimap<std::string_view, typename T::ID, std::less<>> available;
+        for (const std::unique_ptr<T>& c : current) {
+            available.emplace(c->name, c->id);
+        }
+
+        for (T& entity : loaded) {
+            const auto it = available.lower_bound(entity.name);
+            if (it != available.end() && it->first == entity.name) {
+                entity.id = it->second;
+                available.erase(it);
+            }
+            else {
+                entity.id = typename T::ID(nextId);
+                nextId++;
+            }
+        }
+
+        std::vector<typename T::ID> removed;
+        removed.reserve(available.size());
+        for (const std::pair<const std::string_view, typename T::ID>& p : available) {
+            removed.push_back(p.second);
+        }
+        return removed;
+    }
+
+    /**
+     * Replaces the \p current entities with the \p loaded ones. Entities that existed
+     * before are overwritten in place so that pointers to them stay valid.
+     */
+    template <typename T>
+    void applyLoaded(std::vector<std::unique_ptr<T>>& current, std::vector<T> loaded) {
+        std::unordered_map<int, std::unique_ptr<T>> existing;
+        for (std::unique_ptr<T>& c : current) {
+            const int id = c->id.v;
+            existing[id] = std::move(c);
+        }
+        current.clear();
+
+        for (T& entity : loaded) {
+            const auto it = existing.find(entity.id.v);
+            if (it != existing.end()) {
+                *it->second = std::move(entity);
+                current.push_back(std::move(it->second));
+            }
+            else {
+                current.push_back(std::make_unique<T>(std::move(entity)));
+            }
+        }
+    }
+} // namespace
+
+namespace data {
+
+View<Cluster> clusters() {
+    return View<Cluster>(gClusters);
 }
 
-std::set<std::string> tags() {
+View<Node> nodes() {
+    return View<Node>(gNodes);
+}
+
+View<Program> programs() {
+    return View<Program>(gPrograms, [](const Program& p) { return p.isEnabled; });
+}
+
+View<Process> processes() {
+    return View<Process>(gProcesses);
+}
+
+const std::set<std::string>& tags() {
     return gTags;
 }
 
@@ -100,19 +413,11 @@ std::set<std::string> tags() {
 
 
 const Cluster* findCluster(Cluster::ID id) {
-    const auto it = std::find_if(
-        gClusters.begin(), gClusters.end(),
-        [id](const std::unique_ptr<Cluster>& c) { return c->id == id; }
-    );
-    return it != gClusters.end() ? it->get() : nullptr;
+    return gClusterIndex.find(id);
 }
 
 const Cluster* findCluster(std::string_view name) {
-    const auto it = std::find_if(
-        gClusters.begin(), gClusters.end(),
-        [name](const std::unique_ptr<Cluster>& c) { return c->name == name; }
-    );
-    return it != gClusters.end() ? it->get() : nullptr;
+    return gClusterIndex.find(name);
 }
 
 std::vector<const Cluster*> findClustersForProgram(const Program& program) {
@@ -126,33 +431,24 @@ std::vector<const Cluster*> findClustersForProgram(const Program& program) {
 }
 
 std::vector<const Cluster*> findClusterForNode(const Node& node) {
-    std::vector<const Cluster*> clusters;
-    for (const std::unique_ptr<Cluster>& cluster : gClusters) {
-        auto i = std::find(cluster->nodes.begin(), cluster->nodes.end(), node.name);
-        if (i != cluster->nodes.end()) {
-            clusters.push_back(cluster.get());
-        }
-    }
-    return clusters;
+    const auto it = gNodeClusters.find(node.id.v);
+    return it != gNodeClusters.end() ? it->second : std::vector<const Cluster*>();
 }
 
 const Node* findNode(Node::ID id) {
-    const auto it = std::find_if(
-        gNodes.begin(), gNodes.end(),
-        [id](const std::unique_ptr<Node>& n) { return n->id == id; }
-    );
-    return it != gNodes.end() ? it->get() : nullptr;
+    return gNodeIndex.find(id);
 }
 
 const Node* findNode(std::string_view name) {
-    const auto it = std::find_if(
-        gNodes.begin(), gNodes.end(),
-        [name](const std::unique_ptr<Node>& n) { return n->name == name; }
-    );
-    return it != gNodes.end() ? it->get() : nullptr;
+    return gNodeIndex.find(name);
 }
 
 std::vector<const Node*> findNodesForCluster(const Cluster& cluster) {
+    if (auto it = gClusterNodes.find(cluster.id.v);  it != gClusterNodes.end()) {
+        return it->second;
+    }
+
+    // The cluster is not part of the database, so we have to look up the nodes by name
     std::vector<const Node*> nodes;
     nodes.reserve(cluster.nodes.size());
     for (const std::string& nodeName : cluster.nodes) {
@@ -164,50 +460,30 @@ std::vector<const Node*> findNodesForCluster(const Cluster& cluster) {
 }
 
 void setNodeConnecting(Node::ID id, bool connected) {
-    const auto it = std::find_if(
-        gNodes.begin(), gNodes.end(),
-        [id](const std::unique_ptr<Node>& n) { return n->id == id; }
-    );
-    if (it != gNodes.end()) {
-        (*it)->isConnecting = connected;
+    if (Node* node = gNodeIndex.find(id);  node) {
+        node->isConnecting = connected;
     }
 }
 
 void setNodeConnected(Node::ID id, bool connected) {
-    const auto it = std::find_if(
-        gNodes.begin(), gNodes.end(),
-        [id](const std::unique_ptr<Node>& n) { return n->id == id; }
-    );
-    if (it != gNodes.end()) {
-        (*it)->isConnected = connected;
+    if (Node* node = gNodeIndex.find(id);  node) {
+        node->isConnected = connected;
     }
 }
 
 void setNodeDisconnecting(Node::ID id) {
-    const auto it = std::find_if(
-        gNodes.begin(), gNodes.end(),
-        [id](const std::unique_ptr<Node>& n) { return n->id == id; }
-    );
-    if (it != gNodes.end()) {
-        (*it)->isConnecting = false;
-        (*it)->isConnected = false;
+    if (Node* node = gNodeIndex.find(id);  node) {
+        node->isConnecting = false;
+        node->isConnected = false;
     }
 }
 
 const Program* findProgram(Program::ID id) {
-    const auto it = std::find_if(
-        gPrograms.begin(), gPrograms.end(),
-        [id](const std::unique_ptr<Program>& p) { return p->id == id; }
-    );
-    return it != gPrograms.end() ? it->get() : nullptr;
+    return gProgramIndex.find(id);
 }
 
 const Program* findProgram(std::string_view name) {
-    const auto it = std::find_if(
-        gPrograms.begin(), gPrograms.end(),
-        [name](const std::unique_ptr<Program>& p) { return p->name == name; }
-    );
-    return it != gPrograms.end() ? it->get() : nullptr;
+    return gProgramIndex.find(name);
 }
 
 const Program::Configuration* findConfigurationForProgram(const Program& program,
@@ -244,24 +520,63 @@ bool hasTag(Program::ID id, const std::vector<std::string>& tags) {
 }
 
 const Process* findProcess(Process::ID id) {
-    const auto it = std::find_if(
-        gProcesses.begin(), gProcesses.end(),
-        [id](const std::unique_ptr<Process>& p) { return p->id.v == id.v; }
-    );
-    return it != gProcesses.end() ? it->get() : nullptr;
+    return gProcessIndex.find(id);
+}
+
+std::vector<const Process*> findProcesses(Cluster::ID clusterId, Program::ID programId,
+                                          Program::Configuration::ID configurationId)
+{
+    const ProcessKey key = { clusterId.v, programId.v, configurationId.v };
+    const auto it = gProcessGroups.find(key);
+    if (it == gProcessGroups.end()) {
+        return {};
+    }
+    return std::vector<const Process*>(it->second.begin(), it->second.end());
 }
 
 void addProcess(std::unique_ptr<Process> process) {
+    std::vector<Process*>& group = gProcessGroups[processKey(*process)];
+    Process* previous = newestProcessOnNode(group, process->nodeId);
+    group.push_back(process.get());
+    gProcessIndex.insert(process.get());
     gProcesses.push_back(std::move(process));
+
+    // The previous process on the same node might only have been waiting for a newer one
+    if (previous) {
+        archiveIfDone(previous);
+    }
 }
 
 void setProcessStatus(Process::ID id, common::ProcessStatusMessage::Status status) {
+    if (Process* process = gProcessIndex.find(id);  process) {
+        process->status = status;
+        if (!hasEnded(status)) {
+            // The process was restarted and will be shown in the user interface again
+            gReleasedProcesses.erase(id.v);
+        }
+        archiveIfDone(process);
+    }
+}
+
+void releaseProcess(Process::ID id) {
+    if (Process* process = gProcessIndex.find(id);  process) {
+        gReleasedProcesses.insert(id.v);
+        archiveIfDone(process);
+    }
+}
+
+const ArchivedProcess* findArchivedProcess(Process::ID id) {
     const auto it = std::find_if(
-        gProcesses.begin(), gProcesses.end(),
-        [id](const std::unique_ptr<Process>& p) { return p->id.v == id.v; }
+        gArchivedProcesses.begin(), gArchivedProcesses.end(),
+        [id](const ArchivedProcess& p) { return p.id == id; }
     );
-    if (it != gProcesses.end()) {
-        (*it)->status = status;
+    return it != gArchivedProcesses.end() ? &(*it) : nullptr;
+}
+
+void setProcessHistory(std::size_t size) {
+    gProcessHistory = size;
+    while (gArchivedProcesses.size() > gProcessHistory) {
+        gArchivedProcesses.pop_front();
     }
 }
 
@@ -330,10 +645,14 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
     //  Nodes
     //
     gNodes.clear();
+    gNodeIndex.clear();
+    gClusterNodes.clear();
+    gNodeClusters.clear();
 
     std::vector<Node> nodes;
     try {
-        std::pair<std::vector<Node>, bool> res = loadNodesFromDirectory(nodePath);
+        std::pair<std::vector<Node>, bool> res =
+            loadNodesFromDirectory(nodePath, &gNodeFiles);
         nodes = res.first;
         loadingSucceeded &= res.second;
     }
@@ -343,6 +662,7 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
 
     for (Node& node : nodes) {
         std::unique_ptr<Node> n = std::make_unique<Node>(std::move(node));
+        gNodeIndex.insert(n.get());
         gNodes.push_back(std::move(n));
     }
 
@@ -351,11 +671,13 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
     //  Clusters
     //
     gClusters.clear();
+    gClusterIndex.clear();
 
     std::vector<Cluster> clusters;
     try {
         std::pair<std::vector<Cluster>, bool> res = loadClustersFromDirectory(
-            clusterPath
+            clusterPath,
+            &gClusterFiles
         );
         clusters = res.first;
         loadingSucceeded &= res.second;
@@ -380,6 +702,8 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
     }
 
     for (Cluster& cluster : clusters) {
+        std::vector<const Node*> clusterNodes;
+        clusterNodes.reserve(cluster.nodes.size());
         for (const std::string& node : cluster.nodes) {
             const Node* n = findNode(node);
             if (!n) {
@@ -387,9 +711,19 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
                     "Could not find node with name {}", node
                 ));
             }
+            clusterNodes.push_back(n);
         }
 
         std::unique_ptr<Cluster> c = std::make_unique<Cluster>(std::move(cluster));
+        for (const Node* n : clusterNodes) {
+            // A node that is listed multiple times should only list the cluster once
+            std::vector<const Cluster*>& nodeClusters = gNodeClusters[n->id.v];
+            if (nodeClusters.empty() || nodeClusters.back() != c.get()) {
+                nodeClusters.push_back(c.get());
+            }
+        }
+        gClusterNodes[c->id.v] = std::move(clusterNodes);
+        gClusterIndex.insert(c.get());
         gClusters.push_back(std::move(c));
     }
 
@@ -398,10 +732,12 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
     //  Programs
     //
     gPrograms.clear();
+    gProgramIndex.clear();
 
     std::vector<Program> programs;
     try {
-        std::pair<std::vector<Program>, bool> r = loadProgramsFromDirectory(programPath);
+        std::pair<std::vector<Program>, bool> r =
+            loadProgramsFromDirectory(programPath, &gProgramFiles);
         programs = r.first;
         loadingSucceeded &= r.second;
     }
@@ -425,75 +761,309 @@ bool loadData(std::string_view programPath, std::string_view clusterPath,
             gTags.insert(tag);
         }
 
+        gProgramIndex.insert(p.get());
         gPrograms.push_back(std::move(p));
     }
 
+    gNextNodeId = static_cast<int>(gNodes.size());
+    gNextClusterId = static_cast<int>(gClusters.size());
+    gNextProgramId = static_cast<int>(gPrograms.size());
+
     // Calculate the hash of all the data that was just loaded
-    std::size_t hash = 0;
+    computeHashes();
+    updateDataHash();
 
-    auto addHash = [&hash](std::size_t rhs) {
-        // Based on boost:hash_combine (Golden Ratio Hashing)
-        // The Art of Computer Programming: Volume 3: Sorting and Searching
+    return loadingSucceeded;
+}
 
-        // Unfortunately, sqrt is not constexpr (it will be in CPP26), so:
-        // constexpr double phi = (std::sqrt(5) - 1.0) / 2.0;
-        // constexpr double salt = round(phi * std::numeric_limits<uint_32>::max());
-        // constexpr uint32_t hashConstant = static_cast<uint32_t>(salt);
-        constexpr uint32_t hashConstant = 0x9e3779b9;
+DataChanges reloadData(std::string_view programPath, std::string_view clusterPath,
+                       std::string_view nodePath)
+{
+    // Nothing in the database is modified until all of the files were loaded and checked
+    // so that a file that is only partially written does not tear down the current data.
+    // This includes the file caches, which would otherwise be saved with the rejected
+    // contents of the files
+    common::JsonFileCache<Node> nodeFiles = gNodeFiles;
+    common::JsonFileCache<Cluster> clusterFiles = gClusterFiles;
+    common::JsonFileCache<Program> programFiles = gProgramFiles;
+    std::pair<std::vector<Node>, bool> nodes =
+        loadNodesFromDirectory(nodePath, &nodeFiles);
+    std::pair<std::vector<Cluster>, bool> clusters =
+        loadClustersFromDirectory(clusterPath, &clusterFiles);
+    std::pair<std::vector<Program>, bool> programs =
+        loadProgramsFromDirectory(programPath, &programFiles);
+    if (!nodes.second || !clusters.second || !programs.second) {
+        throw std::runtime_error("Not all data files could be loaded");
+    }
 
-        hash ^= rhs + hashConstant + (hash << 6) + (hash >> 2);
-    };
+    // The clusters are sorted by name in the same way as in loadData, so that their order
+    // does not depend on whether they were loaded initially or reloaded later
+    std::sort(
+        clusters.first.begin(), clusters.first.end(),
+        [](const Cluster& lhs, const Cluster& rhs) { return lhs.name < rhs.name; }
+    );
 
-    // Clusters
-    for (const std::unique_ptr<Cluster>& cluster : gClusters) {
-        addHash(std::hash<int>()(cluster->id.v));
-        addHash(std::hash<std::string>()(cluster->name));
-        addHash(std::hash<bool>()(cluster->isEnabled));
-        for (const std::string& nodeName : cluster->nodes) {
-            const Node* node = findNode(nodeName);
-            addHash(std::hash<int>()(node->id.v));
+    std::set<std::string_view> nodeNames;
+    for (const Node& node : nodes.first) {
+        nodeNames.insert(node.name);
+    }
+    std::set<std::string_view> clusterNames;
+    for (const Cluster& cluster : clusters.first) {
+        if (!clusterNames.insert(cluster.name).second) {
+            throw std::runtime_error(std::format(
+                "Duplicate cluster name '{}' found", cluster.name
+            ));
+        }
+        for (const std::string& node : cluster.nodes) {
+            if (!nodeNames.contains(node)) {
+                throw std::runtime_error(std::format(
+                    "Could not find node with name {}", node
+                ));
+            }
+        }
+    }
+    for (const Program& program : programs.first) {
+        for (const Program::Cluster& cluster : program.clusters) {
+            if (!clusterNames.contains(cluster.name)) {
+                throw std::runtime_error(std::format(
+                    "Could not find cluster '{}'", cluster.name
+                ));
+            }
         }
     }
 
-    // Nodes
-    for (const std::unique_ptr<Node>& node : gNodes) {
-        addHash(std::hash<int>()(node->id.v));
-        addHash(std::hash<std::string>()(node->name));
-        addHash(std::hash<std::string>()(node->ipAddress));
-        addHash(std::hash<int>()(node->port));
-        addHash(std::hash<std::string>()(node->secret));
-        addHash(std::hash<bool>()(node->isConnected));
+    //
+    //  Find the differences to the current data
+    //
+    DataChanges changes;
+    int nextNodeId = gNextNodeId;
+    int nextClusterId = gNextClusterId;
+    int nextProgramId = gNextProgramId;
+    changes.removedNodes = matchByName(gNodes, nodes.first, nextNodeId);
+    changes.removedClusters = matchByName(gClusters, clusters.first, nextClusterId);
+    changes.removedPrograms = matchByName(gPrograms, programs.first, nextProgramId);
+
+    for (Node& node : nodes.first) {
+        const Node* current = gNodeIndex.find(node.id);
+        if (!current) {
+            changes.addedNodes.push_back(node.id);
+            continue;
+        }
+
+        // The connection state is not part of the files on disk
+        node.isConnecting = current->isConnecting;
+        node.isConnected = current->isConnected;
+        if (node != *current) {
+            changes.changedNodes.push_back(node.id);
+            if (node.ipAddress != current->ipAddress || node.port != current->port ||
+                node.secret != current->secret)
+            {
+                changes.reconnectedNodes.push_back(node.id);
+            }
+        }
     }
 
-    // Programs
-    for (const std::unique_ptr<Program>& program : gPrograms) {
-        addHash(std::hash<int>()(program->id.v));
-        addHash(std::hash<std::string>()(program->name));
-        addHash(std::hash<std::string>()(program->executable));
-        addHash(std::hash<std::string>()(program->commandlineParameters));
-        addHash(std::hash<std::string>()(program->workingDirectory));
-        for (const std::string& tag : program->tags) {
-            addHash(std::hash<std::string>()(tag));
+    for (const Cluster& cluster : clusters.first) {
+        const Cluster* current = gClusterIndex.find(cluster.id);
+        if (!current) {
+            changes.addedClusters.push_back(cluster.id);
         }
-        for (const Program::Configuration& conf : program->configurations) {
-            addHash(std::hash<int>()(conf.id.v));
-            addHash(std::hash<std::string>()(conf.name));
-            addHash(std::hash<std::string>()(conf.parameters));
+        else if (cluster != *current) {
+            changes.changedClusters.push_back(cluster.id);
         }
-        for (const Program::Cluster& cluster : program->clusters) {
-            const Cluster* c = findCluster(cluster.name);
-            addHash(std::hash<int>()(c->id.v));
-            addHash(std::hash<std::string>()(cluster.parameters));
+    }
+
+    for (Program& program : programs.first) {
+        const Program* current = gProgramIndex.find(program.id);
+        if (!current) {
+            changes.addedPrograms.push_back(program.id);
+            continue;
+        }
+
+        // The configurations are matched by name in the same way as the programs so
+        // that running processes keep pointing at the same configuration
+        std::vector<std::unique_ptr<Program::Configuration>> confs;
+        int nextConfigurationId = 0;
+        for (const Program::Configuration& conf : current->configurations) {
+            confs.push_back(std::make_unique<Program::Configuration>(conf));
+            nextConfigurationId = std::max(nextConfigurationId, conf.id.v + 1);
+        }
+        matchByName(confs, program.configurations, nextConfigurationId);
+
+        if (program != *current) {
+            changes.changedPrograms.push_back(program.id);
         }
     }
 
-    gDataHash = hash;
+    //
+    //  Check the processes that belong to removed entities
+    //
+    auto contains = []<typename ID>(const std::vector<ID>& ids, ID id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+    for (const std::unique_ptr<Process>& process : gProcesses) {
+        bool isRemoved =
+            contains(changes.removedNodes, process->nodeId) ||
+            contains(changes.removedClusters, process->clusterId) ||
+            contains(changes.removedPrograms, process->programId);
+        if (!isRemoved) {
+            const auto it = std::find_if(
+                programs.first.begin(), programs.first.end(),
+                [id = process->programId](const Program& p) { return p.id == id; }
+            );
+            assert(it != programs.first.end());
+            isRemoved = !findConfigurationForProgram(*it, process->configurationId);
+        }
 
-    return loadingSucceeded;
+        if (!isRemoved) {
+            continue;
+        }
+        if (!hasEnded(process->status)) {
+            throw std::runtime_error(std::format(
+                "Process {} is still running and uses data that would be removed",
+                process->id.v
+            ));
+        }
+        changes.removedProcesses.push_back(process->id);
+    }
+
+    //
+    //  Apply the changes
+    //
+    for (Process::ID id : changes.removedProcesses) {
+        archiveProcess(gProcessIndex.find(id));
+    }
+
+    gNodeFiles = std::move(nodeFiles);
+    gClusterFiles = std::move(clusterFiles);
+    gProgramFiles = std::move(programFiles);
+
+    applyLoaded(gNodes, std::move(nodes.first));
+    applyLoaded(gClusters, std::move(clusters.first));
+    applyLoaded(gPrograms, std::move(programs.first));
+    gNextNodeId = nextNodeId;
+    gNextClusterId = nextClusterId;
+    gNextProgramId = nextProgramId;
+
+    rebuildLookups();
+
+    // Only the entities that were added or changed have to be hashed again
+    auto concat = []<typename ID>(std::vector<ID> lhs, const std::vector<ID>& rhs) {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return lhs;
+    };
+    updateHashes(
+        gNodeIndex,
+        concat(changes.addedNodes, changes.changedNodes),
+        changes.removedNodes,
+        gNodeHashes,
+        gNodesHash
+    );
+    updateHashes(
+        gClusterIndex,
+        concat(changes.addedClusters, changes.changedClusters),
+        changes.removedClusters,
+        gClusterHashes,
+        gClustersHash
+    );
+    updateHashes(
+        gProgramIndex,
+        concat(changes.addedPrograms, changes.changedPrograms),
+        changes.removedPrograms,
+        gProgramHashes,
+        gProgramsHash
+    );
+    updateDataHash();
+
+    return changes;
 }
 
-std::size_t dataHash() {
+bool DataChanges::empty() const {
+    return addedNodes.empty() && changedNodes.empty() && removedNodes.empty() &&
+        addedClusters.empty() && changedClusters.empty() && removedClusters.empty() &&
+        addedPrograms.empty() && changedPrograms.empty() && removedPrograms.empty();
+}
+
+void loadDataCache(std::string_view path) {
+    gNodeFiles.entries.clear();
+    gClusterFiles.entries.clear();
+    gProgramFiles.entries.clear();
+
+    std::ifstream f = std::ifstream(std::string(path), std::ios::binary);
+    if (!f.good()) {
+        return;
+    }
+
+    try {
+        const std::vector<std::uint8_t> content = std::vector<std::uint8_t>(
+            std::istreambuf_iterator<char>(f),
+            std::istreambuf_iterator<char>()
+        );
+        const nlohmann::json j = nlohmann::json::from_cbor(content);
+        if (j.at(KeyCacheVersion).get<int>() != DataCacheVersion) {
+            Log("Status", std::format("Ignoring outdated data cache '{}'", path));
+            return;
+        }
+
+        j.at(KeyCacheNodes).get_to(gNodeFiles);
+        j.at(KeyCacheClusters).get_to(gClusterFiles);
+        j.at(KeyCachePrograms).get_to(gProgramFiles);
+    }
+    catch (const std::exception& e) {
+        Log("Warning", std::format("Ignoring data cache '{}': {}", path, e.what()));
+        gNodeFiles.entries.clear();
+        gClusterFiles.entries.clear();
+        gProgramFiles.entries.clear();
+    }
+}
+
+void saveDataCache(std::string_view path) {
+    nlohmann::json j;
+    j[KeyCacheVersion] = DataCacheVersion;
+    j[KeyCacheNodes] = gNodeFiles;
+    j[KeyCacheClusters] = gClusterFiles;
+    j[KeyCachePrograms] = gProgramFiles;
+    const std::vector<std::uint8_t> content = nlohmann::json::to_cbor(j);
+
+    // Write to a temporary file first so that an interrupted write does not leave a
+    // broken cache behind
+    const std::string tmp = std::format("{}.tmp", path);
+    {
+        std::ofstream f = std::ofstream(tmp, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(content.data()), content.size());
+        if (!f.good()) {
+            Log("Warning", std::format("Could not write data cache '{}'", path));
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        Log(
+            "Warning",
+            std::format("Could not write data cache '{}': {}", path, ec.message())
+        );
+    }
+}
+
+std::uint64_t dataHash() {
     return gDataHash;
 }
 
+std::uint64_t nodeHash(Node::ID id) {
+    const auto it = gNodeHashes.find(id.v);
+    return it != gNodeHashes.end() ? it->second : 0;
+}
+
+std::uint64_t clusterHash(Cluster::ID id) {
+    const auto it = gClusterHashes.find(id.v);
+    return it != gClusterHashes.end() ? it->second : 0;
+}
+
+std::uint64_t programHash(Program::ID id) {
+    const auto it = gProgramHashes.find(id.v);
+    return it != gProgramHashes.end() ? it->second : 0;
+}
+
 } // namespace data
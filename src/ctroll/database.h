@@ -40,6 +40,9 @@
 #include "node.h"
 #include "process.h"
 #include "program.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <string>
@@ -48,11 +51,110 @@
 
 namespace data {
 
-[[nodiscard]] std::vector<const Cluster*> clusters();
-[[nodiscard]] std::vector<const Node*> nodes();
-[[nodiscard]] std::vector<const Program*> programs();
-[[nodiscard]] std::vector<const Process*> processes();
-[[nodiscard]] std::set<std::string> tags();
+/**
+ * A view of the entities of type \tparam T that are stored in the database, which yields
+ * a `const T*` for each entity that passes the optional filter. The view does not copy
+ * anything and is only valid until the next time entities of this type are added or
+ * removed, so the database must not be modified while iterating over it.
+ */
+template <typename T>
+class View {
+public:
+    using Storage = std::vector<std::unique_ptr<T>>;
+    using Filter = bool (*)(const T&);
+
+    class Iterator {
+    public:
+        using Base = typename Storage::const_iterator;
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = const T*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T* const*;
+        using reference = const T*;
+
+        Iterator() = default;
+        Iterator(Base it, Base end, Filter filter)
+            : _it(it)
+            , _end(end)
+            , _filter(filter)
+        {
+            skipFiltered();
+        }
+
+        const T* operator*() const { return _it->get(); }
+        Iterator& operator++() { ++_it; skipFiltered(); return *this; }
+        Iterator operator++(int) { Iterator res = *this; ++(*this); return res; }
+        bool operator==(const Iterator& rhs) const { return _it == rhs._it; }
+
+    private:
+        void skipFiltered() {
+            while (_filter && _it != _end && !_filter(**_it)) {
+                ++_it;
+            }
+        }
+
+        Base _it;
+        Base _end;
+        Filter _filter = nullptr;
+    };
+
+    explicit View(const Storage& storage, Filter filter = nullptr)
+        : _storage(&storage)
+        , _filter(filter)
+    {}
+
+    Iterator begin() const {
+        return Iterator(_storage->begin(), _storage->end(), _filter);
+    }
+    Iterator end() const { return Iterator(_storage->end(), _storage->end(), _filter); }
+    bool empty() const { return begin() == end(); }
+
+private:
+    const Storage* _storage;
+    Filter _filter;
+};
+
+/// The record that is kept of a finished process after it was removed from the database
+struct ArchivedProcess {
+    Process::ID id;
+    Program::ID programId;
+    Program::Configuration::ID configurationId;
+    Cluster::ID clusterId;
+    Node::ID nodeId;
+    common::ProcessStatusMessage::Status status;
+};
+
+/// The entities that were added, changed, or removed when the data was reloaded. The
+/// identifiers of entities that exist before and after the reload do not change
+struct DataChanges {
+    [[nodiscard]] bool empty() const;
+
+    std::vector<Node::ID> addedNodes;
+    std::vector<Node::ID> changedNodes;
+    /// The subset of the changed nodes whose address or secret changed and that need to
+    /// be connected to again
+    std::vector<Node::ID> reconnectedNodes;
+    std::vector<Node::ID> removedNodes;
+
+    std::vector<Cluster::ID> addedClusters;
+    std::vector<Cluster::ID> changedClusters;
+    std::vector<Cluster::ID> removedClusters;
+
+    std::vector<Program::ID> addedPrograms;
+    std::vector<Program::ID> changedPrograms;
+    std::vector<Program::ID> removedPrograms;
+
+    /// The finished processes that were archived as they belonged to a removed entity
+    std::vector<Process::ID> removedProcesses;
+};
+
+[[nodiscard]] View<Cluster> clusters();
+[[nodiscard]] View<Node> nodes();
+/// Returns only the programs that are enabled
+[[nodiscard]] View<Program> programs();
+[[nodiscard]] View<Process> processes();
+[[nodiscard]] const std::set<std::string>& tags();
 
 [[nodiscard]] const Cluster* findCluster(Cluster::ID id);
 [[nodiscard]] const Cluster* findCluster(std::string_view name);
@@ -77,16 +179,69 @@ void setNodeDisconnecting(Node::ID id);
 [[nodiscard]] bool hasTag(Program::ID id, const std::vector<std::string>& tags);
 
 [[nodiscard]] const Process* findProcess(Process::ID id);
+[[nodiscard]] std::vector<const Process*> findProcesses(Cluster::ID clusterId,
+    Program::ID programId, Program::Configuration::ID configurationId);
 void addProcess(std::unique_ptr<Process> process);
 void setProcessStatus(Process::ID id, common::ProcessStatusMessage::Status status);
 
+// A process is moved into the archive once it has finished, it was released by the user
+// interface, and a newer process was started for the same program on the same node.
+// After that, it can no longer be found through `findProcess`
+void releaseProcess(Process::ID id);
+[[nodiscard]] const ArchivedProcess* findArchivedProcess(Process::ID id);
+void setProcessHistory(std::size_t size);
+
 [[nodiscard]] Color colorForTag(std::string_view tag);
 void setTagColors(std::vector<Color> colors);
 
 [[nodiscard]] bool loadData(std::string_view programPath, std::string_view clusterPath,
     std::string_view nodePath);
 
-[[nodiscard]] std::size_t dataHash();
+/**
+ * Loads the data from the same directories as loadData, but only parses the files that
+ * changed since the last load and updates the existing entities in place. Entities are
+ * matched by their name and keep their identifier. If any of the files fail to load, or
+ * if an entity would be removed that is still used by a process that has not finished,
+ * an exception is thrown and the current data is left untouched.
+ *
+ * \return The list of entities that were added, changed, or removed by the reload
+ * \throw std::runtime_error If the new data could not be loaded or is inconsistent
+ */
+[[nodiscard]] DataChanges reloadData(std::string_view programPath,
+    std::string_view clusterPath, std::string_view nodePath);
+
+/**
+ * Reads the parsed files that were stored by saveDataCache in an earlier run, so that
+ * the next loadData only has to parse and validate the files that changed since then.
+ * A cache that is missing, unreadable, or was written by a different version is ignored.
+ *
+ * \param path The path to the file that was written by saveDataCache
+ */
+void loadDataCache(std::string_view path);
+
+/**
+ * Writes the parsed files from the last call to loadData or reloadData to the binary
+ * file at \p path, so that they can be reused by loadDataCache on the next start.
+ *
+ * \param path The path to the file that is created or overwritten
+ */
+void saveDataCache(std::string_view path);
+
+/**
+ * Returns the hash over all nodes, clusters, and programs. In contrast to std::hash, the
+ * value only depends on the data and not on the compiler or the platform, so two
+ * controllers that loaded the same data files will always have the same hash.
+ */
+[[nodiscard]] std::uint64_t dataHash();
+
+/**
+ * Returns the hash of an individual entity, which only changes if the entity itself was
+ * changed, or 0 if there is no entity with the \p id. These hashes are combined into
+ * the dataHash.
+ */
+[[nodiscard]] std::uint64_t nodeHash(Node::ID id);
+[[nodiscard]] std::uint64_t clusterHash(Cluster::ID id);
+[[nodiscard]] std::uint64_t programHash(Program::ID id);
 
 } // namespace data
 
@@ -64,5 +64,9 @@ LogWidget::LogWidget() {
 }
 
 void LogWidget::appendMessage(std::string msg) {
-    _message.append(QString::fromStdString(std::move(msg)));
+    _message.appendMessage(std::move(msg));
+}
+
+void LogWidget::setMaxLines(std::size_t maxLines) {
+    _message.setMaxLines(maxLines);
 }
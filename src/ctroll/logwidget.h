@@ -37,7 +37,7 @@
 
 #include <QWidget>
 
-#include <QTextEdit>
+#include "logview.h"
 #include <string>
 
 class LogWidget : public QWidget {
@@ -45,9 +45,10 @@ public:
     LogWidget();
 
     void appendMessage(std::string msg);
+    void setMaxLines(std::size_t maxLines);
 
 private:
-    QTextEdit _message;
+    common::LogView _message;
 };
 
 #endif // __CTROLL__LOGWIDGET_H__
@@ -202,6 +202,7 @@ int main(int argc, char** argv) {
     }
 
     common::Log::initialize("ctroll", config.logFile, logDebug);
+    common::applyLogLevels(config.logLevels);
     Log("Config", std::format("Finished loading configuration file '{}'", cfg));
 
 
@@ -56,7 +56,6 @@
 #include <numeric>
 #include <set>
 #include <string_view>
-#include <thread>
 
 MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration config)
     : _trayIcon(QIcon(":/images/C_transparent.png"), this)
@@ -145,11 +144,17 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
         exit(EXIT_FAILURE);
     }
 
+    if (!config.dataCache.empty()) {
+        data::loadDataCache(config.dataCache);
+    }
     bool success = data::loadData(
         config.applicationPath,
         config.clusterPath,
         config.nodePath
     );
+    if (!config.dataCache.empty()) {
+        data::saveDataCache(config.dataCache);
+    }
     if (!success) {
         QMessageBox::critical(
             nullptr,
@@ -158,6 +163,8 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
         );
     }
     data::setTagColors(config.tagColors);
+    data::setProcessHistory(config.processHistory);
+    _logWidget.setMaxLines(config.logLines);
 
     if (config.logRotation.has_value()) {
         const bool keepLog = config.logRotation->keepPrevious;
@@ -232,6 +239,14 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
         &_clusterConnectionHandler, &ClusterConnectionHandler::connectedStatusChanged,
         _clustersWidget, &ClustersWidget::connectedStatusChanged
     );
+    connect(
+        &_clusterConnectionHandler, &ClusterConnectionHandler::connectedStatusChanged,
+        this, &MainWindow::handleNodeConnectionChanged
+    );
+    connect(
+        &_clusterConnectionHandler, &ClusterConnectionHandler::heartbeatStatisticsChanged,
+        _clustersWidget, &ClustersWidget::heartbeatStatisticsChanged
+    );
     connect(
         _clustersWidget, QOverload<Node::ID>::of(&ClustersWidget::killProcesses),
         this, QOverload<Node::ID>::of(&MainWindow::killAllProcesses)
@@ -260,7 +275,10 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
     );
 
     // Processes
-    _processesWidget = new ProcessesWidget(config.removalTimeout);
+    _processesWidget = new ProcessesWidget(
+        config.removalTimeout,
+        config.processOutput
+    );
     connect(
         &_clusterConnectionHandler, &ClusterConnectionHandler::receivedTrayProcess,
         this, &MainWindow::handleTrayProcess
@@ -285,6 +303,10 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
         _processesWidget, &ProcessesWidget::killProcess,
         this, &MainWindow::stopProcess
     );
+    connect(
+        _processesWidget, &ProcessesWidget::fetchProcessOutput,
+        this, &MainWindow::fetchProcessOutput
+    );
     connect(
         _processesWidget, &ProcessesWidget::killAllProcesses,
         [this]() { killAllProcesses(Cluster::ID(-1)); }
@@ -297,7 +319,7 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
     tabWidget->addTab(&_logWidget, "Log");
     tabWidget->addTab(new SettingsWidget(config, "config.json"), "Settings");
 
-    _clusterConnectionHandler.initialize();
+    _clusterConnectionHandler.initialize(config.heartbeat, config.socket);
 
 
     if (config.restLoopback.has_value()) {
@@ -309,6 +331,11 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
             config.restLoopback->password,
             config.restLoopback->allowCustomPrograms
         );
+        _restLoopbackHandler->setHeartbeatSource(
+            [this](Node::ID id) {
+                return _clusterConnectionHandler.heartbeatStatistics(id);
+            }
+        );
 
         connect(
             _restLoopbackHandler, &RestConnectionHandler::startProgram,
@@ -333,6 +360,11 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
             config.restGeneral->password,
             config.restGeneral->allowCustomPrograms
         );
+        _restGeneralHandler->setHeartbeatSource(
+            [this](Node::ID id) {
+                return _clusterConnectionHandler.heartbeatStatistics(id);
+            }
+        );
 
         connect(
             _restGeneralHandler, &RestConnectionHandler::startProgram,
@@ -350,13 +382,26 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
 
     auto maybeShowMessages = [this]() {
         if (_shouldShowDifferentDataHashMessage) {
-            constexpr const char* Text = "Received information from a tray about a "
-                "running process that was started from a controller with a different set "
-                "of configurations. Depending on what was changed this might lead to "
-                "very strange behavior";
-            _trayIcon.showMessage("Different Data", Text, QSystemTrayIcon::Warning);
-            Log("Warning", Text);
+            std::string text = "Received information from a tray about a running "
+                "process that was started from a controller with a different set of "
+                "configurations";
+            if (!_differentDataEntities.empty()) {
+                std::string entities;
+                for (const std::string& entity : _differentDataEntities) {
+                    entities += entities.empty() ? entity : std::format(", {}", entity);
+                }
+                text += std::format(". The following entries differ: {}", entities);
+            }
+            text += ". Depending on what was changed this might lead to very strange "
+                "behavior";
+            _trayIcon.showMessage(
+                "Different Data",
+                QString::fromStdString(text),
+                QSystemTrayIcon::Warning
+            );
+            Log("Warning", text);
             _shouldShowDifferentDataHashMessage = false;
+            _differentDataEntities.clear();
         }
     };
 
@@ -370,7 +415,22 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
     // Don't want to wait 5 seconds for the first message, so we check once after 250ms
     QTimer::singleShot(std::chrono::milliseconds(250), maybeShowMessages);
 
-    // Notify the user if configuration files have changed
+    // Starts the processes of the programs that are rolled out across the nodes
+    _launchTimer = new QTimer(this);
+    _launchTimer->setSingleShot(true);
+    connect(_launchTimer, &QTimer::timeout, this, &MainWindow::updateLaunches);
+
+    // Reload the configuration files when they have changed on disk
+    _applicationPath = config.applicationPath;
+    _clusterPath = config.clusterPath;
+    _nodePath = config.nodePath;
+    _dataCachePath = config.dataCache;
+
+    _reloadTimer = new QTimer(this);
+    _reloadTimer->setSingleShot(true);
+    _reloadTimer->setInterval(std::chrono::milliseconds(500));
+    connect(_reloadTimer, &QTimer::timeout, this, &MainWindow::reloadData);
+
     _watcher.addPaths({
         QString::fromStdString(config.applicationPath),
         QString::fromStdString(config.clusterPath),
@@ -395,12 +455,8 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
     connect(
         &_watcher, &QFileSystemWatcher::directoryChanged,
         [this, watchAllFilesInFolder](const QString& path) {
-            constexpr const char* Text = "The data files on disk have changed. This "
-                "change is not reflected until C-Troll is restarted.";
-            _trayIcon.showMessage("New Data", Text);
-            Log("Info", Text);
-
             watchAllFilesInFolder(path.toStdString());
+            _reloadTimer->start();
         }
     );
     connect(
@@ -411,15 +467,78 @@ MainWindow::MainWindow(std::vector<std::string> defaultTags, Configuration confi
                 // case we have to continue watching it
                 _watcher.addPath(path);
             }
-
-            constexpr const char* Text = "The data files on disk have changed. This "
-                "change is not reflected until C-Troll is restarted.";
-            Log("Info", Text);
-            _trayIcon.showMessage("New Data", Text);
+            _reloadTimer->start();
         }
     );
 }
 
+void MainWindow::reloadData() {
+    Log("Status", "Reloading the data files that have changed");
+
+    data::DataChanges changes;
+    try {
+        changes = data::reloadData(_applicationPath, _clusterPath, _nodePath);
+    }
+    catch (const std::exception& e) {
+        std::string text = std::format(
+            "The data files on disk have changed, but could not be loaded: {}. The "
+            "previous data is used until the files are fixed", e.what()
+        );
+        Log("Error", text);
+        _trayIcon.showMessage(
+            "New Data",
+            QString::fromStdString(text),
+            QSystemTrayIcon::Warning
+        );
+        return;
+    }
+
+    if (!_dataCachePath.empty()) {
+        data::saveDataCache(_dataCachePath);
+    }
+
+    if (changes.empty()) {
+        Log("Status", "The data files on disk have not changed");
+        return;
+    }
+
+    for (Process::ID id : changes.removedProcesses) {
+        _processesWidget->processRemoved(id);
+    }
+
+    // Only the trays whose nodes were added, removed, or have a different address are
+    // connected to again, all other connections are kept
+    for (Node::ID id : changes.removedNodes) {
+        _clusterConnectionHandler.removeNode(id);
+    }
+    for (Node::ID id : changes.reconnectedNodes) {
+        _clusterConnectionHandler.removeNode(id);
+        const Node* node = data::findNode(id);
+        assert(node);
+        _clusterConnectionHandler.addNode(*node);
+    }
+    for (Node::ID id : changes.addedNodes) {
+        const Node* node = data::findNode(id);
+        assert(node);
+        _clusterConnectionHandler.addNode(*node);
+    }
+
+    _clustersWidget->applyChanges(changes);
+    _programWidget->applyChanges(changes);
+
+    std::string text = std::format(
+        "Reloaded the data files. Nodes: {} added, {} changed, {} removed. Clusters: {} "
+        "added, {} changed, {} removed. Programs: {} added, {} changed, {} removed",
+        changes.addedNodes.size(), changes.changedNodes.size(),
+        changes.removedNodes.size(), changes.addedClusters.size(),
+        changes.changedClusters.size(), changes.removedClusters.size(),
+        changes.addedPrograms.size(), changes.changedPrograms.size(),
+        changes.removedPrograms.size()
+    );
+    Log("Info", text);
+    _trayIcon.showMessage("New Data", QString::fromStdString(text));
+}
+
 void MainWindow::log(std::string msg) {
     _logWidget.appendMessage(std::move(msg));
 }
@@ -437,11 +556,23 @@ void MainWindow::handleTrayProcess(common::ProcessStatusMessage status) {
         // This state might happen if C-Troll was restarted while programs were
         // still running on the trays, if we than issue a killall command, we are
         // handed back a process id that we don't know.
+        if (data::findArchivedProcess(Process::ID(status.processId))) {
+            Log(
+                "Status",
+                std::format("Ignoring status of archived process {}", status.processId)
+            );
+        }
         return;
     }
 
     data::setProcessStatus(process->id, status.status);
 
+    // Once the tray reports that the process has started or failed, the next node of
+    // its rollout can be started
+    if (status.status != common::ProcessStatusMessage::Status::Starting) {
+        forgetLaunch(process->id);
+    }
+
     // The process was already known to us, which should always be the case
     _processesWidget->processUpdated(process->id);
     _programWidget->processUpdated(process->id);
@@ -495,7 +626,39 @@ void MainWindow::handleTrayStatus(Node::ID, common::TrayStatusMessage status) {
         }
 
         if (pi.dataHash != data::dataHash()) {
-            _shouldShowDifferentDataHashMessage = true;
+            const Program::ID programId = Program::ID(pi.programId);
+            const Cluster::ID clusterId = Cluster::ID(pi.clusterId);
+            const Node::ID nodeId = Node::ID(pi.nodeId);
+
+            if (pi.programHash == 0 && pi.clusterHash == 0 && pi.nodeHash == 0) {
+                // The process was started by a C-Troll that did not send the hashes of
+                // the individual entries, so we can't tell what is different
+                _shouldShowDifferentDataHashMessage = true;
+            }
+            else {
+                // Changes to entries that this process does not use don't matter
+                auto describe = [](std::string_view type, const auto* entity, int id) {
+                    return entity ?
+                        std::format("{} '{}'", type, entity->name) :
+                        std::format("{} {} (removed)", type, id);
+                };
+                if (pi.programHash != data::programHash(programId)) {
+                    _differentDataEntities.insert(describe(
+                        "program", data::findProgram(programId), pi.programId
+                    ));
+                }
+                if (pi.clusterHash != data::clusterHash(clusterId)) {
+                    _differentDataEntities.insert(describe(
+                        "cluster", data::findCluster(clusterId), pi.clusterId
+                    ));
+                }
+                if (pi.nodeHash != data::nodeHash(nodeId)) {
+                    _differentDataEntities.insert(describe(
+                        "node", data::findNode(nodeId), pi.nodeId
+                    ));
+                }
+                _shouldShowDifferentDataHashMessage |= !_differentDataEntities.empty();
+            }
         }
 
         std::unique_ptr<Process> process = std::make_unique<Process>(
@@ -552,30 +715,158 @@ void MainWindow::startProgram(Cluster::ID clusterId, Program::ID programId,
     const Program* p = data::findProgram(programId);
     assert(p);
 
-    // If the program has a preStart script, we need to execute it first and wait until it
-    // is finished
-    if (!p->preStart.empty()) {
+    // The processes are started one node after another by the launch scheduler, which
+    // applies the delay of the program and the concurrency limit of the cluster without
+    // blocking the user interface or the network connections in the meantime
+    common::LaunchScheduler::Rollout rollout = {
+        .group = clusterId.v,
+        .delay = p->delay.value_or(std::chrono::milliseconds(0))
+    };
+    for (const std::string& nodeName : cluster->nodes) {
+        const Node* node = data::findNode(nodeName);
+        assert(node);
+        rollout.items.push_back(node->id.v);
+    }
+    _launches.setLimit(clusterId.v, cluster->launchConcurrency);
+
+    // If the program has a preStart script, we need to execute it first and only start
+    // the processes once it is finished
+    const bool hasPreStart = !p->preStart.empty();
+    const auto now = common::LaunchScheduler::Clock::now();
+    const int rolloutId = _launches.add(std::move(rollout), now, hasPreStart);
+    Rollout& r = _rollouts[rolloutId];
+    r.clusterId = clusterId;
+    r.programId = programId;
+    r.configurationId = configId;
+
+    if (hasPreStart) {
         Log("Program", "Starting pre-start script");
-        QProcess proc;
-        proc.start(QString::fromStdString(p->preStart));
-        proc.waitForFinished(-1);
+        QProcess* proc = new QProcess(this);
+        r.preStart = proc;
+
+        auto finished = [this, rolloutId, proc]() {
+            const auto it = _rollouts.find(rolloutId);
+            if (it != _rollouts.end() && it->second.preStart == proc) {
+                it->second.preStart = nullptr;
+                _launches.release(rolloutId, common::LaunchScheduler::Clock::now());
+                _launchTimer->start(0);
+            }
+            proc->deleteLater();
+        };
+        connect(
+            proc, &QProcess::finished,
+            this, [finished](int, QProcess::ExitStatus) { finished(); }
+        );
+        connect(
+            proc, &QProcess::errorOccurred,
+            this,
+            [finished](QProcess::ProcessError error) {
+                // A script that fails to start never finishes, so the processes are
+                // started right away instead
+                if (error == QProcess::FailedToStart) {
+                    Log("Program", "Failed to start pre-start script");
+                    finished();
+                }
+            }
+        );
+        proc->start(QString::fromStdString(p->preStart));
     }
 
-    for (const std::string& nodeName : cluster->nodes) {
-        const Node* node = data::findNode(nodeName);
-        auto proc = std::make_unique<Process>(programId, configId, clusterId, node->id);
+    _launchTimer->start(0);
+}
+
+void MainWindow::updateLaunches() {
+    using Clock = common::LaunchScheduler::Clock;
+    const Clock::time_point now = Clock::now();
+
+    for (const common::LaunchScheduler::Launch& launch : _launches.update(now)) {
+        const auto it = _rollouts.find(launch.rollout);
+        assert(it != _rollouts.end());
+        const Rollout& r = it->second;
+
+        // The data files might have been reloaded since the rollout was started
+        if (!data::findProgram(r.programId) || !data::findCluster(r.clusterId) ||
+            !data::findNode(Node::ID(launch.item)))
+        {
+            _launches.setLaunched(launch.rollout, launch.item);
+            continue;
+        }
+
+        auto proc = std::make_unique<Process>(
+            r.programId,
+            r.configurationId,
+            r.clusterId,
+            Node::ID(launch.item)
+        );
         Process::ID id = proc->id;
         data::addProcess(std::move(proc));
+        _launchingProcesses[id] = launch;
 
         startProcess(id);
         _processesWidget->processAdded(id);
+    }
 
-        // If the program wants, we need to sleep for a duration before submitting the
-        // next process
-        if (p->delay.has_value()) {
-            std::this_thread::sleep_for(*p->delay);
+    // Launches that timed out are no longer waited for. The processes might also have
+    // been archived, for example because their program was removed by a reload
+    for (auto it = _launchingProcesses.begin(); it != _launchingProcesses.end();) {
+        const common::LaunchScheduler::Launch& launch = it->second;
+        if (!data::findProcess(it->first)) {
+            _launches.setLaunched(launch.rollout, launch.item);
+            it = _launchingProcesses.erase(it);
+        }
+        else if (!_launches.isInFlight(launch.rollout, launch.item)) {
+            it = _launchingProcesses.erase(it);
+        }
+        else {
+            it++;
         }
     }
+
+    // The rollouts that have started all of their processes are no longer needed
+    for (auto it = _rollouts.begin(); it != _rollouts.end();) {
+        if (_launches.contains(it->first)) {
+            it++;
+        }
+        else {
+            it = _rollouts.erase(it);
+        }
+    }
+
+    if (std::optional<Clock::time_point> next = _launches.nextUpdate()) {
+        const std::chrono::milliseconds wait = std::max(
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now),
+            std::chrono::milliseconds(0)
+        );
+        _launchTimer->start(wait);
+    }
+}
+
+void MainWindow::forgetLaunch(Process::ID processId) {
+    const auto it = _launchingProcesses.find(processId);
+    if (it == _launchingProcesses.end()) {
+        return;
+    }
+
+    _launches.setLaunched(it->second.rollout, it->second.item);
+    _launchingProcesses.erase(it);
+    _launchTimer->start(0);
+}
+
+void MainWindow::handleNodeConnectionChanged(Cluster::ID, Node::ID nodeId) {
+    const Node* node = data::findNode(nodeId);
+    if (node && node->isConnected) {
+        return;
+    }
+
+    std::vector<Process::ID> launching;
+    for (const auto& [processId, launch] : _launchingProcesses) {
+        if (launch.item == nodeId.v) {
+            launching.push_back(processId);
+        }
+    }
+    for (Process::ID processId : launching) {
+        forgetLaunch(processId);
+    }
 }
 
 void MainWindow::startCustomProgram(Node::ID nodeId, std::string executable,
@@ -607,29 +898,51 @@ void MainWindow::startCustomProgram(Node::ID nodeId, std::string executable,
 }
 
 void MainWindow::stopProgram(Cluster::ID clusterId, Program::ID programId,
-                             Program::Configuration::ID configurationId) const
+                             Program::Configuration::ID configurationId)
 {
-    // First, collect all the processes that belong to this program combination
-    std::vector<const Process*> processes;
-    for (const Process* process : data::processes()) {
-        assert(process);
-        const bool clusterMatch = (process->clusterId == clusterId);
-        const bool programMatch = (process->programId == programId);
-        const bool configurationMatch = (process->configurationId == configurationId);
-
-        if (clusterMatch && programMatch && configurationMatch) {
-            processes.push_back(process);
+    // Stopping a program also cancels the rollouts of it that are still in progress, so
+    // that no further processes are started after the ones below have been stopped
+    for (auto it = _rollouts.begin(); it != _rollouts.end();) {
+        const Rollout& r = it->second;
+        if (r.clusterId != clusterId || r.programId != programId ||
+            r.configurationId != configurationId)
+        {
+            it++;
+            continue;
         }
+
+        const std::vector<int> remaining = _launches.cancel(it->first);
+        Log(
+            "Program",
+            std::format(
+                "Cancelled the start of the program on {} remaining nodes",
+                remaining.size()
+            )
+        );
+        if (r.preStart) {
+            // The pre-start script is no longer needed
+            r.preStart->kill();
+        }
+        it = _rollouts.erase(it);
     }
 
+    // First, collect all the processes that belong to this program combination
+    std::vector<const Process*> processes =
+        data::findProcesses(clusterId, programId, configurationId);
+
     for (const Process* process : processes) {
+        forgetLaunch(process->id);
         stopProcess(process->id);
     }
 }
 
 void MainWindow::startProcess(Process::ID processId) const {
     const Process* process = data::findProcess(processId);
-    assert(process);
+    if (!process) {
+        // The process might have been archived since the request was made
+        Log("Status", std::format("Cannot restart unknown process {}", processId.v));
+        return;
+    }
     const Node* node = data::findNode(process->nodeId);
     assert(node);
 
@@ -655,6 +968,21 @@ void MainWindow::stopProcess(Process::ID processId) const {
     _clusterConnectionHandler.sendMessage(*node, command);
 }
 
+void MainWindow::fetchProcessOutput(Process::ID processId,
+                                    common::FetchOutputMessage message) const
+{
+    const Process* process = data::findProcess(processId);
+    assert(process);
+    const Node* node = data::findNode(process->nodeId);
+    assert(node);
+
+    if (!node->secret.empty()) {
+        message.secret = node->secret;
+    }
+
+    _clusterConnectionHandler.sendMessage(*node, message);
+}
+
 void MainWindow::killAllProcesses(Cluster::ID id) const {
     Log("Sending", "Send message to stop all programs");
 
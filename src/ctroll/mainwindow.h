@@ -39,18 +39,23 @@
 
 #include "clusterconnectionhandler.h"
 #include "configuration.h"
+#include "launchscheduler.h"
 #include "logwidget.h"
 #include "process.h"
 #include <QCloseEvent>
 #include <QFileSystemWatcher>
 #include <QSystemTrayIcon>
 #include <QTextEdit>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 
 class ClustersWidget;
 class ProcessesWidget;
+class QProcess;
+class QTimer;
 class RestConnectionHandler;
 
 namespace programs { class ProgramsWidget; }
@@ -67,6 +72,8 @@ private slots:
     void handleErrorMessage(Node::ID id, common::ErrorOccurredMessage message);
 
     void stopProcess(Process::ID processId) const;
+    void fetchProcessOutput(Process::ID processId,
+        common::FetchOutputMessage message) const;
 
     void iconActivated(QSystemTrayIcon::ActivationReason reason);
 
@@ -83,7 +90,7 @@ private:
     void startCustomProgram(Node::ID nodeId, std::string executable,
         std::string workingDir, std::string arguments);
     void stopProgram(Cluster::ID clusterId, Program::ID programId,
-        Program::Configuration::ID configurationId) const;
+        Program::Configuration::ID configurationId);
     void startProcess(Process::ID processId) const;
     void killAllProcesses(Cluster::ID id) const;
     void killAllProcesses(Node::ID id) const;
@@ -94,6 +101,22 @@ private:
     void shutdownNode(Node::ID id) const;
     void shutdownNodes(Cluster::ID id) const;
 
+    /// Starts the processes whose launch is due and schedules the next time this is
+    /// necessary
+    void updateLaunches();
+
+    /// Stops waiting for the tray to report that the process with the \p processId was
+    /// started, which frees up its place for the next launch of its cluster
+    void forgetLaunch(Process::ID processId);
+
+    /// Forgets the launches on the node with the \p nodeId if it lost its connection, as
+    /// its tray will not report them anymore
+    void handleNodeConnectionChanged(Cluster::ID clusterId, Node::ID nodeId);
+
+    /// Loads the data files that changed on disk and updates the affected connections
+    /// and widgets
+    void reloadData();
+
     void log(std::string msg);
 
     programs::ProgramsWidget* _programWidget = nullptr;
@@ -107,12 +130,39 @@ private:
 
     QSystemTrayIcon _trayIcon;
     QFileSystemWatcher _watcher;
+    /// Collects the changes on disk so that files that are saved in quick succession
+    /// only cause a single reload
+    QTimer* _reloadTimer = nullptr;
+
+    /// A program that is started on the nodes of a cluster, one after another
+    struct Rollout {
+        Cluster::ID clusterId;
+        Program::ID programId;
+        Program::Configuration::ID configurationId;
+        /// The pre-start script that has to finish before the first process is started
+        QProcess* preStart = nullptr;
+    };
+    /// The rollouts that still have processes to start, keyed by their scheduler id
+    std::map<int, Rollout> _rollouts;
+    common::LaunchScheduler _launches;
+    /// A single-shot timer that fires when the next process of a rollout is due
+    QTimer* _launchTimer = nullptr;
+    /// The launch of every process whose tray has not reported it as started yet
+    std::map<Process::ID, common::LaunchScheduler::Launch> _launchingProcesses;
+
+    std::string _applicationPath;
+    std::string _clusterPath;
+    std::string _nodePath;
+    std::string _dataCachePath;
 
     QAction* _showAction = nullptr;
     QAction* _hideAction = nullptr;
 
     bool _isClosingApplication = false;
     bool _shouldShowDifferentDataHashMessage = false;
+    /// The programs, clusters, and nodes that differ from the ones that the processes
+    /// reported by the trays were started with
+    std::set<std::string> _differentDataEntities;
 };
 
 #endif // __CTROLL__MAINWINDOW_H__
@@ -71,8 +71,13 @@ common::StartCommandMessage startProcessCommand(const Process& process) {
     t.clusterId = process.clusterId.v;
     t.nodeId = process.nodeId.v;
     t.forwardStdOutStdErr = prg.shouldForwardMessages;
+    t.outputPolicy = prg.outputPolicy;
+    t.outputOnDemand = prg.outputOnDemand;
     t.autoRestart = prg.shouldAutoRestart;
     t.dataHash = data::dataHash();
+    t.programHash = data::programHash(process.programId);
+    t.clusterHash = data::clusterHash(process.clusterId);
+    t.nodeHash = data::nodeHash(process.nodeId);
 
     return t;
 }
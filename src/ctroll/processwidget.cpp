@@ -66,15 +66,47 @@ namespace {
         throw std::logic_error("Missing case label");
     }
 
-    void Debug(std::string msg) {
-        ::Debug("ProcessWidget", std::move(msg));
+    /// The minimum time between two updates of the process output widgets
+    constexpr std::chrono::milliseconds RenderInterval = std::chrono::milliseconds(16);
+
+    void renderBuffer(QPlainTextEdit& edit, const common::OutputBuffer& buffer,
+                      std::uint64_t& renderedOffset, bool isFullRender)
+    {
+        if (isFullRender || renderedOffset < buffer.beginOffset()) {
+            // Either the widget has not been kept up-to-date or the part of the output
+            // that was shown has already been dropped from the buffer
+            edit.setPlainText(QString::fromStdString(buffer.text()));
+        }
+        else if (renderedOffset < buffer.endOffset()) {
+            edit.moveCursor(QTextCursor::End);
+            edit.insertPlainText(QString::fromStdString(buffer.text(renderedOffset)));
+        }
+        else {
+            return;
+        }
+        renderedOffset = buffer.endOffset();
+        edit.moveCursor(QTextCursor::End);
+        edit.ensureCursorVisible();
+    }
+
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Ui,
+            "ProcessWidget",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 } // namespace
 
 ProcessWidget::ProcessWidget(Process::ID processId,
-                             const std::chrono::milliseconds& timeout)
+                             const std::chrono::milliseconds& timeout,
+                             common::OutputBuffer::Limits outputLimits)
     : _processId(processId)
     , _timeout(timeout)
+    , _output(outputLimits)
+    , _errorOutput(outputLimits)
 {
     const Process* process = data::findProcess(_processId);
     assert(process);
@@ -91,6 +123,7 @@ ProcessWidget::ProcessWidget(Process::ID processId,
     const Node* node = data::findNode(process->nodeId);
     assert(node);
 
+    _isOutputOnDemand = program->shouldForwardMessages && program->outputOnDemand;
 
     _programInfo = new QLabel(QString::fromStdString(program->name));
     _configurationInfo = new QLabel(QString::fromStdString(configuration->name));
@@ -102,14 +135,26 @@ ProcessWidget::ProcessWidget(Process::ID processId,
 
     _messageContainer = createMessageContainer();
 
+    _renderTimer = new QTimer(this);
+    _renderTimer->setSingleShot(true);
+    _renderTimer->setInterval(RenderInterval);
+    connect(_renderTimer, &QTimer::timeout, [this]() { renderOutput(false); });
+
     {
         _showOutput = new QPushButton("Output");
         _showOutput->setCheckable(true);
         _showOutput->setEnabled(program->shouldForwardMessages);
         connect(
             _showOutput, &QPushButton::clicked,
-            [output = _showOutput, messageContainer = _messageContainer]() {
-                messageContainer->setHidden(!output->isChecked());
+            [this]() {
+                _messageContainer->setHidden(!_showOutput->isChecked());
+                if (_showOutput->isChecked()) {
+                    // The widgets were not updated while the window was hidden
+                    renderOutput(true);
+                }
+                if (_isOutputOnDemand) {
+                    requestOutput(_showOutput->isChecked());
+                }
             }
         );
     }
@@ -146,6 +191,9 @@ ProcessWidget::ProcessWidget(Process::ID processId,
             _remove, &QPushButton::clicked,
             [this]() {
                 _removalTimer->stop();
+                if (_isOutputOnDemand && _showOutput->isChecked()) {
+                    requestOutput(false);
+                }
                 emit remove(_processId);
             }
         );
@@ -206,6 +254,7 @@ QWidget* ProcessWidget::createMessageContainer() {
         _messages = new QPlainTextEdit;
         _messages->setReadOnly(true);
         _messages->setCenterOnScroll(true);
+        _messages->setMaximumBlockCount(static_cast<int>(_output.limits().maxLines));
         l->addWidget(_messages);
         containerLayout->addWidget(messages);
     }
@@ -217,6 +266,9 @@ QWidget* ProcessWidget::createMessageContainer() {
         _errorMessages = new QPlainTextEdit;
         _errorMessages->setReadOnly(true);
         _errorMessages->setCenterOnScroll(true);
+        _errorMessages->setMaximumBlockCount(
+            static_cast<int>(_errorOutput.limits().maxLines)
+        );
         l->addWidget(_errorMessages);
         containerLayout->addWidget(messages);
     }
@@ -249,28 +301,84 @@ void ProcessWidget::updateStatus() {
 }
 
 void ProcessWidget::addMessage(common::ProcessOutputMessage message) {
-    std::string msg = message.message;
-    // Some of the incoming messages might have a newline character at the end, but we
-    // want to normalize that
-    if (msg.back() != '\n') {
+    std::string& msg = message.message;
+    if (message.offset.has_value()) {
+        // On-demand output is a continuous stream. The answer to a request might overlap
+        // with the output that has been received while following the process, so only
+        // the part that is new is kept
+        std::uint64_t& received =
+            message.outputType == common::ProcessOutputMessage::OutputType::StdOut ?
+            _remoteOutput :
+            _remoteErrorOutput;
+        const std::uint64_t begin = *message.offset;
+        const std::uint64_t end = begin + msg.size();
+        if (end <= received) {
+            return;
+        }
+
+        if (begin < received) {
+            msg.erase(0, static_cast<std::size_t>(received - begin));
+        }
+        else if (begin > received) {
+            msg = std::format("[{} bytes skipped]\n", begin - received) + msg;
+        }
+        received = end;
+    }
+    else if (msg.empty() || msg.back() != '\n') {
+        // Some of the incoming messages might have a newline character at the end, but
+        // we want to normalize that
         msg.push_back('\n');
     }
     if (message.outputType == common::ProcessOutputMessage::OutputType::StdOut) {
-        _messages->insertPlainText(QString::fromStdString(msg));
-        _messages->ensureCursorVisible();
+        _output.append(msg);
     }
     else {
-        _errorMessages->insertPlainText(QString::fromStdString(msg));
-        _errorMessages->ensureCursorVisible();
+        _errorOutput.append(msg);
+    }
+
+    // The text widgets are only updated while they can be seen and at most once per
+    // frame, no matter how many messages arrive in between
+    if (_messageContainer->isVisible() && !_renderTimer->isActive()) {
+        _renderTimer->start();
+    }
+}
+
+void ProcessWidget::requestOutput(bool follow) {
+    using OutputType = common::ProcessOutputMessage::OutputType;
+
+    Debug("Requesting output of process {} (follow: {})", _processId.v, follow);
+    for (OutputType type : { OutputType::StdOut, OutputType::StdErr }) {
+        const std::uint64_t received =
+            type == OutputType::StdOut ? _remoteOutput : _remoteErrorOutput;
+
+        common::FetchOutputMessage msg;
+        msg.processId = _processId.v;
+        msg.outputType = type;
+        if (received > 0) {
+            msg.offset = received;
+        }
+        msg.follow = follow;
+        emit fetchOutput(_processId, std::move(msg));
+    }
+}
+
+void ProcessWidget::renderOutput(bool isFullRender) {
+    if (!_messageContainer->isVisible()) {
+        return;
     }
+
+    renderBuffer(*_messages, _output, _renderedOutput, isFullRender);
+    renderBuffer(*_errorMessages, _errorOutput, _renderedErrorOutput, isFullRender);
 }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
 
-ProcessesWidget::ProcessesWidget(const std::chrono::milliseconds& processTimeout)
+ProcessesWidget::ProcessesWidget(const std::chrono::milliseconds& processTimeout,
+                                 common::OutputBuffer::Limits outputLimits)
     : _processTimeout(processTimeout)
+    , _outputLimits(outputLimits)
 {
     QBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(10, 2, 2, 2);
@@ -314,13 +422,14 @@ void ProcessesWidget::receivedProcessMessage(Node::ID, common::ProcessOutputMess
 }
 
 void ProcessesWidget::processAdded(Process::ID processId) {
-    Debug(std::format("Adding process {}", processId.v));
+    Debug("Adding process {}", processId.v);
 
     // The process has been created, but the widget did not exist yet
-    ProcessWidget* w = new ProcessWidget(processId, _processTimeout);
+    ProcessWidget* w = new ProcessWidget(processId, _processTimeout, _outputLimits);
     w->setMinimumWidth(width());
     connect(w, &ProcessWidget::remove, this, &ProcessesWidget::processRemoved);
     connect(w, &ProcessWidget::kill, this, &ProcessesWidget::killProcess);
+    connect(w, &ProcessWidget::fetchOutput, this, &ProcessesWidget::fetchProcessOutput);
     _widgets[processId] = w;
     const int n = static_cast<int>(_widgets.size());
 
@@ -361,4 +470,7 @@ void ProcessesWidget::processRemoved(Process::ID processId) {
 
         _widgets.erase(processId);
     }
+
+    // The process is no longer shown, so the database can archive it once it is done
+    data::releaseProcess(processId);
 }
@@ -38,8 +38,10 @@
 #include <QWidget>
 
 #include "messages.h"
+#include "outputbuffer.h"
 #include "process.h"
 #include <chrono>
+#include <cstdint>
 #include <map>
 
 class QBoxLayout;
@@ -53,7 +55,8 @@ class QTimer;
 class ProcessWidget : public QWidget {
 Q_OBJECT
 public:
-    ProcessWidget(Process::ID processId, const std::chrono::milliseconds& timeout);
+    ProcessWidget(Process::ID processId, const std::chrono::milliseconds& timeout,
+        common::OutputBuffer::Limits outputLimits);
     ~ProcessWidget();
 
     void addToLayout(QGridLayout* layout, int row);
@@ -64,12 +67,17 @@ public:
 signals:
     void remove(Process::ID processId);
     void kill(Process::ID processId);
+    void fetchOutput(Process::ID processId, common::FetchOutputMessage message);
 
 private:
     QWidget* createMessageContainer();
+    void renderOutput(bool isFullRender);
+    void requestOutput(bool follow);
 
     const Process::ID _processId;
     const std::chrono::milliseconds& _timeout;
+    /// If this is `true`, the output is only sent by the tray while it is requested
+    bool _isOutputOnDemand = false;
 
     QLabel* _programInfo = nullptr;
     QLabel* _configurationInfo = nullptr;
@@ -86,6 +94,20 @@ private:
     QPlainTextEdit* _messages = nullptr;
     QPlainTextEdit* _errorMessages = nullptr;
 
+    /// The most recent output of the process, which is kept even while the output
+    /// window is closed so that it can be shown when the window is opened
+    common::OutputBuffer _output;
+    common::OutputBuffer _errorOutput;
+    /// The offsets up to which the output has been written into the text widgets
+    std::uint64_t _renderedOutput = 0;
+    std::uint64_t _renderedErrorOutput = 0;
+    /// The offsets in the output on the tray up to which it has been received. These are
+    /// only used for processes whose output is sent on demand
+    std::uint64_t _remoteOutput = 0;
+    std::uint64_t _remoteErrorOutput = 0;
+    /// Limits updates of the text widgets to at most one per frame
+    QTimer* _renderTimer = nullptr;
+
     QTimer* _removalTimer = nullptr;
 };
 
@@ -96,7 +118,8 @@ private:
 class ProcessesWidget : public QWidget {
 Q_OBJECT
 public:
-    explicit ProcessesWidget(const std::chrono::milliseconds& processTimeout);
+    ProcessesWidget(const std::chrono::milliseconds& processTimeout,
+        common::OutputBuffer::Limits outputLimits);
 
     void processAdded(Process::ID processId);
     void processUpdated(Process::ID processId);
@@ -108,11 +131,13 @@ public slots:
 signals:
     void killProcess(Process::ID processId);
     void killAllProcesses();
+    void fetchProcessOutput(Process::ID processId, common::FetchOutputMessage message);
 
 private:
     QGridLayout* _contentLayout = nullptr;
 
     const std::chrono::milliseconds& _processTimeout;
+    const common::OutputBuffer::Limits _outputLimits;
     std::map<Process::ID, ProcessWidget*> _widgets;
 };
 
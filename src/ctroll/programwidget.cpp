@@ -50,8 +50,28 @@
 #include <QVBoxLayout>
 #include <set>
 
+namespace {
+    // The user data of the entries in the list of targets for custom programs
+    constexpr int TagSeparator = -1;
+    constexpr int TagCluster = 0;
+    constexpr int TagNode = 1;
+} // namespace
+
 namespace programs {
 
+template <typename... Args>
+void ProgramButton::debug(std::format_string<Args...> fmt, Args&&... args) const {
+    // The id is only assembled if the message is actually logged
+    if (common::Log::isEnabled(common::LogCategory::Ui, common::LogLevel::Debug)) {
+        ::Debug(
+            common::LogCategory::Ui,
+            "ProgramButton",
+            "{}: {}",
+            id(), std::format(fmt, std::forward<Args>(args)...)
+        );
+    }
+}
+
 ProgramButton::ProgramButton(const Cluster* cluster,
                              const Program::Configuration* configuration)
     : QPushButton(QString::fromStdString(configuration->name))
@@ -76,11 +96,11 @@ void ProgramButton::updateStatus() {
     );
     setEnabled(allConnected);
 
-    Debug(id(), std::format("Update status. All connected: {}", allConnected));
+    debug("Update status. All connected: {}", allConnected);
 }
 
 void ProgramButton::processUpdated(Process::ID processId) {
-    Debug(id(), std::format("Update process {}", processId.v));
+    debug("Update process {}", processId.v);
 
     const Process* process = data::findProcess(processId);
 
@@ -91,7 +111,7 @@ void ProgramButton::processUpdated(Process::ID processId) {
         }
     );
     if (it == _processes.end()) {
-        Debug(id(), "New process");
+        debug("New process");
         // This is a brand new process, so it better be in a Starting status
 
         ProcessInfo info;
@@ -104,7 +124,7 @@ void ProgramButton::processUpdated(Process::ID processId) {
         _processes[process->nodeId] = info;
     }
     else {
-        Debug(id(), "Existing process");
+        debug("Existing process");
         // This is a process that already exists and we should update it depending on the
         // status of the incoming process
         assert(it->second.processId.v == processId.v);
@@ -120,9 +140,10 @@ void ProgramButton::handleButtonPress() {
         (hasNoProcessRunning() != hasAllProcessesRunning())
     );
 
-    Debug(id(), "Handle button");
-    Debug(id(), std::format("  No process running: {}", hasNoProcessRunning()));
-    Debug(id(), std::format("  All processes running: {}", hasAllProcessesRunning()));
+    debug(
+        "Handle button. No process running: {}, all processes running: {}",
+        hasNoProcessRunning(), hasAllProcessesRunning()
+    );
 
     if (hasNoProcessRunning()) {
         emit startProgram(_configuration->id);
@@ -140,9 +161,10 @@ void ProgramButton::handleButtonPress() {
 }
 
 void ProgramButton::updateButton() {
-    Debug(id(), "Update button");
-    Debug(id(), std::format("  No process running: {}", hasNoProcessRunning()));
-    Debug(id(), std::format("  All processes running: {}", hasAllProcessesRunning()));
+    debug(
+        "Update button. No process running: {}, all processes running: {}",
+        hasNoProcessRunning(), hasAllProcessesRunning()
+    );
 
     setEnabled(true);
 
@@ -228,8 +250,13 @@ void ProgramButton::updateMenu() {
 bool ProgramButton::isProcessRunning(Node::ID nodeId) const {
     using Status = common::ProcessStatusMessage::Status;
     const auto it = _processes.find(nodeId);
-    return (it != _processes.end()) &&
-        data::findProcess(it->second.processId)->status == Status::Running;
+    if (it == _processes.end()) {
+        return false;
+    }
+
+    // The process might already have been archived if a newer one was started
+    const Process* process = data::findProcess(it->second.processId);
+    return process && process->status == Status::Running;
 }
 
 bool ProgramButton::hasNoProcessRunning() const {
@@ -498,36 +525,12 @@ std::vector<std::string> TagsWidget::tags() const {
 CustomProgramWidget::CustomProgramWidget(QWidget* parent)
     : QWidget(parent)
 {
-    constexpr int TagSeparator = -1;
-    constexpr int TagCluster = 0;
-    constexpr int TagNode = 1;
-
     QBoxLayout* layout = new QHBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
 
-    QComboBox* targetList = new QComboBox;
-    std::vector<const Cluster*> clusters = data::clusters();
-    if (!clusters.empty()) {
-        targetList->addItem("Clusters", TagSeparator);
-        targetList->addItem("------------", TagSeparator);
-        for (const Cluster* c : clusters) {
-            targetList->addItem(QString::fromStdString(c->name), TagCluster);
-        }
-    }
-
-    std::vector<const Node*> nodes = data::nodes();
-    if (!nodes.empty()) {
-        if (!clusters.empty()) {
-            targetList->addItem("", TagSeparator);
-            targetList->addItem("", TagSeparator);
-        }
-        targetList->addItem("Nodes", TagSeparator);
-        targetList->addItem("------------", TagSeparator);
-        for (const Node* n : nodes) {
-            targetList->addItem(QString::fromStdString(n->name), TagNode);
-        }
-    }
-    targetList->setCurrentIndex(-1);
+    _targetList = new QComboBox;
+    QComboBox* targetList = _targetList;
+    updateTargets();
     layout->addWidget(targetList);
 
     QLineEdit* executable = new QLineEdit;
@@ -603,6 +606,33 @@ CustomProgramWidget::CustomProgramWidget(QWidget* parent)
     connect(executable, &QLineEdit::textChanged, updateRunButton);
 }
 
+void CustomProgramWidget::updateTargets() {
+    _targetList->clear();
+
+    data::View<Cluster> clusters = data::clusters();
+    if (!clusters.empty()) {
+        _targetList->addItem("Clusters", TagSeparator);
+        _targetList->addItem("------------", TagSeparator);
+        for (const Cluster* c : clusters) {
+            _targetList->addItem(QString::fromStdString(c->name), TagCluster);
+        }
+    }
+
+    data::View<Node> nodes = data::nodes();
+    if (!nodes.empty()) {
+        if (!clusters.empty()) {
+            _targetList->addItem("", TagSeparator);
+            _targetList->addItem("", TagSeparator);
+        }
+        _targetList->addItem("Nodes", TagSeparator);
+        _targetList->addItem("------------", TagSeparator);
+        for (const Node* n : nodes) {
+            _targetList->addItem(QString::fromStdString(n->name), TagNode);
+        }
+    }
+    _targetList->setCurrentIndex(-1);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
@@ -614,12 +644,12 @@ ProgramsWidget::ProgramsWidget() {
     layout->addWidget(createPrograms(), 0, 1);
     layout->setColumnStretch(1, 5);
 
-    CustomProgramWidget* customPrograms = new CustomProgramWidget(this);
+    _customPrograms = new CustomProgramWidget(this);
     connect(
-        customPrograms, &CustomProgramWidget::startCustomProgram,
+        _customPrograms, &CustomProgramWidget::startCustomProgram,
         this, &ProgramsWidget::startCustomProgram
     );
-    layout->addWidget(customPrograms, 1, 0, 1, 2);
+    layout->addWidget(_customPrograms, 1, 0, 1, 2);
 }
 
 QWidget* ProgramsWidget::createControls() {
@@ -674,48 +704,66 @@ QWidget* ProgramsWidget::createPrograms() {
     area->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     QWidget* content = new QWidget;
     area->setWidget(content);
-    QBoxLayout* contentLayout = new QVBoxLayout(content);
-    contentLayout->setContentsMargins(5, 5, 5, 5);
+    _programsLayout = new QVBoxLayout(content);
+    _programsLayout->setContentsMargins(5, 5, 5, 5);
     area->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Expanding);
 
     for (const Program* p : data::programs()) {
         assert(p);
-        ProgramWidget* w = new ProgramWidget(*p);
-
-        connect(
-            w, &ProgramWidget::startProgram,
-            [this, programId = p->id](Cluster::ID clusterId,
-                                      Program::Configuration::ID configurationId)
-            {
-                emit startProgram(clusterId, programId, configurationId);
-            }
-        );
-        connect(
-            w, &ProgramWidget::stopProgram,
-            [this, programId = p->id](Cluster::ID clusterId,
-                                      Program::Configuration::ID configurationId)
-            {
-                emit stopProgram(clusterId, programId, configurationId);
-            }
-        );
-
-        connect(w, &ProgramWidget::restartProcess, this, &ProgramsWidget::restartProcess);
-        connect(w, &ProgramWidget::stopProcess, this, &ProgramsWidget::stopProcess);
-
+        ProgramWidget* w = createProgramWidget(*p);
         _widgets[p->id] = w;
         VisibilityInfo info = {
             .byTag = true,
             .bySearch = true
         };
         _visibilities[p->id] = std::move(info);
-        contentLayout->addWidget(w);
+        _programsLayout->addWidget(w);
     }
 
-    contentLayout->addStretch(0);
+    _programsLayout->addStretch(0);
 
     return area;
 }
 
+ProgramWidget* ProgramsWidget::createProgramWidget(const Program& program) {
+    ProgramWidget* w = new ProgramWidget(program);
+
+    connect(
+        w, &ProgramWidget::startProgram,
+        [this, programId = program.id](Cluster::ID clusterId,
+                                       Program::Configuration::ID configurationId)
+        {
+            emit startProgram(clusterId, programId, configurationId);
+        }
+    );
+    connect(
+        w, &ProgramWidget::stopProgram,
+        [this, programId = program.id](Cluster::ID clusterId,
+                                       Program::Configuration::ID configurationId)
+        {
+            emit stopProgram(clusterId, programId, configurationId);
+        }
+    );
+
+    connect(w, &ProgramWidget::restartProcess, this, &ProgramsWidget::restartProcess);
+    connect(w, &ProgramWidget::stopProcess, this, &ProgramsWidget::stopProcess);
+
+    return w;
+}
+
+void ProgramsWidget::removeProgramWidget(Program::ID programId) {
+    const auto it = _widgets.find(programId);
+    if (it == _widgets.end()) {
+        // Disabled programs don't have a widget
+        return;
+    }
+
+    _programsLayout->removeWidget(it->second);
+    it->second->deleteLater();
+    _widgets.erase(it);
+    _visibilities.erase(programId);
+}
+
 void ProgramsWidget::processUpdated(Process::ID processId) {
     const Process* process = data::findProcess(processId);
     assert(process);
@@ -731,7 +779,7 @@ void ProgramsWidget::selectTags(std::vector<std::string> tags) {
     assert(
         std::all_of(
             tags.begin(), tags.end(),
-            [](std::string tag) { return data::tags().contains(tag); }
+            [](const std::string& tag) { return data::tags().contains(tag); }
         )
     );
 
@@ -742,6 +790,98 @@ void ProgramsWidget::selectTags(std::vector<std::string> tags) {
     tagsPicked(tags);
 }
 
+void ProgramsWidget::applyChanges(const data::DataChanges& changes) {
+    for (Program::ID id : changes.removedPrograms) {
+        removeProgramWidget(id);
+    }
+
+    // The program widgets show the name and description of their clusters and keep
+    // pointers to them, so they have to be recreated if any of their clusters changed
+    std::set<Program::ID> changed = std::set<Program::ID>(
+        changes.changedPrograms.begin(),
+        changes.changedPrograms.end()
+    );
+    for (const Program* program : data::programs()) {
+        for (const Cluster* cluster : data::findClustersForProgram(*program)) {
+            const auto it = std::find(
+                changes.changedClusters.begin(), changes.changedClusters.end(),
+                cluster->id
+            );
+            if (it != changes.changedClusters.end()) {
+                changed.insert(program->id);
+            }
+        }
+    }
+    changed.insert(changes.addedPrograms.begin(), changes.addedPrograms.end());
+
+    for (Program::ID id : changed) {
+        const Program* program = data::findProgram(id);
+        assert(program);
+
+        // Changed programs keep their position, all others are added to the end. The
+        // last item in the layout is the stretch that keeps the programs at the top
+        const auto it = _widgets.find(id);
+        const int index =
+            it != _widgets.end() ?
+            _programsLayout->indexOf(it->second) :
+            _programsLayout->count() - 1;
+        removeProgramWidget(id);
+
+        if (!program->isEnabled) {
+            continue;
+        }
+
+        ProgramWidget* w = createProgramWidget(*program);
+        _programsLayout->insertWidget(index, w);
+        _widgets[id] = w;
+        _visibilities[id] = VisibilityInfo();
+
+        // Bring the new widget up to date with the processes and connections that were
+        // already known for the previous one
+        for (const Process* process : data::processes()) {
+            if (process->programId == id) {
+                w->processUpdated(process->id);
+            }
+        }
+        for (const Cluster* cluster : data::clusters()) {
+            w->updateStatus(cluster->id);
+        }
+    }
+
+    // Remove the tags that no longer exist and add the new ones
+    for (const std::string& tag : _availableTags->tags()) {
+        if (!data::tags().contains(tag)) {
+            _availableTags->removeTag(tag);
+        }
+    }
+    for (const std::string& tag : _selectedTags->tags()) {
+        if (!data::tags().contains(tag)) {
+            _selectedTags->removeTag(tag);
+        }
+    }
+    const std::vector<std::string> available = _availableTags->tags();
+    const std::vector<std::string> selected = _selectedTags->tags();
+    for (const std::string& tag : data::tags()) {
+        const bool isShown =
+            std::find(available.begin(), available.end(), tag) != available.end() ||
+            std::find(selected.begin(), selected.end(), tag) != selected.end();
+        if (!isShown) {
+            _availableTags->addTag(tag);
+        }
+    }
+
+    const bool hasNewTargets =
+        !changes.addedNodes.empty() || !changes.removedNodes.empty() ||
+        !changes.addedClusters.empty() || !changes.removedClusters.empty();
+    if (hasNewTargets) {
+        _customPrograms->updateTargets();
+    }
+
+    // Apply the current selection of tags and the search to the new widgets
+    tagsPicked(selected);
+    searchUpdated(_searchText);
+}
+
 void ProgramsWidget::connectedStatusChanged(Cluster::ID cluster, Node::ID) {
     for (const std::pair<const Program::ID, ProgramWidget*>& p : _widgets) {
         p.second->updateStatus(cluster);
@@ -765,6 +905,7 @@ void ProgramsWidget::tagsPicked(std::vector<std::string> tags) {
 }
 
 void ProgramsWidget::searchUpdated(std::string text) {
+    _searchText = text;
     if (text.empty()) {
         for (std::pair<const Program::ID, VisibilityInfo>& p : _visibilities) {
             p.second.bySearch = true;
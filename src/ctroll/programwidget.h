@@ -41,12 +41,16 @@
 
 #include "process.h"
 #include "program.h"
+#include <format>
 #include <map>
 
 struct Cluster;
 class QBoxLayout;
+class QComboBox;
 class QMenu;
 
+namespace data { struct DataChanges; }
+
 namespace programs {
 
 class ProgramButton : public QPushButton {
@@ -76,6 +80,10 @@ private:
 
     std::string id() const;
 
+    /// Logs a debug message in the Ui category that is prefixed with the id()
+    template <typename... Args>
+    void debug(std::format_string<Args...> fmt, Args&&... args) const;
+
     const Cluster* _cluster = nullptr;
     const Program::Configuration* _configuration = nullptr;
 
@@ -176,9 +184,15 @@ Q_OBJECT
 public:
     explicit CustomProgramWidget(QWidget* parent = nullptr);
 
+    /// Fills the list of clusters and nodes on which a custom program can be started
+    void updateTargets();
+
 signals:
     void startCustomProgram(Node::ID nodeId, std::string executable,
         std::string workingDir, std::string arguments);
+
+private:
+    QComboBox* _targetList = nullptr;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -193,6 +207,9 @@ public:
 
     void selectTags(std::vector<std::string> tags);
 
+    /// Recreates the widgets of all programs that were affected by reloading the data
+    void applyChanges(const data::DataChanges& changes);
+
 public slots:
     void connectedStatusChanged(Cluster::ID cluster, Node::ID node);
 
@@ -213,12 +230,17 @@ signals:
 private:
     QWidget* createControls();
     QWidget* createPrograms();
+    ProgramWidget* createProgramWidget(const Program& program);
+    void removeProgramWidget(Program::ID programId);
 
     void tagsPicked(std::vector<std::string> tags);
     void updatedVisibilityState();
 
     TagsWidget* _availableTags = nullptr;
     TagsWidget* _selectedTags = nullptr;
+    CustomProgramWidget* _customPrograms = nullptr;
+    QBoxLayout* _programsLayout = nullptr;
+    std::string _searchText;
 
     std::map<Program::ID, ProgramWidget*> _widgets;
 
@@ -69,8 +69,14 @@ namespace {
         Unknown
     };
 
-    void Debug(std::string msg) {
-        ::Debug("RestConnectionHandler", std::move(msg));
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Rest,
+            "RestConnectionHandler",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 
     void Log(std::string msg) {
@@ -82,7 +88,7 @@ namespace {
             return;
         }
 
-        Debug(content);
+        Debug("{}", content);
 
         std::string_view code = [](Response resp) {
             switch (resp) {
@@ -236,12 +242,16 @@ RestConnectionHandler::RestConnectionHandler(QObject* parent, int port,
     );
 }
 
+void RestConnectionHandler::setHeartbeatSource(HeartbeatSource source) {
+    _heartbeatSource = std::move(source);
+}
+
 void RestConnectionHandler::newConnectionEstablished() {
     while (_server.hasPendingConnections()) {
         QTcpSocket* socket = _server.nextPendingConnection();
-        Debug(std::format(
+        Debug(
             "New connection from {}", socket->peerAddress().toString().toStdString()
-        ));
+        );
 
         connect(
             socket, &QTcpSocket::readyRead,
@@ -253,9 +263,9 @@ void RestConnectionHandler::newConnectionEstablished() {
 void RestConnectionHandler::handleNewConnection() {
     QTcpSocket* socket = dynamic_cast<QTcpSocket*>(QObject::sender());
     assert(socket);
-    Debug(std::format(
+    Debug(
         "Handling new message from {}", socket->peerAddress().toString().toStdString()
-    ));
+    );
 
     if (_acceptOnlyLoopbackConnection && !socket->peerAddress().isLoopback()) {
         Debug("Rejecting due to not from a loopback");
@@ -493,9 +503,8 @@ void RestConnectionHandler::handleStartCustomProgramMessage(QTcpSocket& socket,
 void RestConnectionHandler::handleProgramInfoMessage(QTcpSocket& socket) {
     Debug("Received command to send programs info message");
 
-    std::vector<const Program*> programs = data::programs();
     nlohmann::json result = nlohmann::json::array();
-    for (const Program* program : programs) {
+    for (const Program* program : data::programs()) {
         assert(program);
         nlohmann::json p;
         p["name"] = program->name;
@@ -519,9 +528,8 @@ void RestConnectionHandler::handleProgramInfoMessage(QTcpSocket& socket) {
 void RestConnectionHandler::handleClusterInfoMessage(QTcpSocket& socket) {
     Debug("Received command to send clusters info message");
 
-    std::vector<const Cluster*> clusters = data::clusters();
     nlohmann::json result = nlohmann::json::array();
-    for (const Cluster* cluster : clusters) {
+    for (const Cluster* cluster : data::clusters()) {
         assert(cluster);
         if (cluster->isEnabled) {
             nlohmann::json c;
@@ -544,13 +552,28 @@ void RestConnectionHandler::handleClusterInfoMessage(QTcpSocket& socket) {
 void RestConnectionHandler::handleNodeInfoMessage(QTcpSocket& socket) {
     Debug("Received command to send nodes info message");
 
-    std::vector<const Node*> nodes = data::nodes();
     nlohmann::json result = nlohmann::json::array();
-    for (const Node* node : nodes) {
+    for (const Node* node : data::nodes()) {
         assert(node);
         nlohmann::json n;
         n["name"] = node->name;
         n["isConnected"] = node->isConnected;
+
+        std::optional<common::HeartbeatMonitor::Statistics> stats =
+            _heartbeatSource ? _heartbeatSource(node->id) : std::nullopt;
+        if (stats.has_value()) {
+            // The round-trip times are reported in milliseconds
+            auto ms = [](std::chrono::microseconds duration) {
+                return static_cast<double>(duration.count()) / 1000.0;
+            };
+            n["heartbeat"] = {
+                { "median", ms(stats->p50) },
+                { "p99", ms(stats->p99) },
+                { "last", ms(stats->last) },
+                { "samples", stats->nSamples },
+                { "missedBeats", stats->missedBeats }
+            };
+        }
         result.push_back(n);
     }
 
@@ -622,7 +645,11 @@ void RestConnectionHandler::handleApiInfoMessage(QTcpSocket& socket) {
 
     result["endpoints"].push_back({
         { "url", "/node" },
-        { "description", "Gets information about the available nodes" }
+        {
+            "description",
+            "Gets information about the available nodes, including the round-trip "
+            "times in milliseconds of the heartbeats for connected nodes"
+        }
     });
 
     sendJSONResponse(socket, Response::Ok, result);
@@ -38,10 +38,13 @@
 #include <QObject>
 
 #include "cluster.h"
+#include "heartbeatmonitor.h"
 #include "node.h"
 #include "program.h"
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <functional>
+#include <optional>
 #include <variant>
 
 class RestConnectionHandler : public QObject {
@@ -51,6 +54,15 @@ public:
         bool acceptOnlyLoopbackConnection = true, std::string user = "",
         std::string password = "", bool provideCustomProgramAPI = false);
 
+    /// Returns the heartbeat statistics of a node or `std::nullopt` if there are none
+    using HeartbeatSource = std::function<
+        std::optional<common::HeartbeatMonitor::Statistics>(Node::ID)
+    >;
+
+    /// Sets the \p source from which the heartbeat statistics of the node information
+    /// are taken
+    void setHeartbeatSource(HeartbeatSource source);
+
 signals:
     void startProgram(Cluster::ID clusterId, Program::ID programId,
         Program::Configuration::ID configurationId);
@@ -81,6 +93,7 @@ private:
     const bool _hasCustomProgramAPI = false;
     const bool _acceptOnlyLoopbackConnection = true;
     const std::string _secret;
+    HeartbeatSource _heartbeatSource;
 };
 
 #endif // __CTROLL_RESTCONNECTIONHANDLER_H__
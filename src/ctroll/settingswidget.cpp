@@ -541,6 +541,14 @@ void SettingsWidget::saveValues() {
 
     config.tagColors = tagColors();
 
+    // These values cannot be changed in the user interface and have to be preserved
+    config.logLines = _configuration.logLines;
+    config.logLevels = _configuration.logLevels;
+    config.processOutput = _configuration.processOutput;
+    config.processHistory = _configuration.processHistory;
+    config.dataCache = _configuration.dataCache;
+    config.heartbeat = _configuration.heartbeat;
+    config.socket = _configuration.socket;
 
     nlohmann::json j;
     to_json(j, config);
@@ -40,6 +40,7 @@
 #include "removebutton.h"
 #include "spacer.h"
 #include <QCheckBox>
+#include <QComboBox>
 #include <QDialogButtonBox>
 #include <QFileDialog>
 #include <QGridLayout>
@@ -187,12 +188,51 @@ ProgramDialog::ProgramDialog(QWidget* parent, std::string programPath,
     editLayout->addWidget(_isEnabled, 4, 1, 1, 2);
 
     editLayout->addWidget(new QLabel("Forward Messages:"), 5, 0);
-    _shouldForwardMessages = new QCheckBox;
+    QWidget* forwardContainer = new QWidget;
+    QBoxLayout* forwardLayout = new QHBoxLayout(forwardContainer);
+    forwardLayout->setContentsMargins(0, 0, 0, 0);
+    forwardLayout->setSpacing(0);
+    _shouldForwardMessages = new QCheckBox("Enabled");
     _shouldForwardMessages->setToolTip(
         "If this is enabled, all console messages from the executable will be sent back "
         "to C-Troll"
     );
-    editLayout->addWidget(_shouldForwardMessages, 5, 1, 1, 2);
+    forwardLayout->addWidget(_shouldForwardMessages);
+    _outputPolicy = new QComboBox;
+    _outputPolicy->setToolTip(
+        "Determines which console messages are kept if the executable produces them "
+        "faster than C-Troll can accept them"
+    );
+    for (common::OutputPolicy policy : { common::OutputPolicy::KeepHead,
+                                         common::OutputPolicy::KeepTail,
+                                         common::OutputPolicy::Sample })
+    {
+        _outputPolicy->addItem(
+            QString::fromStdString(std::string(common::toString(policy))),
+            static_cast<int>(policy)
+        );
+    }
+    _outputPolicy->setCurrentIndex(
+        _outputPolicy->findData(static_cast<int>(Program().outputPolicy))
+    );
+    _outputPolicy->setEnabled(false);
+    connect(
+        _shouldForwardMessages, &QCheckBox::toggled,
+        _outputPolicy, &QComboBox::setEnabled
+    );
+    forwardLayout->addWidget(_outputPolicy);
+    _outputOnDemand = new QCheckBox("On Demand");
+    _outputOnDemand->setToolTip(
+        "If this is enabled, the console messages are kept on the node and are only sent "
+        "to C-Troll while the output window of the process is open"
+    );
+    _outputOnDemand->setEnabled(false);
+    connect(
+        _shouldForwardMessages, &QCheckBox::toggled,
+        _outputOnDemand, &QCheckBox::setEnabled
+    );
+    forwardLayout->addWidget(_outputOnDemand);
+    editLayout->addWidget(forwardContainer, 5, 1, 1, 2);
 
     editLayout->addWidget(new QLabel("Autorestart on Crash:"), 6, 0);
     _shouldAutoRestart = new QCheckBox;
@@ -361,6 +401,10 @@ ProgramDialog::ProgramDialog(QWidget* parent, std::string programPath,
         _workingDirectory->setCursorPosition(0);
         _isEnabled->setChecked(program.isEnabled);
         _shouldForwardMessages->setChecked(program.shouldForwardMessages);
+        _outputPolicy->setCurrentIndex(
+            _outputPolicy->findData(static_cast<int>(program.outputPolicy))
+        );
+        _outputOnDemand->setChecked(program.outputOnDemand);
         _shouldAutoRestart->setChecked(program.shouldAutoRestart);
         _hasDelay->setChecked(program.delay.has_value());
         if (program.delay.has_value()) {
@@ -432,6 +476,9 @@ void ProgramDialog::save() {
     program.workingDirectory = _workingDirectory->text().toStdString();
     program.isEnabled = _isEnabled->isChecked();
     program.shouldForwardMessages = _shouldForwardMessages->isChecked();
+    program.outputPolicy =
+        static_cast<common::OutputPolicy>(_outputPolicy->currentData().toInt());
+    program.outputOnDemand = _outputOnDemand->isChecked();
     program.shouldAutoRestart = _shouldAutoRestart->isChecked();
     if (_hasDelay->isChecked()) {
         program.delay = std::chrono::milliseconds(_delay->value());
@@ -45,6 +45,7 @@
 
 class QBoxLayout;
 class QCheckBox;
+class QComboBox;
 class QLabel;
 class QLineEdit;
 class QPushButton;
@@ -88,6 +89,8 @@ private:
     QLineEdit* _workingDirectory = nullptr;
     QCheckBox* _isEnabled = nullptr;
     QCheckBox* _shouldForwardMessages = nullptr;
+    QComboBox* _outputPolicy = nullptr;
+    QCheckBox* _outputOnDemand = nullptr;
     QCheckBox* _shouldAutoRestart = nullptr;
 
     QCheckBox* _hasDelay = nullptr;
@@ -38,12 +38,17 @@
 #include "version.h"
 #include <QGroupBox>
 #include <QLabel>
-#include <QTextEdit>
 #include <QVBoxLayout>
 
 namespace {
-    void Debug(std::string msg) {
-        ::Debug("CentralWidget", std::move(msg));
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Ui,
+            "CentralWidget",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 } // namespace
 
@@ -51,7 +56,7 @@ CentralWidget::CentralWidget() {
     QLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
 
-    _messageBox = new QTextEdit;
+    _messageBox = new common::LogView;
     layout->addWidget(_messageBox);
 
     QGroupBox* connectionsWidget = new QGroupBox("Connected controllers");
@@ -70,8 +75,11 @@ void CentralWidget::setPort(int port) {
 }
 
 void CentralWidget::log(std::string msg) {
-    _messageBox->append(QString::fromStdString(msg));
-    _messageBox->ensureCursorVisible();
+    _messageBox->appendMessage(std::move(msg));
+}
+
+void CentralWidget::setMaxLogLines(std::size_t maxLines) {
+    _messageBox->setMaxLines(maxLines);
 }
 
 bool CentralWidget::hasConnections() const {
@@ -79,7 +87,7 @@ bool CentralWidget::hasConnections() const {
 }
 
 void CentralWidget::newConnection(const std::string& peerAddress) {
-    Debug(std::format("Opened connection to {}", peerAddress));
+    Debug("Opened connection to {}", peerAddress);
 
     if (!_connections.contains(peerAddress)) {
         // We are the first connection, so we need to create the map entry
@@ -103,7 +111,7 @@ void CentralWidget::newConnection(const std::string& peerAddress) {
 }
 
 void CentralWidget::closedConnection(const std::string& peerAddress) {
-    Debug(std::format("Closed connection to {}", peerAddress));
+    Debug("Closed connection to {}", peerAddress);
 
     const auto it = _connections.find(peerAddress);
     assert(it != _connections.end());
@@ -123,7 +131,7 @@ void CentralWidget::closedConnection(const std::string& peerAddress) {
 }
 
 void CentralWidget::newProcess(ProcessHandler::ProcessInfo process) {
-    Debug(std::format("New process: {}, {}", process.processId, process.executable));
+    Debug("New process: {}, {}", process.processId, process.executable);
 
     std::string text = std::format("{}: {}", process.processId, process.executable);
     QLabel* label = new QLabel(QString::fromStdString(text));
@@ -132,7 +140,7 @@ void CentralWidget::newProcess(ProcessHandler::ProcessInfo process) {
 }
 
 void CentralWidget::endedProcess(ProcessHandler::ProcessInfo process) {
-    Debug(std::format("Close process: {}, {}", process.processId, process.executable));
+    Debug("Close process: {}, {}", process.processId, process.executable);
 
     const auto it = _processes.find(process.processId);
     // The processId might not exist yet if the process starting fails (for example if the
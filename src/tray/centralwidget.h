@@ -37,12 +37,12 @@
 
 #include <QWidget>
 
+#include "logview.h"
 #include "processhandler.h"
 #include <map>
 #include <string>
 
 class QLabel;
-class QTextEdit;
 
 class CentralWidget : public QWidget {
 Q_OBJECT
@@ -51,6 +51,7 @@ public:
 
     void setPort(int port);
     void log(std::string msg);
+    void setMaxLogLines(std::size_t maxLines);
 
     bool hasConnections() const;
 
@@ -72,7 +73,7 @@ private:
     void updateLabel(ConnectionInfo& ci);
 
 
-    QTextEdit* _messageBox = nullptr;
+    common::LogView* _messageBox = nullptr;
     QLabel* _portLabel = nullptr;
 
     QLayout* _connectionsLayout = nullptr;
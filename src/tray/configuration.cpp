@@ -34,6 +34,8 @@
 
 #include "configuration.h"
 
+#include <stdexcept>
+
 namespace {
     constexpr std::string_view KeyPort = "port";
     constexpr std::string_view KeySecret = "secret";
@@ -41,6 +43,19 @@ namespace {
 
     constexpr std::string_view KeyLogFile = "logFile";
     constexpr std::string_view KeyLogRotation = "logRotation";
+    constexpr std::string_view KeyLogLevels = "logLevels";
+    constexpr std::string_view KeyLogLines = "logLines";
+
+    constexpr std::string_view KeyProcessOutput = "processOutput";
+    constexpr std::string_view KeyProcessOutputInterval = "interval";
+    constexpr std::string_view KeyProcessOutputFlushSize = "flushSize";
+    constexpr std::string_view KeyProcessOutputMaxBytesPerSecond = "maxBytesPerSecond";
+
+    constexpr std::string_view KeyOutputHistory = "outputHistory";
+    constexpr std::string_view KeyOutputHistoryMaxBytes = "maxBytes";
+    constexpr std::string_view KeyOutputHistoryMaxLines = "maxLines";
+
+    constexpr std::string_view KeySocket = "socket";
 } // namespace
 
 void to_json(nlohmann::json& j, const Configuration& c) {
@@ -51,6 +66,23 @@ void to_json(nlohmann::json& j, const Configuration& c) {
     if (c.logRotation.has_value()) {
         j[KeyLogRotation] = *c.logRotation;
     }
+    if (!c.logLevels.levels.empty()) {
+        j[KeyLogLevels] = c.logLevels;
+    }
+    j[KeyLogLines] = c.logLines;
+
+    nlohmann::json output = nlohmann::json::object();
+    output[KeyProcessOutputInterval] = c.processOutput.interval.count();
+    output[KeyProcessOutputFlushSize] = c.processOutput.flushSize;
+    output[KeyProcessOutputMaxBytesPerSecond] = c.processOutput.maxBytesPerSecond;
+    j[KeyProcessOutput] = std::move(output);
+
+    nlohmann::json history = nlohmann::json::object();
+    history[KeyOutputHistoryMaxBytes] = c.outputHistory.maxBytes;
+    history[KeyOutputHistoryMaxLines] = c.outputHistory.maxLines;
+    j[KeyOutputHistory] = std::move(history);
+
+    j[KeySocket] = c.socket;
 }
 
 void from_json(const nlohmann::json& j, Configuration& c) {
@@ -68,4 +100,62 @@ void from_json(const nlohmann::json& j, Configuration& c) {
     if (auto it = j.find(KeyLogRotation);  it != j.end()) {
         c.logRotation = it->get<common::LogRotation>();
     }
+    if (auto it = j.find(KeyLogLevels);  it != j.end()) {
+        it->get_to(c.logLevels);
+    }
+    if (auto it = j.find(KeyLogLines);  it != j.end()) {
+        it->get_to(c.logLines);
+
+        if (c.logLines == 0) {
+            throw std::runtime_error("The number of log lines must be positive");
+        }
+    }
+    if (auto it = j.find(KeyProcessOutput);  it != j.end()) {
+        const nlohmann::json& output = *it;
+
+        if (auto jt = output.find(KeyProcessOutputInterval);  jt != output.end()) {
+            const int ms = jt->get<int>();
+            if (ms < 0) {
+                throw std::runtime_error(
+                    "Negative process output interval is not allowed"
+                );
+            }
+            c.processOutput.interval = std::chrono::milliseconds(ms);
+        }
+        if (auto jt = output.find(KeyProcessOutputFlushSize);  jt != output.end()) {
+            jt->get_to(c.processOutput.flushSize);
+            if (c.processOutput.flushSize == 0) {
+                throw std::runtime_error(
+                    "The process output flush size must be positive"
+                );
+            }
+        }
+        if (auto jt = output.find(KeyProcessOutputMaxBytesPerSecond);  jt != output.end())
+        {
+            jt->get_to(c.processOutput.maxBytesPerSecond);
+        }
+    }
+    if (auto it = j.find(KeyOutputHistory);  it != j.end()) {
+        const nlohmann::json& history = *it;
+
+        if (auto jt = history.find(KeyOutputHistoryMaxBytes);  jt != history.end()) {
+            jt->get_to(c.outputHistory.maxBytes);
+            if (c.outputHistory.maxBytes == 0) {
+                throw std::runtime_error(
+                    "The output history byte limit must be positive"
+                );
+            }
+        }
+        if (auto jt = history.find(KeyOutputHistoryMaxLines);  jt != history.end()) {
+            jt->get_to(c.outputHistory.maxLines);
+            if (c.outputHistory.maxLines == 0) {
+                throw std::runtime_error(
+                    "The output history line limit must be positive"
+                );
+            }
+        }
+    }
+    if (auto it = j.find(KeySocket);  it != j.end()) {
+        it->get_to(c.socket);
+    }
 }
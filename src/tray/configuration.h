@@ -35,7 +35,10 @@
 #ifndef __TRAY__CONFIGURATION_H__
 #define __TRAY__CONFIGURATION_H__
 
+#include "jsonsocket.h"
 #include "logconfiguration.h"
+#include "outputbuffer.h"
+#include "outputcoalescer.h"
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
@@ -55,6 +58,21 @@ struct Configuration {
 
     /// Contains configuration about log rotations
     std::optional<common::LogRotation> logRotation;
+
+    /// The log levels of the categories that should differ from the default
+    common::LogLevels logLevels;
+
+    /// The maximum number of log messages that are shown in the window
+    std::size_t logLines = 10000;
+
+    /// Determines how the output of processes is combined before it is sent to C-Troll
+    common::OutputCoalescer::Options processOutput;
+
+    /// The amount of output that is kept for processes whose output is sent on demand
+    common::OutputBuffer::Limits outputHistory;
+
+    /// The options of the connections to C-Troll
+    common::JsonSocket::Options socket;
 };
 
 void to_json(nlohmann::json& j, const Configuration& c);
@@ -54,8 +54,14 @@ namespace {
         std::byte unused[32] = {};
     };
 
-    void Debug(std::string msg) {
-        ::Debug("Initialization", std::move(msg));
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::General,
+            "Initialization",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 } // namespace
 
@@ -146,6 +152,7 @@ int main(int argc, char** argv) {
         logDebug,
         [&mw](std::string msg) { mw.log(std::move(msg)); }
     );
+    common::applyLogLevels(config.logLevels);
     Log("Config", std::format("Finished loading configuration file '{}'", cfg));
 
 #ifdef QT_DEBUG
@@ -162,6 +169,7 @@ int main(int argc, char** argv) {
     }
 
     mw.setPort(config.port);
+    mw.setMaxLogLines(config.logLines);
 
     if (config.logRotation.has_value()) {
         Debug("Enabling log rotation");
@@ -173,16 +181,32 @@ int main(int argc, char** argv) {
         QObject::connect(
             timer, &QTimer::timeout,
             [keepLog]() {
-                Debug("Logging", "Performing log rotation");
+                ::Debug(
+                    common::LogCategory::General,
+                    "Logging",
+                    "Performing log rotation"
+                );
                 common::Log::ref()->performLogRotation(keepLog);
             }
         );
         timer->start(std::chrono::duration_cast<std::chrono::milliseconds>(freq));
     }
 
-    SocketHandler socketHandler = SocketHandler(config.port, config.secret);
+    SocketHandler socketHandler = SocketHandler(
+        config.port,
+        config.secret,
+        config.socket
+    );
 
-    ProcessHandler processHandler;
+    ProcessHandler processHandler = ProcessHandler(
+        config.processOutput,
+        config.outputHistory
+    );
+    socketHandler.setOutputSource(
+        [&processHandler](int processId, common::ProcessOutputMessage::OutputType type) {
+            return processHandler.outputHistory(processId, type);
+        }
+    );
 
     QObject::connect(
         &socketHandler, &SocketHandler::messageReceived,
@@ -196,6 +220,14 @@ int main(int argc, char** argv) {
         &processHandler, &ProcessHandler::sendSocketMessage,
         &socketHandler, &SocketHandler::sendMessage
     );
+    QObject::connect(
+        &processHandler, &ProcessHandler::sendProcessOutput,
+        &socketHandler, &SocketHandler::sendProcessOutput
+    );
+    QObject::connect(
+        &processHandler, &ProcessHandler::sendOnDemandOutput,
+        &socketHandler, &SocketHandler::sendOnDemandOutput
+    );
     QObject::connect(
         &processHandler, &ProcessHandler::closeApplication,
         &app, &QCoreApplication::quit, Qt::QueuedConnection
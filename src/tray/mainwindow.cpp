@@ -94,6 +94,10 @@ void MainWindow::log(std::string msg) {
     _centralWidget->log(std::move(msg));
 }
 
+void MainWindow::setMaxLogLines(std::size_t maxLines) {
+    _centralWidget->setMaxLogLines(maxLines);
+}
+
 void MainWindow::newConnection(const std::string& peerAddress) {
     _centralWidget->newConnection(peerAddress);
     _trayIcon->setIcon(_centralWidget->hasConnections() ? _onlineIcon : _offlineIcon);
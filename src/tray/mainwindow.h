@@ -56,6 +56,7 @@ public:
     void setPort(int port);
 
     void log(std::string msg);
+    void setMaxLogLines(std::size_t maxLines);
 
 public slots:
     void newConnection(const std::string& peerAddress);
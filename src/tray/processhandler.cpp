@@ -35,10 +35,13 @@
 #include "processhandler.h"
 
 #include <QMetaEnum>
+#include <QTimer>
 #include "logging.h"
 #include "messages.h"
+#include <algorithm>
 #include <filesystem>
 #include <functional>
+#include <optional>
 
 namespace {
     common::ProcessStatusMessage::Status toTrayStatus(QProcess::ProcessError error) {
@@ -63,23 +66,111 @@ namespace {
         throw std::logic_error("Unhandled case exception");
     }
 
-    void Debug(std::string msg) {
-        ::Debug("ProcessHandler", std::move(msg));
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Processes,
+            "ProcessHandler",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 
     void Log(std::string msg) {
         ::Log("ProcessHandler", std::move(msg));
     }
+
+    // The number of finished processes whose output is kept so that it can still be
+    // requested after the process has ended
+    constexpr std::size_t MaxRetiredHistories = 16;
 } // namespace
 
-ProcessHandler::ProcessHandler() {
+ProcessHandler::ProcessHandler(common::OutputCoalescer::Options outputOptions,
+                               common::OutputBuffer::Limits historyLimits)
+    : _outputOptions(outputOptions)
+    , _historyLimits(historyLimits)
+{
     Debug("Creating process handler");
+
+    _outputTimer = new QTimer(this);
+    _outputTimer->setSingleShot(true);
+    connect(_outputTimer, &QTimer::timeout, this, &ProcessHandler::sendDueOutput);
+
+    _dispatcher.on<common::StartCommandMessage>(
+        [this](common::StartCommandMessage command, const nlohmann::json& message,
+               const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            handleStartCommand(command);
+        }
+    );
+    _dispatcher.on<common::ExitCommandMessage>(
+        [this](common::ExitCommandMessage command, const nlohmann::json& message,
+               const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            handleExitCommand(command);
+        }
+    );
+    _dispatcher.on<common::KillAllMessage>(
+        [this](common::KillAllMessage, const nlohmann::json& message,
+               const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            killAllProcesses();
+        }
+    );
+    _dispatcher.on<common::KillTrayMessage>(
+        [this](common::KillTrayMessage, const nlohmann::json& message,
+               const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            emit closeApplication();
+        }
+    );
+    _dispatcher.on<common::RestartNodeMessage>(
+        [](common::RestartNodeMessage, const nlohmann::json& message,
+           const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            QProcess::startDetached("shutdown", { "/r", "/t", "0" });
+        }
+    );
+    _dispatcher.on<common::ShutdownNodeMessage>(
+        [](common::ShutdownNodeMessage, const nlohmann::json& message,
+           const std::string& peer)
+        {
+            Log(std::format("Received [{}]: {}", peer, message.dump()));
+            QProcess::startDetached("shutdown", { "/s", "/t", "0" });
+        }
+    );
+    _dispatcher.setFallback(
+        [this](const nlohmann::json&, const std::string& peer) {
+            Debug(
+                "Ignoring invalid or unknown message from {} ({} unknown so far)",
+                peer, _dispatcher.statistics().nUnknownType
+            );
+        }
+    );
 }
 
 ProcessHandler::~ProcessHandler() {
     Debug("Destroying process handler");
 }
 
+const common::OutputBuffer* ProcessHandler::outputHistory(int processId,
+                                      common::ProcessOutputMessage::OutputType type) const
+{
+    auto it = _outputHistory.find(processId);
+    if (it == _outputHistory.end()) {
+        return nullptr;
+    }
+
+    return type == common::ProcessOutputMessage::OutputType::StdOut ?
+        &it->second.stdOut :
+        &it->second.stdErr;
+}
+
 void ProcessHandler::newConnection() {
     common::TrayStatusMessage msg;
     for (const ProcessInfo& p : _processes) {
@@ -89,7 +180,10 @@ void ProcessHandler::newConnection() {
             .configurationId = p.configurationId,
             .clusterId = p.clusterId,
             .nodeId = p.nodeId,
-            .dataHash = p.dataHash
+            .dataHash = p.dataHash,
+            .programHash = p.programHash,
+            .clusterHash = p.clusterHash,
+            .nodeHash = p.nodeHash
         };
         msg.processes.push_back(std::move(pi));
     }
@@ -101,101 +195,12 @@ void ProcessHandler::handleSocketMessage(const nlohmann::json& message,
                                          const std::string& peer)
 {
     try {
-        Debug(std::format("Received message: {}", message.dump(2)));
-
-        const bool validMessage = common::isValidMessage(message);
-        if (!validMessage) {
-            Debug("Message was invalid");
-            return;
-        }
-
-        Debug("Parsing base message");
-        if (common::isValidMessage<common::StartCommandMessage>(message)) {
-            common::StartCommandMessage command = message;
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            // Check if the identifier of traycommand already is tied to a process
-            // We don't allow the same id for multiple processes
-            const auto p = processIt(command.id);
-            if (p == _processes.end()) {
-                // Not Found, create and run a process with it
-                Debug("Creating new process for command");
-                createAndRunProcessFromCommandMessage(command);
-            }
-            else {
-                // Found
-                // @TODO When would this be executed? We shouldn't be able to start a
-                // process twice with the same id?
-                Debug("Starting existing process for command");
-                executeProcessWithCommandMessage(p->process, command);
-            }
-        }
-        else if (common::isValidMessage<common::ExitCommandMessage>(message)) {
-            common::ExitCommandMessage command = message;
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            // Check if the identifier of tray command already is tied to a process
-            // We don't allow the same id for multiple processes
-            const auto p = processIt(command.id);
-            if (p == _processes.end()) {
-                // @TODO This should probably send a different message to inform the
-                // controller about this fact. It should not be possible to send a request
-                // to exit an application that is already running
-                Debug("Process was not found");
-                handlerErrorOccurred(QProcess::ProcessError::FailedToStart);
-            }
-            else {
-                // Found
-                Debug("Terminating existing process");
-                common::ProcessStatusMessage returnMsg;
-                // @TODO How does the terminate behave when the program is hanging? There
-                // seems to be a problem that a program is not correctly terminated in
-                // those cases
-                p->process->terminate();
-                returnMsg.status = common::ProcessStatusMessage::Status::NormalExit;
-                // Find specific value in process map i.e. process
-                const auto pIt = processIt(p->process);
-
-                if (pIt != _processes.end()) {
-                    Debug("Found process");
-                    returnMsg.processId = pIt->processId;
-                    emit sendSocketMessage(returnMsg);
-
-                    // Remove this process from the list as we consider it finished
-                    ProcessInfo info = *pIt;
-                    _processes.erase(pIt);
-                    emit closedProcess(info);
-                }
-            }
-        }
-        else if (common::isValidMessage<common::KillAllMessage>(message)) {
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            for (ProcessInfo& p : _processes) {
-                Log(std::format("Killing process {}", p.processId));
-
-                p.wasUserTerminated = true;
-                p.process->kill();
-                p.process->close();
-                p.process->deleteLater();
-            }
-            _processes.clear();
-        }
-        else if (common::isValidMessage<common::KillTrayMessage>(message)) {
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            emit closeApplication();
-        }
-        else if (common::isValidMessage<common::RestartNodeMessage>(message)) {
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            QProcess::startDetached("shutdown", { "/r", "/t", "0" });
-        }
-        else if (common::isValidMessage<common::ShutdownNodeMessage>(message)) {
-            Log(std::format("Received [{}]: {}", peer, message.dump()));
-
-            QProcess::startDetached("shutdown", { "/s", "/t", "0" });
-        }
+        ::Debug(
+            common::LogCategory::Messages,
+            "ProcessHandler",
+            [&message]() { return std::format("Received message: {}", message.dump(2)); }
+        );
+        _dispatcher.dispatch(message, peer);
     }
     catch (const std::exception& e) {
         Log(std::format(
@@ -204,6 +209,77 @@ void ProcessHandler::handleSocketMessage(const nlohmann::json& message,
     }
 }
 
+void ProcessHandler::handleStartCommand(const common::StartCommandMessage& command) {
+    // Check if the identifier of traycommand already is tied to a process
+    // We don't allow the same id for multiple processes
+    const auto p = processIt(command.id);
+    if (p == _processes.end()) {
+        // Not Found, create and run a process with it
+        Debug("Creating new process for command");
+        createAndRunProcessFromCommandMessage(command);
+    }
+    else {
+        // Found
+        // @TODO When would this be executed? We shouldn't be able to start a
+        // process twice with the same id?
+        Debug("Starting existing process for command");
+        executeProcessWithCommandMessage(p->process, command);
+    }
+}
+
+void ProcessHandler::handleExitCommand(const common::ExitCommandMessage& command) {
+    // Check if the identifier of tray command already is tied to a process
+    // We don't allow the same id for multiple processes
+    const auto p = processIt(command.id);
+    if (p == _processes.end()) {
+        // @TODO This should probably send a different message to inform the
+        // controller about this fact. It should not be possible to send a request
+        // to exit an application that is already running
+        Debug("Process was not found");
+        handlerErrorOccurred(QProcess::ProcessError::FailedToStart);
+    }
+    else {
+        // Found
+        Debug("Terminating existing process");
+        common::ProcessStatusMessage returnMsg;
+        // @TODO How does the terminate behave when the program is hanging? There
+        // seems to be a problem that a program is not correctly terminated in
+        // those cases
+        p->process->terminate();
+        returnMsg.status = common::ProcessStatusMessage::Status::NormalExit;
+        // Find specific value in process map i.e. process
+        const auto pIt = processIt(p->process);
+
+        if (pIt != _processes.end()) {
+            Debug("Found process");
+            sendAllOutput(pIt->processId);
+            _pendingOutput.erase(pIt->processId);
+            retireOutputHistory(pIt->processId);
+            returnMsg.processId = pIt->processId;
+            emit sendSocketMessage(returnMsg);
+
+            // Remove this process from the list as we consider it finished
+            ProcessInfo info = *pIt;
+            _processes.erase(pIt);
+            emit closedProcess(info);
+        }
+    }
+}
+
+void ProcessHandler::killAllProcesses() {
+    for (ProcessInfo& p : _processes) {
+        Log(std::format("Killing process {}", p.processId));
+
+        p.wasUserTerminated = true;
+        p.process->kill();
+        p.process->close();
+        p.process->deleteLater();
+        retireOutputHistory(p.processId);
+    }
+    _processes.clear();
+    _pendingOutput.clear();
+}
+
 void ProcessHandler::handlerErrorOccurred(QProcess::ProcessError error) {
     QProcess* process = qobject_cast<QProcess*>(QObject::sender());
     std::string err = QMetaEnum::fromType<QProcess::ProcessError>().valueToKey(error);
@@ -225,7 +301,10 @@ void ProcessHandler::handlerErrorOccurred(QProcess::ProcessError error) {
         return;
     }
 
-    Debug(std::format("Found process {}", p->processId));
+    Debug("Found process {}", p->processId);
+    // Any output the process produced has to arrive before the status change
+    sendAllOutput(p->processId);
+
     common::ProcessStatusMessage msg;
     msg.processId = p->processId;
     msg.status = toTrayStatus(error);
@@ -234,7 +313,9 @@ void ProcessHandler::handlerErrorOccurred(QProcess::ProcessError error) {
     // The FailedToStart error is handled differently since that is the one that will
     // not also lead to a `handleFinished` call
     if (error == QProcess::ProcessError::FailedToStart) {
-        Debug(std::format("Removing process {}", p->processId));
+        Debug("Removing process {}", p->processId);
+        _pendingOutput.erase(p->processId);
+        retireOutputHistory(p->processId);
         ProcessInfo info = *p;
         _processes.erase(p);
         emit closedProcess(info);
@@ -249,7 +330,7 @@ void ProcessHandler::handleStarted() {
     auto p = processIt(process);
     assert(p != _processes.end());
     if (p != _processes.end()) {
-        Debug(std::format("Found process {}", p->processId));
+        Debug("Found process {}", p->processId);
 
         // Send out the TrayProcessStatus with the status string
         common::ProcessStatusMessage msg;
@@ -272,7 +353,23 @@ void ProcessHandler::handleFinished(int, QProcess::ExitStatus exitStatus) {
         return;
     }
 
-    Debug(std::format("Found process {}", p->processId));
+    Debug("Found process {}", p->processId);
+
+    // Send the remaining output, including whatever is still left in the pipes, before
+    // the status so that the last lines of a crashing process are not lost
+    appendOutput(
+        p->processId,
+        common::ProcessOutputMessage::OutputType::StdOut,
+        process->readAllStandardOutput().toStdString()
+    );
+    appendOutput(
+        p->processId,
+        common::ProcessOutputMessage::OutputType::StdErr,
+        process->readAllStandardError().toStdString()
+    );
+    sendAllOutput(p->processId);
+    _pendingOutput.erase(p->processId);
+    retireOutputHistory(p->processId);
 
     common::ProcessStatusMessage msg;
     msg.processId = p->processId;
@@ -313,15 +410,12 @@ void ProcessHandler::handleReadyReadStandardError() {
     auto p = processIt(proc);
     assert(p != _processes.end());
     if (p != _processes.end()) {
-        Debug(std::format("Found process {}", p->processId));
-
-        // Send out the TrayProcessLogMessage with the stderror key
-        common::ProcessOutputMessage msg;
-        msg.processId = p->processId;
-        msg.outputType = common::ProcessOutputMessage::OutputType::StdErr;
-        msg.message =
-            QString::fromLatin1(proc->readAllStandardError()).toLocal8Bit().constData();
-        emit sendSocketMessage(msg);
+        Debug("Found process {}", p->processId);
+        appendOutput(
+            p->processId,
+            common::ProcessOutputMessage::OutputType::StdErr,
+            proc->readAllStandardError().toStdString()
+        );
     }
 }
 
@@ -331,14 +425,148 @@ void ProcessHandler::handleReadyReadStandardOutput() {
     // Find specific value in process map i.e. process
     auto p = processIt(proc);
     if (p != _processes.end()) {
-        common::ProcessOutputMessage msg;
-        msg.processId = p->processId;
-        msg.message =
-            QString::fromLatin1(proc->readAllStandardOutput()).toLocal8Bit().constData();
-        msg.outputType = common::ProcessOutputMessage::OutputType::StdOut;
+        appendOutput(
+            p->processId,
+            common::ProcessOutputMessage::OutputType::StdOut,
+            proc->readAllStandardOutput().toStdString()
+        );
+    }
+}
+
+void ProcessHandler::appendOutput(int processId,
+                                  common::ProcessOutputMessage::OutputType type,
+                                  std::string_view text)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    auto it = _pendingOutput.find(processId);
+    if (it == _pendingOutput.end()) {
+        const auto p = processIt(processId);
+        PendingOutput output = {
+            .stdOut = common::OutputCoalescer(_outputOptions),
+            .stdErr = common::OutputCoalescer(_outputOptions),
+            .rateLimit = common::OutputRateLimit(_outputOptions.maxBytesPerSecond),
+            .policy = p != _processes.end() ? p->outputPolicy : PendingOutput().policy,
+            .isOnDemand = p != _processes.end() && p->isOutputOnDemand
+        };
+        it = _pendingOutput.emplace(processId, std::move(output)).first;
+    }
+
+    common::OutputCoalescer& coalescer =
+        type == common::ProcessOutputMessage::OutputType::StdOut ?
+        it->second.stdOut :
+        it->second.stdErr;
 
-        // We don't need to print every console message to the log of the tray application
-        emit sendSocketMessage(msg, false);
+    const common::OutputCoalescer::Clock::time_point now =
+        common::OutputCoalescer::Clock::now();
+    const bool isFull = coalescer.append(text, now, it->second.rateLimit);
+    if (isFull) {
+        sendOutput(processId, type, coalescer, it->second);
+    }
+    else if (coalescer.hasPending() && !_outputTimer->isActive()) {
+        // Output is appended in chronological order, so a running timer always expires
+        // before the deadline of the output that was just added
+        const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+            coalescer.deadline() - now
+        );
+        _outputTimer->start(std::max(delay, std::chrono::milliseconds(0)));
+    }
+}
+
+void ProcessHandler::sendOutput(int processId,
+                                common::ProcessOutputMessage::OutputType type,
+                                common::OutputCoalescer& coalescer,
+                                const PendingOutput& output)
+{
+    if (!coalescer.hasPending()) {
+        return;
+    }
+
+    // The conversion is done once for all of the collected output instead of once for
+    // each chunk that was read from the process
+    const std::string text = coalescer.take();
+    common::ProcessOutputMessage msg;
+    msg.processId = processId;
+    msg.outputType = type;
+    const qsizetype size = static_cast<qsizetype>(text.size());
+    msg.message = QString::fromLatin1(text.data(), size).toLocal8Bit().toStdString();
+
+    if (output.isOnDemand) {
+        // The output is stored so that it can be requested later and is only sent to the
+        // connections that are currently following the process
+        auto it = _outputHistory.find(processId);
+        if (it == _outputHistory.end()) {
+            OutputHistory history = {
+                .stdOut = common::OutputBuffer(_historyLimits),
+                .stdErr = common::OutputBuffer(_historyLimits)
+            };
+            it = _outputHistory.emplace(processId, std::move(history)).first;
+        }
+        common::OutputBuffer& buffer =
+            type == common::ProcessOutputMessage::OutputType::StdOut ?
+            it->second.stdOut :
+            it->second.stdErr;
+        msg.offset = buffer.endOffset();
+        buffer.append(msg.message);
+
+        emit sendOnDemandOutput(std::move(msg), output.policy);
+    }
+    else {
+        emit sendProcessOutput(std::move(msg), output.policy);
+    }
+}
+
+void ProcessHandler::sendDueOutput() {
+    using OutputType = common::ProcessOutputMessage::OutputType;
+    using Clock = common::OutputCoalescer::Clock;
+
+    const Clock::time_point now = Clock::now();
+    std::optional<Clock::time_point> nextDeadline;
+    for (auto& [processId, output] : _pendingOutput) {
+        for (OutputType type : { OutputType::StdOut, OutputType::StdErr }) {
+            common::OutputCoalescer& coalescer =
+                type == OutputType::StdOut ? output.stdOut : output.stdErr;
+            if (!coalescer.hasPending()) {
+                continue;
+            }
+
+            if (coalescer.deadline() <= now) {
+                sendOutput(processId, type, coalescer, output);
+            }
+            else if (!nextDeadline.has_value() || coalescer.deadline() < *nextDeadline) {
+                nextDeadline = coalescer.deadline();
+            }
+        }
+    }
+
+    if (nextDeadline.has_value()) {
+        _outputTimer->start(
+            std::chrono::duration_cast<std::chrono::milliseconds>(*nextDeadline - now)
+        );
+    }
+}
+
+void ProcessHandler::sendAllOutput(int processId) {
+    auto it = _pendingOutput.find(processId);
+    if (it != _pendingOutput.end()) {
+        using OutputType = common::ProcessOutputMessage::OutputType;
+        PendingOutput& output = it->second;
+        sendOutput(processId, OutputType::StdOut, output.stdOut, output);
+        sendOutput(processId, OutputType::StdErr, output.stdErr, output);
+    }
+}
+
+void ProcessHandler::retireOutputHistory(int processId) {
+    if (!_outputHistory.contains(processId)) {
+        return;
+    }
+
+    _retiredHistory.push_back(processId);
+    while (_retiredHistory.size() > MaxRetiredHistories) {
+        _outputHistory.erase(_retiredHistory.front());
+        _retiredHistory.pop_front();
     }
 }
 
@@ -375,7 +603,7 @@ void ProcessHandler::executeProcessWithCommandMessage(QProcess* process,
 
     // If the executable does not exist, the process might still be in the NotRunning
     // state. It also will have already triggered the `errorOccurred` message by that time
-    Debug(std::format("State: {}", static_cast<int>(process->state())));
+    Debug("State: {}", static_cast<int>(process->state()));
     if (process->state() != QProcess::ProcessState::NotRunning) {
         process->waitForStarted();
         const auto p = processIt(process);
@@ -426,11 +654,19 @@ void ProcessHandler::createAndRunProcessFromCommandMessage(
         .clusterId = cmd.clusterId,
         .nodeId = cmd.nodeId,
         .dataHash = cmd.dataHash,
+        .programHash = cmd.programHash,
+        .clusterHash = cmd.clusterHash,
+        .nodeHash = cmd.nodeHash,
         .shouldAutoRestart = cmd.autoRestart,
+        .outputPolicy = cmd.outputPolicy,
+        .isOutputOnDemand = cmd.outputOnDemand,
         .startMessage = cmd
     };
     _processes.push_back(info);
 
+    // A restarted process continues the output that was kept from its previous run
+    std::erase(_retiredHistory, cmd.id);
+
     // Run the process with the command
     executeProcessWithCommandMessage(proc, cmd);
 }
@@ -37,11 +37,19 @@
 
 #include <QObject>
 
+#include "messagedispatcher.h"
 #include "messages.h"
+#include "outputbuffer.h"
+#include "outputcoalescer.h"
 #include <QProcess>
 #include <nlohmann/json.hpp>
+#include <cstdint>
+#include <deque>
 #include <map>
 #include <string>
+#include <string_view>
+
+class QTimer;
 
 class ProcessHandler : public QObject {
 Q_OBJECT
@@ -59,8 +67,13 @@ public:
         int configurationId = -1;
         int clusterId = -1;
         int nodeId = -1;
-        std::size_t dataHash = 0;
+        std::uint64_t dataHash = 0;
+        std::uint64_t programHash = 0;
+        std::uint64_t clusterHash = 0;
+        std::uint64_t nodeHash = 0;
         bool shouldAutoRestart = false;
+        common::OutputPolicy outputPolicy = common::OutputPolicy::KeepTail;
+        bool isOutputOnDemand = false;
 
         // This is only needed if `shouldAutoRestart` is enabled and is used to be able to
         // gracefully restart the process with the same arguments
@@ -71,15 +84,32 @@ public:
         bool wasUserTerminated = false;
     };
 
-    ProcessHandler();
+    ProcessHandler(common::OutputCoalescer::Options outputOptions,
+        common::OutputBuffer::Limits historyLimits);
     ~ProcessHandler();
 
+    /**
+     * Returns the output of the process with the \p processId that is kept for C-Troll to
+     * request it. This only exists for processes whose output is sent on demand and is
+     * kept for a while after the process has finished.
+     *
+     * \param processId The identifier of the process whose output is returned
+     * \param type The output stream that is returned
+     * \return The stored output or `nullptr` if no output is kept for the process
+     */
+    const common::OutputBuffer* outputHistory(int processId,
+        common::ProcessOutputMessage::OutputType type) const;
+
 public slots:
     void newConnection();
     void handleSocketMessage(const nlohmann::json& message, const std::string& peer);
 
 signals:
     void sendSocketMessage(const nlohmann::json& message, bool printMessage = true);
+    void sendProcessOutput(common::ProcessOutputMessage message,
+        common::OutputPolicy policy);
+    void sendOnDemandOutput(common::ProcessOutputMessage message,
+        common::OutputPolicy policy);
 
     void startedProcess(ProcessInfo process);
     void closedProcess(ProcessInfo process);
@@ -93,6 +123,32 @@ private slots:
     void handleStarted();
 
 private:
+    struct PendingOutput {
+        common::OutputCoalescer stdOut;
+        common::OutputCoalescer stdErr;
+        /// The rate limit is shared by both pipes so that it applies per process
+        common::OutputRateLimit rateLimit;
+        common::OutputPolicy policy = common::OutputPolicy::KeepTail;
+        bool isOnDemand = false;
+    };
+
+    struct OutputHistory {
+        common::OutputBuffer stdOut;
+        common::OutputBuffer stdErr;
+    };
+
+    void appendOutput(int processId, common::ProcessOutputMessage::OutputType type,
+        std::string_view text);
+    void sendOutput(int processId, common::ProcessOutputMessage::OutputType type,
+        common::OutputCoalescer& coalescer, const PendingOutput& output);
+    void sendDueOutput();
+    void sendAllOutput(int processId);
+    void retireOutputHistory(int processId);
+
+    void handleStartCommand(const common::StartCommandMessage& command);
+    void handleExitCommand(const common::ExitCommandMessage& command);
+    void killAllProcesses();
+
     void executeProcessWithCommandMessage(QProcess* process,
         const common::StartCommandMessage& command);
 
@@ -107,6 +163,20 @@ private:
     std::vector<ProcessInfo> _processes;
 
     std::size_t _controllerDataHash = 0;
+
+    /// The output of each process that has not been sent yet, keyed by the process id
+    std::map<int, PendingOutput> _pendingOutput;
+    const common::OutputCoalescer::Options _outputOptions;
+    /// Fires when the oldest pending output has to be sent out
+    QTimer* _outputTimer = nullptr;
+
+    /// The output of processes whose output is sent on demand, keyed by the process id
+    std::map<int, OutputHistory> _outputHistory;
+    const common::OutputBuffer::Limits _historyLimits;
+    /// The processes that have finished but whose output is still kept, oldest first
+    std::deque<int> _retiredHistory;
+
+    common::MessageDispatcher<const std::string&> _dispatcher;
 };
 
 #endif // __TRAY__PROCESSHANDLER_H__
@@ -37,6 +37,7 @@
 #include "jsonsocket.h"
 #include "logging.h"
 #include "messages.h"
+#include "outputbuffer.h"
 #include <QMessageBox>
 #include <QTcpSocket>
 #include <Windows.h>
@@ -54,13 +55,25 @@ namespace {
         );
     }
 
-    void Debug(std::string msg) {
-        ::Debug("SocketHandler", std::move(msg));
+    /// The maximum number of bytes of output that are queued for each process and
+    /// connection while the C-Troll has not granted enough credits
+    constexpr std::size_t MaxQueuedOutput = 1024 * 1024;
+
+    template <typename... Args>
+    void Debug(std::format_string<Args...> fmt, Args&&... args) {
+        ::Debug(
+            common::LogCategory::Network,
+            "SocketHandler",
+            fmt,
+            std::forward<Args>(args)...
+        );
     }
 } // namespace
 
-SocketHandler::SocketHandler(int port, std::string secret)
+SocketHandler::SocketHandler(int port, std::string secret,
+                             common::JsonSocket::Options socketOptions)
     : _secret(std::move(secret))
+    , _socketOptions(std::move(socketOptions))
 {
     Debug("Creating socket handler");
     Log("Status", std::format("Listening on port: {}", port));
@@ -76,6 +89,39 @@ SocketHandler::SocketHandler(int port, std::string secret)
         &_server, &QTcpServer::newConnection,
         this, &SocketHandler::newConnectionEstablished
     );
+
+    _dispatcher.on<common::PingMessage>(
+        [this](const common::PingMessage& message, common::JsonSocket* socket) {
+            // The heartbeats are answered right away so that the measured round-trip time
+            // only contains the time that the messages spent on the network and in queues
+            common::PongMessage pongMsg;
+            pongMsg.sequence = message.sequence;
+            sendReply(socket, std::move(pongMsg), false);
+        }
+    );
+    _dispatcher.on<common::SelectEncodingMessage>(
+        [this](const common::SelectEncodingMessage& message, common::JsonSocket* socket) {
+            handleSelectEncoding(message, socket);
+        }
+    );
+    _dispatcher.on<common::OutputCreditMessage>(
+        [this](const common::OutputCreditMessage& message, common::JsonSocket* socket) {
+            handleOutputCredit(message, socket);
+        }
+    );
+    _dispatcher.on<common::FetchOutputMessage>(
+        [this](const common::FetchOutputMessage& message, common::JsonSocket* socket) {
+            // The output is answered from the stored output of the process, so the
+            // request does not have to be passed on to the rest of the application
+            handleFetchOutput(message, socket);
+        }
+    );
+    _dispatcher.setFallback(
+        [this](const nlohmann::json& message, common::JsonSocket* socket) {
+            // All other messages are handled by the rest of the application
+            emit messageReceived(message, socket->peerAddress());
+        }
+    );
 }
 
 SocketHandler::~SocketHandler() {
@@ -86,12 +132,23 @@ std::array<SocketHandler::MessageLog, 3> SocketHandler::lastMessages() const {
     return _lastMessages;
 }
 
-void SocketHandler::handleMessage(nlohmann::json message, common::JsonSocket* socket) {
-    Debug(std::format("Received message: {}", message.dump(2)));
+void SocketHandler::setOutputSource(OutputSource source) {
+    _outputSource = std::move(source);
+}
+
+void SocketHandler::handleMessage(const nlohmann::json& message,
+                                  const common::MessageHeader& header,
+                                  common::JsonSocket* socket)
+{
+    ::Debug(
+        common::LogCategory::Messages,
+        "SocketHandler",
+        [&message]() { return std::format("Received message: {}", message.dump(2)); }
+    );
 
     common::Message msg = message;
     if (msg.secret == _secret) {
-        emit messageReceived(std::move(message), socket->peerAddress());
+        _dispatcher.dispatch(header, message, socket);
     }
     else {
         Log(std::format("Received [{}]", socket->peerAddress()), "Invalid message");
@@ -100,23 +157,191 @@ void SocketHandler::handleMessage(nlohmann::json message, common::JsonSocket* so
     }
 }
 
+void SocketHandler::handleSelectEncoding(const common::SelectEncodingMessage& message,
+                                         common::JsonSocket* socket)
+{
+    // The encoding only concerns this connection, so there is no need to pass the
+    // message on to the rest of the application
+    std::optional<common::Encoding> encoding =
+        common::encodingFromString(message.encoding);
+    if (encoding.has_value()) {
+        socket->setEncoding(*encoding);
+    }
+    else {
+        Log(
+            std::format("Received [{}]", socket->peerAddress()),
+            std::format("Unsupported encoding '{}'", message.encoding)
+        );
+    }
+    socket->setCompressionEnabled(
+        message.compression == common::JsonSocket::CompressionZlib
+    );
+}
+
+void SocketHandler::handleOutputCredit(const common::OutputCreditMessage& message,
+                                       common::JsonSocket* socket)
+{
+    // Credits are granted for each connection individually. The first grant enables the
+    // flow control as older C-Trolls never send any credits
+    auto it = _outputFlows.find(socket);
+    if (it == _outputFlows.end()) {
+        Debug("Enabling output flow control for {}", socket->peerAddress());
+        it = _outputFlows.emplace(socket, MaxQueuedOutput).first;
+        // The flow control is created empty, so pausing it does not release anything
+        it->second.setPaused(socket->hasBackpressure());
+    }
+    writeProcessOutput(socket, it->second.grant(message.credits));
+}
+
+template <typename T>
+void SocketHandler::sendReply(common::JsonSocket* socket, T message, bool printMessage) {
+    message.secret = _secret;
+    const nlohmann::json j = message;
+    if (printMessage) {
+        Log(std::format("Sending [{}]", socket->peerAddress()), j.dump());
+    }
+    socket->write(j);
+}
+
 void SocketHandler::sendMessage(const nlohmann::json& message, bool printMessage) {
+    if (printMessage && !_sockets.empty()) {
+        const std::string content = message.dump();
+        for (common::JsonSocket* jsonSocket : _sockets) {
+            Log(std::format("Sending [{}]", jsonSocket->peerAddress()), content);
+        }
+    }
+    common::JsonSocket::broadcast(_sockets, message);
+}
+
+void SocketHandler::sendProcessOutput(common::ProcessOutputMessage message,
+                                      common::OutputPolicy policy)
+{
+    // The output is shared between all connections, including those whose flow control
+    // holds it back for a while, so it is only encoded once per socket settings
+    auto output = std::make_shared<common::SharedOutput>(std::move(message));
     for (common::JsonSocket* jsonSocket : _sockets) {
-        std::string peer = jsonSocket->peerAddress();
-        if (printMessage) {
-            Log(std::format("Sending [{}]", peer), message.dump());
+        auto it = _outputFlows.find(jsonSocket);
+        if (it == _outputFlows.end()) {
+            writeProcessOutput(jsonSocket, { output });
+        }
+        else {
+            // Only the process output is subject to the flow control. All other messages
+            // are sent through `sendMessage` and can never be held up by it
+            writeProcessOutput(jsonSocket, it->second.push(output, policy));
+        }
+    }
+}
+
+void SocketHandler::sendOnDemandOutput(common::ProcessOutputMessage message,
+                                       common::OutputPolicy policy)
+{
+    const OutputStream stream = { message.processId, message.outputType };
+    common::SharedOutputPtr output;
+    for (auto& [socket, streams] : _outputFollowers) {
+        if (!streams.contains(stream)) {
+            continue;
+        }
+
+        if (!output) {
+            output = std::make_shared<common::SharedOutput>(std::move(message));
+        }
+        auto it = _outputFlows.find(socket);
+        if (it == _outputFlows.end()) {
+            writeProcessOutput(socket, { output });
+        }
+        else {
+            writeProcessOutput(socket, it->second.push(output, policy));
+        }
+    }
+}
+
+void SocketHandler::handleFetchOutput(const common::FetchOutputMessage& message,
+                                      common::JsonSocket* socket)
+{
+    Debug(
+        "Fetching output {} of process {} for {}",
+        common::toString(message.outputType), message.processId, socket->peerAddress()
+    );
+
+    const OutputStream stream = { message.processId, message.outputType };
+    if (message.follow) {
+        _outputFollowers[socket].insert(stream);
+    }
+    else if (auto it = _outputFollowers.find(socket);  it != _outputFollowers.end()) {
+        it->second.erase(stream);
+    }
+
+    const common::OutputBuffer* buffer =
+        _outputSource ? _outputSource(message.processId, message.outputType) : nullptr;
+    if (!buffer) {
+        return;
+    }
+
+    // Only the most recent `maxBytes` are sent, even if an older offset was requested
+    const std::uint64_t end = buffer->endOffset();
+    std::uint64_t begin = message.offset.value_or(0);
+    if (end - buffer->beginOffset() > message.maxBytes) {
+        begin = std::max(begin, end - message.maxBytes);
+    }
+    begin = std::max(begin, buffer->beginOffset());
+    if (begin >= end) {
+        return;
+    }
+
+    common::ProcessOutputMessage reply;
+    reply.processId = message.processId;
+    reply.outputType = message.outputType;
+    reply.offset = begin;
+    reply.message = buffer->text(begin);
+
+    auto output = std::make_shared<common::SharedOutput>(std::move(reply));
+    auto it = _outputFlows.find(socket);
+    if (it == _outputFlows.end()) {
+        writeProcessOutput(socket, { std::move(output) });
+    }
+    else {
+        writeProcessOutput(
+            socket,
+            it->second.push(std::move(output), common::OutputPolicy::KeepTail)
+        );
+    }
+}
+
+void SocketHandler::writeProcessOutput(common::JsonSocket* socket,
+                                   const std::vector<common::SharedOutputPtr>& outputs)
+{
+    for (const common::SharedOutputPtr& output : outputs) {
+        if (!output->encoded) {
+            const common::ProcessOutputMessage& message = output->message;
+            output->encoded =
+                std::make_shared<common::SharedMessage>(nlohmann::json(message));
+
+            // We don't need to print every console message to the log of the tray
+            // application. The error output is logged once, no matter how many sockets
+            // it is sent to
+            if (message.outputType == common::ProcessOutputMessage::OutputType::StdErr) {
+                Log(
+                    "Sending",
+                    std::format(
+                        "Error output of process {}: {}",
+                        message.processId, message.message
+                    )
+                );
+            }
         }
-        jsonSocket->write(message);
+        socket->write(*output->encoded);
     }
 }
 
 void SocketHandler::disconnected(common::JsonSocket* socket) {
-    Debug(std::format("Disconnected remote socket to {}", socket->peerAddress()));
+    Debug("Disconnected remote socket to {}", socket->peerAddress());
 
     auto ptr = std::find(_sockets.begin(), _sockets.end(), socket);
     if (ptr != _sockets.end()) {
         (*ptr)->deleteLater();
         _sockets.erase(ptr);
+        _outputFlows.erase(socket);
+        _outputFollowers.erase(socket);
         Log("Status", std::format("Socket from {} disconnected", socket->peerAddress()));
 
         emit closedConnection(socket->peerAddress());
@@ -132,34 +357,55 @@ void SocketHandler::newConnectionEstablished() {
             std::unique_ptr<QTcpSocket>(_server.nextPendingConnection()),
             _secret
         );
+        socket->setOptions(_socketOptions);
 
-        Debug(std::format("Creating new connection to {}", socket->peerAddress()));
+        Debug("Creating new connection to {}", socket->peerAddress());
 
         connect(
             socket, &common::JsonSocket::disconnected,
             [this, socket]() { disconnected(socket); }
         );
 
+        connect(
+            socket, &common::JsonSocket::backpressureChanged,
+            [this, socket](bool hasBackpressure) {
+                // The process output is held back while C-Troll is not able to keep up
+                // with it and the output that was queued meanwhile is sent afterwards
+                const auto it = _outputFlows.find(socket);
+                if (it != _outputFlows.end()) {
+                    writeProcessOutput(socket, it->second.setPaused(hasBackpressure));
+                }
+            }
+        );
+
         connect(
             socket, &common::JsonSocket::messageReceived,
             [this, socket](nlohmann::json message) {
                 try {
                     // We store a copy of the last n messages to be able to print those in
-                    // case of a catastrophic error
-                    std::rotate(
-                        _lastMessages.rbegin(),
-                        _lastMessages.rbegin() + 1,
-                        _lastMessages.rend()
-                    );
-
-                    MessageLog ml = {
-                        .time = currentTime(),
-                        .message = message,
-                        .peer = socket->peerAddress()
-                    };
-                    _lastMessages.front() = std::move(ml);
-
-                    handleMessage(message, socket);
+                    // case of a catastrophic error. The heartbeats arrive continuously
+                    // and would push out all of the interesting messages
+                    const common::MessageHeader header =
+                        common::decodeMessageHeader(message);
+                    const bool isPing =
+                        header.status == common::MessageHeader::Status::Valid &&
+                        header.typeId == common::messageTypeId<common::PingMessage>;
+                    if (!isPing) {
+                        std::rotate(
+                            _lastMessages.rbegin(),
+                            _lastMessages.rbegin() + 1,
+                            _lastMessages.rend()
+                        );
+
+                        MessageLog ml = {
+                            .time = currentTime(),
+                            .message = message,
+                            .peer = socket->peerAddress()
+                        };
+                        _lastMessages.front() = std::move(ml);
+                    }
+
+                    handleMessage(message, header, socket);
                 }
                 catch (const std::exception& e) {
                     Log("Message Decode", e.what());
@@ -171,10 +417,14 @@ void SocketHandler::newConnectionEstablished() {
         Log("Status", std::format("Socket connected from {}", socket->peerAddress()));
 
         common::TrayConnectedMessage msg;
-        Log(std::format(
-            "Sending [{}]", socket->peerAddress()), nlohmann::json(msg).dump()
-        );
-        socket->write(msg);
+        msg.encodings = {
+            std::string(common::toString(common::Encoding::MessagePack)),
+            std::string(common::toString(common::Encoding::Cbor))
+        };
+        msg.compressions = { std::string(common::JsonSocket::CompressionZlib) };
+        msg.supportsOutputCredits = true;
+        msg.supportsHeartbeat = true;
+        sendReply(socket, std::move(msg));
 
         emit newConnection(socket->peerAddress());
     }
@@ -37,12 +37,22 @@
 
 #include <QObject>
 
+#include "jsonsocket.h"
+#include "messagedispatcher.h"
+#include "messages.h"
+#include "outputflowcontrol.h"
 #include <QTcpServer>
 #include <nlohmann/json.hpp>
 #include <array>
+#include <functional>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 
-namespace common { class JsonSocket; }
+namespace common {
+    class OutputBuffer;
+} // namespace common
 
 class SocketHandler : public QObject {
 Q_OBJECT
@@ -53,13 +63,26 @@ public:
         std::string peer;
     };
 
-    SocketHandler(int port, std::string secret);
+    SocketHandler(int port, std::string secret,
+        common::JsonSocket::Options socketOptions);
     ~SocketHandler();
 
     std::array<MessageLog, 3> lastMessages() const;
 
+    /// Returns the stored output of a process or `nullptr` if there is none
+    using OutputSource = std::function<
+        const common::OutputBuffer*(int, common::ProcessOutputMessage::OutputType)
+    >;
+
+    /// Sets the \p source that is used to answer the FetchOutputMessages
+    void setOutputSource(OutputSource source);
+
 public slots:
     void sendMessage(const nlohmann::json& message, bool printMessage = true);
+    void sendProcessOutput(common::ProcessOutputMessage message,
+        common::OutputPolicy policy);
+    void sendOnDemandOutput(common::ProcessOutputMessage message,
+        common::OutputPolicy policy);
 
 signals:
     void newConnection(const std::string& peerAddress);
@@ -69,11 +92,41 @@ signals:
 private:
     void newConnectionEstablished();
     void disconnected(common::JsonSocket* socket);
-    void handleMessage(nlohmann::json message, common::JsonSocket* socket);
+    void handleMessage(const nlohmann::json& message,
+        const common::MessageHeader& header, common::JsonSocket* socket);
+    void handleSelectEncoding(const common::SelectEncodingMessage& message,
+        common::JsonSocket* socket);
+    void handleOutputCredit(const common::OutputCreditMessage& message,
+        common::JsonSocket* socket);
+    void handleFetchOutput(const common::FetchOutputMessage& message,
+        common::JsonSocket* socket);
+    /// Sends the \p message to the C-Troll on the \p socket in reply to one of its
+    /// messages
+    template <typename T>
+    void sendReply(common::JsonSocket* socket, T message, bool printMessage = true);
+    void writeProcessOutput(common::JsonSocket* socket,
+        const std::vector<common::SharedOutputPtr>& outputs);
 
     QTcpServer _server;
     std::vector<common::JsonSocket*> _sockets;
     std::string _secret;
+    /// The options that are applied to all incoming connections
+    common::JsonSocket::Options _socketOptions;
+
+    /// Handles the messages that only concern the connection they were received on and
+    /// passes all other messages on through the messageReceived signal
+    common::MessageDispatcher<common::JsonSocket*> _dispatcher;
+
+    /// The flow control for the connections whose C-Troll grants output credits. Process
+    /// output is sent without any limit to connections that are not part of this map.
+    /// The flow control is paused while its connection has backpressure
+    std::map<common::JsonSocket*, common::OutputFlowControl> _outputFlows;
+
+    using OutputStream = std::pair<int, common::ProcessOutputMessage::OutputType>;
+    /// The output streams of processes with on-demand output that each connection wants
+    /// to receive as the output arrives
+    std::map<common::JsonSocket*, std::set<OutputStream>> _outputFollowers;
+    OutputSource _outputSource;
 
     std::array<MessageLog, 3> _lastMessages;
 };
@@ -128,6 +128,25 @@ TEST_CASE("Cluster.nodes", "[Cluster]") {
     CHECK(msgDeserialize.nodes[1] == "bar");
 
 
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("Cluster.launchConcurrency", "[Cluster]") {
+    Cluster msg;
+    msg.launchConcurrency = 4;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    Cluster msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.launchConcurrency == 4);
+
+
     nlohmann::json j2;
     to_json(j2, msgDeserialize);
     CHECK(j1 == j2);
@@ -0,0 +1,213 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "entityindex.h"
+#include "node.h"
+#include "program.h"
+#include "typedid.h"
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <vector>
+
+namespace {
+    struct Unnamed {
+        using ID = TypedId<struct UnnamedTag>;
+        ID id{ -1 };
+    };
+
+    template <typename T>
+    std::vector<std::unique_ptr<T>> createEntities(int n, std::string_view prefix) {
+        std::vector<std::unique_ptr<T>> res;
+        for (int i = 0; i < n; i++) {
+            std::unique_ptr<T> entity = std::make_unique<T>();
+            entity->id = i;
+            entity->name = std::format("{}-{}", prefix, i);
+            res.push_back(std::move(entity));
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("EntityIndex Empty", "[EntityIndex]") {
+    common::EntityIndex<Node> index;
+    CHECK(index.size() == 0);
+    CHECK(index.find(Node::ID(0)) == nullptr);
+    CHECK(index.find("node") == nullptr);
+}
+
+TEST_CASE("EntityIndex Find", "[EntityIndex]") {
+    std::vector<std::unique_ptr<Node>> nodes = createEntities<Node>(10, "node");
+    common::EntityIndex<Node> index;
+    for (const std::unique_ptr<Node>& node : nodes) {
+        index.insert(node.get());
+    }
+
+    CHECK(index.size() == 10);
+    CHECK(index.find(Node::ID(3)) == nodes[3].get());
+    CHECK(index.find("node-7") == nodes[7].get());
+    CHECK(index.find(Node::ID(10)) == nullptr);
+    CHECK(index.find("node-10") == nullptr);
+}
+
+TEST_CASE("EntityIndex First Duplicate Wins", "[EntityIndex]") {
+    std::vector<std::unique_ptr<Node>> nodes = createEntities<Node>(3, "node");
+    nodes[2]->id = 1;
+    nodes[2]->name = "node-0";
+
+    common::EntityIndex<Node> index;
+    for (const std::unique_ptr<Node>& node : nodes) {
+        index.insert(node.get());
+    }
+
+    CHECK(index.find(Node::ID(1)) == nodes[1].get());
+    CHECK(index.find("node-0") == nodes[0].get());
+}
+
+TEST_CASE("EntityIndex Clear", "[EntityIndex]") {
+    std::vector<std::unique_ptr<Node>> nodes = createEntities<Node>(2, "node");
+    common::EntityIndex<Node> index;
+    index.insert(nodes[0].get());
+    index.insert(nodes[1].get());
+    index.clear();
+
+    CHECK(index.size() == 0);
+    CHECK(index.find(Node::ID(0)) == nullptr);
+    CHECK(index.find("node-1") == nullptr);
+}
+
+TEST_CASE("EntityIndex Erase", "[EntityIndex]") {
+    std::vector<std::unique_ptr<Node>> nodes = createEntities<Node>(3, "node");
+    common::EntityIndex<Node> index;
+    for (const std::unique_ptr<Node>& node : nodes) {
+        index.insert(node.get());
+    }
+    index.erase(nodes[1].get());
+
+    CHECK(index.size() == 2);
+    CHECK(index.find(Node::ID(1)) == nullptr);
+    CHECK(index.find("node-1") == nullptr);
+    CHECK(index.find(Node::ID(2)) == nodes[2].get());
+}
+
+TEST_CASE("EntityIndex Without Name", "[EntityIndex]") {
+    static_assert(!common::EntityIndex<Unnamed>::HasName);
+
+    Unnamed entity;
+    entity.id = 5;
+    common::EntityIndex<Unnamed> index;
+    index.insert(&entity);
+    CHECK(index.find(Unnamed::ID(5)) == &entity);
+}
+
+// The benchmarks are hidden by default and can be run with:  UnitTest "[benchmark]"
+TEST_CASE("EntityIndex Lookup Benchmark", "[EntityIndex][.benchmark]") {
+    // The size of a large installation
+    std::vector<std::unique_ptr<Node>> nodes = createEntities<Node>(500, "node");
+    std::vector<std::unique_ptr<Program>> programs =
+        createEntities<Program>(300, "program");
+
+    common::EntityIndex<Node> nodeIndex;
+    for (const std::unique_ptr<Node>& node : nodes) {
+        nodeIndex.insert(node.get());
+    }
+    common::EntityIndex<Program> programIndex;
+    for (const std::unique_ptr<Program>& program : programs) {
+        programIndex.insert(program.get());
+    }
+
+    BENCHMARK("Linear search node by id") {
+        int found = 0;
+        for (int i = 0; i < 500; i++) {
+            const auto it = std::find_if(
+                nodes.begin(), nodes.end(),
+                [i](const std::unique_ptr<Node>& n) { return n->id.v == i; }
+            );
+            found += it != nodes.end();
+        }
+        return found;
+    };
+
+    BENCHMARK("Indexed search node by id") {
+        int found = 0;
+        for (int i = 0; i < 500; i++) {
+            found += nodeIndex.find(Node::ID(i)) != nullptr;
+        }
+        return found;
+    };
+
+    BENCHMARK("Linear search node by name") {
+        int found = 0;
+        for (const std::unique_ptr<Node>& node : nodes) {
+            const std::string_view name = node->name;
+            const auto it = std::find_if(
+                nodes.begin(), nodes.end(),
+                [name](const std::unique_ptr<Node>& n) { return n->name == name; }
+            );
+            found += it != nodes.end();
+        }
+        return found;
+    };
+
+    BENCHMARK("Indexed search node by name") {
+        int found = 0;
+        for (const std::unique_ptr<Node>& node : nodes) {
+            found += nodeIndex.find(std::string_view(node->name)) != nullptr;
+        }
+        return found;
+    };
+
+    BENCHMARK("Linear search program by id") {
+        int found = 0;
+        for (int i = 0; i < 300; i++) {
+            const auto it = std::find_if(
+                programs.begin(), programs.end(),
+                [i](const std::unique_ptr<Program>& p) { return p->id.v == i; }
+            );
+            found += it != programs.end();
+        }
+        return found;
+    };
+
+    BENCHMARK("Indexed search program by id") {
+        int found = 0;
+        for (int i = 0; i < 300; i++) {
+            found += programIndex.find(Program::ID(i)) != nullptr;
+        }
+        return found;
+    };
+}
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "messages/fetchoutputmessage.h"
+#include <nlohmann/json.hpp>
+
+TEST_CASE("FetchOutputMessage Default Ctor", "[FetchOutputMessage]") {
+    common::FetchOutputMessage msg;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::FetchOutputMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("FetchOutputMessage Correct Type", "[FetchOutputMessage]") {
+    common::FetchOutputMessage msg;
+    CHECK(msg.type == common::FetchOutputMessage::Type);
+
+
+    nlohmann::json j;
+    to_json(j, msg);
+
+    common::FetchOutputMessage msgDeserialize;
+    from_json(j, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.type == common::FetchOutputMessage::Type);
+}
+
+TEST_CASE("FetchOutputMessage.outputType", "[FetchOutputMessage]") {
+    common::FetchOutputMessage msg;
+    msg.outputType = common::ProcessOutputMessage::OutputType::StdErr;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::FetchOutputMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.outputType == common::ProcessOutputMessage::OutputType::StdErr);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("FetchOutputMessage.offset", "[FetchOutputMessage]") {
+    common::FetchOutputMessage msg;
+    msg.offset = 123456789012;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::FetchOutputMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    REQUIRE(msgDeserialize.offset.has_value());
+    CHECK(*msgDeserialize.offset == 123456789012);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("FetchOutputMessage full", "[FetchOutputMessage]") {
+    common::FetchOutputMessage msg;
+    msg.processId = 13;
+    msg.offset = 14;
+    msg.maxBytes = 15;
+    msg.follow = true;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::FetchOutputMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.processId == 13);
+    CHECK(msgDeserialize.offset == 14);
+    CHECK(msgDeserialize.maxBytes == 15);
+    CHECK(msgDeserialize.follow);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
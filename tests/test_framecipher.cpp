@@ -0,0 +1,138 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "framecipher.h"
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <string>
+
+TEST_CASE("FrameCipher Keystream", "[FrameCipher]") {
+    // Test vector from RFC 8439, Section 2.4.2
+    std::array<std::uint8_t, common::FrameCipher::KeySize> key;
+    std::iota(key.begin(), key.end(), std::uint8_t(0));
+    const std::array<std::uint8_t, common::FrameCipher::NonceSize> nonce = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00
+    };
+    std::string data =
+        "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+        "for the future, sunscreen would be it.";
+
+    common::FrameCipher::applyKeystream(key, nonce, 1, data);
+
+    const std::array<std::uint8_t, 114> expected = {
+        0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd,
+        0x0d, 0x69, 0x81, 0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27,
+        0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b, 0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33,
+        0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57, 0x16, 0x39, 0xd6, 0x24,
+        0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8, 0x07,
+        0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22,
+        0xb6, 0x5e, 0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9,
+        0x1a, 0xb7, 0x79, 0x37, 0x36, 0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6,
+        0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42, 0x87, 0x4d
+    };
+    REQUIRE(data.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        CHECK(static_cast<std::uint8_t>(data[i]) == expected[i]);
+    }
+}
+
+TEST_CASE("FrameCipher Round Trip", "[FrameCipher]") {
+    common::FrameCipher sender = common::FrameCipher("secret");
+    common::FrameCipher receiver = common::FrameCipher("secret");
+
+    for (std::size_t size : { 0, 1, 63, 64, 65, 1000, 100000 }) {
+        std::string plaintext = std::string(size, '\0');
+        for (std::size_t i = 0; i < size; i++) {
+            plaintext[i] = static_cast<char>(i * 7);
+        }
+
+        std::string encrypted;
+        sender.encrypt(plaintext, "m", encrypted);
+        CHECK(encrypted.size() == plaintext.size() + common::FrameCipher::Overhead);
+
+        std::string decrypted;
+        receiver.decrypt(encrypted, "m", decrypted);
+        CHECK(decrypted == plaintext);
+    }
+}
+
+TEST_CASE("FrameCipher Fresh Nonce", "[FrameCipher]") {
+    common::FrameCipher cipher = common::FrameCipher("secret");
+
+    std::string first;
+    cipher.encrypt("abcdefgh", "", first);
+    std::string second;
+    cipher.encrypt("abcdefgh", "", second);
+    CHECK(first != second);
+}
+
+TEST_CASE("FrameCipher Tampered Frame", "[FrameCipher]") {
+    common::FrameCipher cipher = common::FrameCipher("secret");
+    std::string encrypted;
+    cipher.encrypt(R"({"type":"KillAllMessage"})", "", encrypted);
+
+    std::string decrypted;
+    for (std::size_t i = 0; i < encrypted.size(); i++) {
+        std::string tampered = encrypted;
+        tampered[i] = static_cast<char>(tampered[i] ^ 0x01);
+        CHECK_THROWS(cipher.decrypt(tampered, "", decrypted));
+    }
+    CHECK_THROWS(cipher.decrypt(encrypted.substr(0, encrypted.size() - 1), "", decrypted));
+    CHECK_THROWS(cipher.decrypt("", "", decrypted));
+}
+
+TEST_CASE("FrameCipher Associated Data", "[FrameCipher]") {
+    common::FrameCipher cipher = common::FrameCipher("secret");
+    std::string encrypted;
+    cipher.encrypt("abc", "cz", encrypted);
+
+    std::string decrypted;
+    CHECK_THROWS(cipher.decrypt(encrypted, "c", decrypted));
+    CHECK_THROWS(cipher.decrypt(encrypted, "mz", decrypted));
+    cipher.decrypt(encrypted, "cz", decrypted);
+    CHECK(decrypted == "abc");
+}
+
+TEST_CASE("FrameCipher Wrong Secret", "[FrameCipher]") {
+    common::FrameCipher sender = common::FrameCipher("secret");
+    common::FrameCipher receiver = common::FrameCipher("other secret");
+
+    std::string encrypted;
+    sender.encrypt("abc", "", encrypted);
+    std::string decrypted;
+    CHECK_THROWS(receiver.decrypt(encrypted, "", decrypted));
+}
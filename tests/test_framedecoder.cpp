@@ -0,0 +1,346 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "framedecoder.h"
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace {
+    std::string frame(std::string_view payload) {
+        return std::to_string(payload.size()) + "#" + std::string(payload);
+    }
+
+    std::string frame(std::string_view payload, common::Encoding encoding) {
+        std::array<char, common::MaxFrameHeaderSize> header;
+        std::size_t size = common::encodeFrameHeader(header, payload.size(), encoding);
+        return std::string(header.data(), size) + std::string(payload);
+    }
+
+    std::optional<std::string_view> nextPayload(common::FrameDecoder& decoder) {
+        std::optional<common::Frame> f = decoder.nextFrame();
+        if (!f.has_value()) {
+            return std::nullopt;
+        }
+        return f->payload;
+    }
+} // namespace
+
+TEST_CASE("FrameDecoder Empty", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    CHECK(decoder.size() == 0);
+    CHECK(!decoder.nextFrame().has_value());
+}
+
+TEST_CASE("FrameDecoder Single Frame", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    std::string data = frame(R"({"a":1})");
+    decoder.append(data);
+
+    std::optional<common::Frame> f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == R"({"a":1})");
+    CHECK(f->encoding == common::Encoding::Json);
+    CHECK(!decoder.nextFrame().has_value());
+    CHECK(decoder.size() == 0);
+}
+
+TEST_CASE("FrameDecoder Multiple Frames", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    std::string data = frame("abc") + frame("defgh") + frame("ij");
+    decoder.append(data);
+
+    CHECK(nextPayload(decoder) == "abc");
+    CHECK(nextPayload(decoder) == "defgh");
+    CHECK(nextPayload(decoder) == "ij");
+    CHECK(!decoder.nextFrame().has_value());
+}
+
+TEST_CASE("FrameDecoder Split Header", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    decoder.append(std::string_view("1"));
+    CHECK(!decoder.nextFrame().has_value());
+    decoder.append(std::string_view("2"));
+    CHECK(!decoder.nextFrame().has_value());
+    decoder.append(std::string_view("#abcdefghijkl"));
+    CHECK(nextPayload(decoder) == "abcdefghijkl");
+}
+
+TEST_CASE("FrameDecoder Split Payload", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    const std::string data = frame("Hello World") + frame("second");
+    const std::string_view view = data;
+
+    decoder.append(view.substr(0, 8));
+    CHECK(!decoder.nextFrame().has_value());
+    decoder.append(view.substr(8, 10));
+    CHECK(nextPayload(decoder) == "Hello World");
+    CHECK(!decoder.nextFrame().has_value());
+    decoder.append(view.substr(18));
+    CHECK(nextPayload(decoder) == "second");
+    CHECK(decoder.size() == 0);
+}
+
+TEST_CASE("FrameDecoder Byte By Byte", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    std::string data = frame("abc") + frame("") + frame("defgh");
+
+    std::vector<std::string> frames;
+    for (char c : data) {
+        decoder.append(std::string_view(&c, 1));
+        while (std::optional<common::Frame> f = decoder.nextFrame()) {
+            frames.emplace_back(f->payload);
+        }
+    }
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[0] == "abc");
+    CHECK(frames[1].empty());
+    CHECK(frames[2] == "defgh");
+}
+
+TEST_CASE("FrameDecoder Wrap Around", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+
+    // Move the read position close to the end of the ring buffer while keeping the
+    // beginning of the second frame in it, so that the rest of the second frame has to
+    // wrap around the end of the ring buffer without the buffer growing
+    const std::string large = std::string(3000, 'a');
+    const std::string payload = std::string(1500, 'b') + std::string(1500, 'c');
+    const std::string data = frame(large) + frame(payload);
+    const std::size_t split = frame(large).size() + 10;
+
+    decoder.append(std::string_view(data).substr(0, split));
+    CHECK(nextPayload(decoder) == large);
+    CHECK(!decoder.nextFrame().has_value());
+
+    decoder.append(std::string_view(data).substr(split));
+    CHECK(nextPayload(decoder) == payload);
+    CHECK(decoder.size() == 0);
+}
+
+TEST_CASE("FrameDecoder Grow", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+
+    const std::string payload = std::string(100000, 'x');
+    std::string data = frame("abc") + frame(payload) + frame("def");
+    decoder.append(data);
+    CHECK(nextPayload(decoder) == "abc");
+    CHECK(nextPayload(decoder) == payload);
+    CHECK(nextPayload(decoder) == "def");
+}
+
+TEST_CASE("FrameDecoder Write Region", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    const std::string data = frame("abc") + frame("defg");
+
+    std::string_view remaining = data;
+    while (!remaining.empty()) {
+        std::span<char> region = decoder.writeRegion(remaining.size());
+        REQUIRE(!region.empty());
+        std::copy_n(remaining.begin(), region.size(), region.begin());
+        decoder.commit(region.size());
+        remaining.remove_prefix(region.size());
+    }
+
+    CHECK(nextPayload(decoder) == "abc");
+    CHECK(nextPayload(decoder) == "defg");
+}
+
+TEST_CASE("FrameDecoder Pending Frame Size", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    decoder.append(std::string_view("5#ab"));
+    CHECK(!decoder.nextFrame().has_value());
+    CHECK(decoder.pendingFrameSize() == 5);
+
+    decoder.clear();
+    CHECK(decoder.size() == 0);
+    CHECK(!decoder.pendingFrameSize().has_value());
+}
+
+TEST_CASE("FrameDecoder Maximum Frame Size", "[FrameDecoder]") {
+    common::FrameDecoder decoder = common::FrameDecoder(16);
+    decoder.append(frame(std::string(16, 'a')));
+    CHECK(nextPayload(decoder) == std::string(16, 'a'));
+
+    decoder.append(std::string_view("17#"));
+    CHECK_THROWS(decoder.nextFrame());
+}
+
+TEST_CASE("FrameDecoder Invalid Header", "[FrameDecoder]") {
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("{\"a\":1}"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string(30, '0'));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+}
+
+TEST_CASE("FrameDecoder Encoding Flags", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    std::string data = frame("abc", common::Encoding::Json) +
+        frame("defg", common::Encoding::Cbor) +
+        frame("hi", common::Encoding::MessagePack);
+    decoder.append(data);
+
+    std::optional<common::Frame> f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "abc");
+    CHECK(f->encoding == common::Encoding::Json);
+
+    f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "defg");
+    CHECK(f->encoding == common::Encoding::Cbor);
+
+    f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "hi");
+    CHECK(f->encoding == common::Encoding::MessagePack);
+}
+
+TEST_CASE("FrameDecoder Encode Header", "[FrameDecoder]") {
+    std::array<char, common::MaxFrameHeaderSize> header;
+
+    std::size_t size = common::encodeFrameHeader(header, 123, common::Encoding::Json);
+    CHECK(std::string_view(header.data(), size) == "123#");
+
+    size = common::encodeFrameHeader(header, 0, common::Encoding::Cbor);
+    CHECK(std::string_view(header.data(), size) == "0c#");
+
+    size = common::encodeFrameHeader(header, 45, common::Encoding::MessagePack);
+    CHECK(std::string_view(header.data(), size) == "45m#");
+
+    size = common::encodeFrameHeader(header, 67, common::Encoding::Json, true);
+    CHECK(std::string_view(header.data(), size) == "67z#");
+
+    size = common::encodeFrameHeader(header, 89, common::Encoding::Cbor, true);
+    CHECK(std::string_view(header.data(), size) == "89cz#");
+
+    size = common::encodeFrameHeader(header, 10, common::Encoding::Json, false, true);
+    CHECK(std::string_view(header.data(), size) == "10e#");
+
+    size = common::encodeFrameHeader(
+        header, 11, common::Encoding::MessagePack, true, true
+    );
+    CHECK(std::string_view(header.data(), size) == "11mze#");
+}
+
+TEST_CASE("FrameDecoder Compression Flag", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    decoder.append(std::string_view("3z#abc4mz#defg2#hi"));
+
+    std::optional<common::Frame> f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "abc");
+    CHECK(f->encoding == common::Encoding::Json);
+    CHECK(f->isCompressed);
+
+    f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "defg");
+    CHECK(f->encoding == common::Encoding::MessagePack);
+    CHECK(f->isCompressed);
+
+    f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "hi");
+    CHECK(!f->isCompressed);
+}
+
+TEST_CASE("FrameDecoder Encryption Flag", "[FrameDecoder]") {
+    common::FrameDecoder decoder;
+    decoder.append(std::string_view("3e#abc4cze#defg"));
+
+    std::optional<common::Frame> f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "abc");
+    CHECK(f->encoding == common::Encoding::Json);
+    CHECK(!f->isCompressed);
+    CHECK(f->isEncrypted);
+
+    f = decoder.nextFrame();
+    REQUIRE(f.has_value());
+    CHECK(f->payload == "defg");
+    CHECK(f->encoding == common::Encoding::Cbor);
+    CHECK(f->isCompressed);
+    CHECK(f->isEncrypted);
+}
+
+TEST_CASE("FrameDecoder Invalid Flag", "[FrameDecoder]") {
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("3x#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("3cm#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("3c3#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("3zz#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+    {
+        common::FrameDecoder decoder;
+        decoder.append(std::string_view("z3#abc"));
+        CHECK_THROWS(decoder.nextFrame());
+    }
+}
+
+TEST_CASE("Encoding Names", "[FrameDecoder]") {
+    for (common::Encoding e : { common::Encoding::Json, common::Encoding::Cbor,
+                                common::Encoding::MessagePack })
+    {
+        CHECK(common::encodingFromString(common::toString(e)) == e);
+    }
+    CHECK(!common::encodingFromString("xml").has_value());
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "hash.h"
+#include <string>
+
+TEST_CASE("xxHash64 Reference Values", "[Hash]") {
+    // Values from the reference implementation, covering inputs shorter and longer
+    // than one 32 byte stripe
+    CHECK(common::xxHash64("") == 0xEF46DB3751D8E999ull);
+    CHECK(common::xxHash64("a") == 0xD24EC4F1A98C6E5Bull);
+    CHECK(common::xxHash64("abc") == 0x44BC2CF5AD770999ull);
+    CHECK(
+        common::xxHash64("Nobody inspects the spammish repetition") ==
+        0xFBCEA83C8A378BF1ull
+    );
+}
+
+TEST_CASE("xxHash64 Seed", "[Hash]") {
+    CHECK(common::xxHash64("abc", 1) != common::xxHash64("abc"));
+    CHECK(common::xxHash64("abc", 1) == common::xxHash64("abc", 1));
+}
+
+TEST_CASE("HashBuilder", "[Hash]") {
+    const std::uint64_t hash = common::HashBuilder().add("ab").add("c").value();
+    CHECK(hash == common::HashBuilder().add("ab").add("c").value());
+    // The fields are separated from each other
+    CHECK(hash != common::HashBuilder().add("a").add("bc").value());
+    CHECK(hash != common::HashBuilder().add("abc").value());
+    // The order of the fields matters
+    CHECK(hash != common::HashBuilder().add("c").add("ab").value());
+
+    CHECK(
+        common::HashBuilder().add(1).value() == common::HashBuilder().add(1).value()
+    );
+    CHECK(
+        common::HashBuilder().add(1).value() != common::HashBuilder().add(2).value()
+    );
+    CHECK(
+        common::HashBuilder().add(true).value() !=
+        common::HashBuilder().add(false).value()
+    );
+}
@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "heartbeatmonitor.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+    using Monitor = common::HeartbeatMonitor;
+
+    const Monitor::Clock::time_point T0 = Monitor::Clock::time_point(100s);
+} // namespace
+
+TEST_CASE("HeartbeatMonitor Empty", "[HeartbeatMonitor]") {
+    Monitor monitor;
+    CHECK_FALSE(monitor.nextUpdate().has_value());
+    CHECK_FALSE(monitor.statistics(1).has_value());
+
+    Monitor::Actions actions = monitor.update(T0);
+    CHECK(actions.ping.empty());
+    CHECK(actions.dead.empty());
+}
+
+TEST_CASE("HeartbeatMonitor Interval", "[HeartbeatMonitor]") {
+    Monitor monitor({ .interval = 1s });
+    monitor.add(1, T0);
+    REQUIRE(monitor.nextUpdate().has_value());
+    CHECK(*monitor.nextUpdate() == T0);
+
+    Monitor::Actions actions = monitor.update(T0);
+    REQUIRE(actions.ping.size() == 1);
+    CHECK(actions.ping[0].id == 1);
+    CHECK(*monitor.nextUpdate() == T0 + 1s);
+
+    // No heartbeat is sent before the interval has passed
+    CHECK(monitor.update(T0 + 999ms).ping.empty());
+    CHECK(monitor.receivePong(1, actions.ping[0].sequence, T0 + 2ms));
+
+    Monitor::Actions next = monitor.update(T0 + 1s);
+    REQUIRE(next.ping.size() == 1);
+    CHECK(next.ping[0].sequence != actions.ping[0].sequence);
+}
+
+TEST_CASE("HeartbeatMonitor Round-Trip Times", "[HeartbeatMonitor]") {
+    Monitor monitor({ .interval = 1s });
+    monitor.add(1, T0);
+    monitor.add(2, T0);
+
+    Monitor::Clock::time_point now = T0;
+    for (int i = 0; i < 100; i++) {
+        for (const Monitor::Ping& ping : monitor.update(now).ping) {
+            // The second connection is ten times slower and has a slow answer every now
+            // and then
+            std::chrono::microseconds rtt = ping.id == 1 ? 1ms : 10ms;
+            if (ping.id == 2 && i % 10 == 0) {
+                rtt = 200ms;
+            }
+            CHECK(monitor.receivePong(ping.id, ping.sequence, now + rtt));
+        }
+        now += 1s;
+    }
+
+    std::optional<Monitor::Statistics> s1 = monitor.statistics(1);
+    REQUIRE(s1.has_value());
+    CHECK(s1->nSamples == 100);
+    CHECK(s1->missedBeats == 0);
+    CHECK(s1->last == 1ms);
+    CHECK(s1->p50 >= 1ms);
+    CHECK(s1->p50 <= 1125us);
+    CHECK(s1->p99 <= 1125us);
+
+    std::optional<Monitor::Statistics> s2 = monitor.statistics(2);
+    REQUIRE(s2.has_value());
+    CHECK(s2->p50 >= 10ms);
+    CHECK(s2->p50 <= 11250us);
+    CHECK(s2->p99 >= 200ms);
+}
+
+TEST_CASE("HeartbeatMonitor Missed Beats", "[HeartbeatMonitor]") {
+    Monitor monitor({ .interval = 1s, .maxMissedBeats = 3 });
+    monitor.add(1, T0);
+    monitor.add(2, T0);
+
+    // Only the first connection answers
+    Monitor::Clock::time_point now = T0;
+    for (int i = 0; i < 3; i++) {
+        Monitor::Actions actions = monitor.update(now);
+        CHECK(actions.dead.empty());
+        CHECK(actions.ping.size() == 2);
+        for (const Monitor::Ping& ping : actions.ping) {
+            if (ping.id == 1) {
+                monitor.receivePong(ping.id, ping.sequence, now + 1ms);
+            }
+        }
+        now += 1s;
+    }
+    REQUIRE(monitor.statistics(2).has_value());
+    CHECK(monitor.statistics(2)->missedBeats == 2);
+    CHECK(monitor.statistics(2)->nSamples == 0);
+
+    Monitor::Actions actions = monitor.update(now);
+    CHECK(actions.dead == std::vector<int>{ 2 });
+    REQUIRE(actions.ping.size() == 1);
+    CHECK(actions.ping[0].id == 1);
+    CHECK_FALSE(monitor.statistics(2).has_value());
+    REQUIRE(monitor.statistics(1).has_value());
+    CHECK(monitor.statistics(1)->missedBeats == 0);
+}
+
+TEST_CASE("HeartbeatMonitor Late Answer", "[HeartbeatMonitor]") {
+    Monitor monitor({ .interval = 1s, .maxMissedBeats = 3 });
+    monitor.add(1, T0);
+
+    const std::uint64_t first = monitor.update(T0).ping[0].sequence;
+    const std::uint64_t second = monitor.update(T0 + 1s).ping[0].sequence;
+    CHECK(monitor.statistics(1)->missedBeats == 1);
+
+    // An answer that arrives after the next heartbeat was sent still counts
+    CHECK(monitor.receivePong(1, first, T0 + 1500ms));
+    CHECK(monitor.statistics(1)->missedBeats == 0);
+    CHECK(monitor.statistics(1)->last == 1500ms);
+    CHECK(monitor.receivePong(1, second, T0 + 1600ms));
+    CHECK(monitor.statistics(1)->last == 600ms);
+
+    // Answers to heartbeats that are unknown show that the connection is alive
+    monitor.update(T0 + 2s);
+    monitor.update(T0 + 3s);
+    CHECK(monitor.statistics(1)->missedBeats == 1);
+    CHECK_FALSE(monitor.receivePong(1, 12345, T0 + 3s));
+    CHECK(monitor.statistics(1)->missedBeats == 0);
+    CHECK(monitor.statistics(1)->nSamples == 2);
+}
+
+TEST_CASE("HeartbeatMonitor Remove", "[HeartbeatMonitor]") {
+    Monitor monitor;
+    monitor.add(1, T0);
+    const Monitor::Ping ping = monitor.update(T0).ping[0];
+
+    monitor.remove(1);
+    CHECK_FALSE(monitor.nextUpdate().has_value());
+    CHECK_FALSE(monitor.receivePong(1, ping.sequence, T0 + 1ms));
+    CHECK_FALSE(monitor.statistics(1).has_value());
+
+    // A connection that is added again starts without any history
+    monitor.add(1, T0 + 1s);
+    REQUIRE(monitor.statistics(1).has_value());
+    CHECK(monitor.statistics(1)->nSamples == 0);
+    CHECK_FALSE(monitor.receivePong(1, ping.sequence, T0 + 1s));
+}
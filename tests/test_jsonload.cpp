@@ -0,0 +1,236 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "jsonload.h"
+#include "node.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    void writeNode(const std::filesystem::path& path, std::string_view name, int port) {
+        std::ofstream f = std::ofstream(path);
+        f << std::format(
+            R"({{ "name": "{}", "ip": "localhost", "port": {} }})", name, port
+        );
+    }
+
+    int findPort(const std::vector<Node>& nodes, std::string_view name) {
+        const auto it = std::find_if(
+            nodes.begin(), nodes.end(),
+            [name](const Node& n) { return n.name == name; }
+        );
+        return it != nodes.end() ? it->port : -1;
+    }
+} // namespace
+
+TEST_CASE("JsonFileCache", "[JsonLoad]") {
+    namespace fs = std::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / "ctroll-test-jsonfilecache";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    writeNode(dir / "a.json", "a", 1000);
+    writeNode(dir / "b.json", "b", 2000);
+
+    common::JsonFileCache<Node> cache;
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+        REQUIRE(res.second);
+        REQUIRE(res.first.size() == 2);
+        CHECK(cache.entries.size() == 2);
+    }
+
+    // A file that did not change is not parsed again, which is detected by modifying the
+    // cached value
+    cache.entries[(dir / "a.json").string()].value.port = 999;
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+        REQUIRE(res.second);
+        REQUIRE(res.first.size() == 2);
+        CHECK(findPort(res.first, "a") == 999);
+        CHECK(findPort(res.first, "b") == 2000);
+    }
+
+    // A file whose contents changed is parsed again, even if its modification time and
+    // size did not change
+    const fs::file_time_type time = fs::last_write_time(dir / "a.json");
+    writeNode(dir / "a.json", "a", 1001);
+    fs::last_write_time(dir / "a.json", time);
+    // A file that was modified is parsed again
+    writeNode(dir / "b.json", "b", 2001);
+    fs::last_write_time(dir / "b.json", time + std::chrono::seconds(10));
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+        REQUIRE(res.second);
+        REQUIRE(res.first.size() == 2);
+        CHECK(findPort(res.first, "a") == 1001);
+        CHECK(findPort(res.first, "b") == 2001);
+    }
+
+    // Removed files are removed from the cache, too
+    fs::remove(dir / "a.json");
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+        REQUIRE(res.second);
+        REQUIRE(res.first.size() == 1);
+        CHECK(findPort(res.first, "b") == 2001);
+        CHECK(cache.entries.size() == 1);
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("JsonFileCache Malformed File", "[JsonLoad]") {
+    namespace fs = std::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / "ctroll-test-jsonmalformed";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    writeNode(dir / "a.json", "a", 1000);
+    writeNode(dir / "b.json", "b", 2000);
+
+    common::JsonFileCache<Node> cache;
+    REQUIRE(common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache).second);
+
+    // A file that is only partially written is reported as a failure, but does not
+    // throw or prevent the other files from being loaded
+    {
+        std::ofstream f = std::ofstream(dir / "b.json");
+        f << R"({ "name": "b", "ip": "loc)";
+    }
+    fs::last_write_time(dir / "b.json", fs::file_time_type::clock::now());
+    std::pair<std::vector<Node>, bool> res;
+    REQUIRE_NOTHROW(
+        res = common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache)
+    );
+    CHECK_FALSE(res.second);
+    REQUIRE(res.first.size() == 1);
+    CHECK(findPort(res.first, "a") == 1000);
+    // The broken file is not served from the cache later on
+    CHECK_FALSE(cache.entries.contains((dir / "b.json").string()));
+
+    // Fixing the file makes it load again
+    writeNode(dir / "b.json", "b", 2001);
+    res = common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+    CHECK(res.second);
+    CHECK(findPort(res.first, "b") == 2001);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("JsonFileCache Serialization", "[JsonLoad]") {
+    namespace fs = std::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / "ctroll-test-jsonfilecacheio";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    writeNode(dir / "a.json", "a", 1000);
+    writeNode(dir / "b.json", "b", 2000);
+
+    common::JsonFileCache<Node> cache;
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &cache);
+        REQUIRE(res.second);
+    }
+
+    const std::vector<std::uint8_t> data = nlohmann::json::to_cbor(cache);
+    const common::JsonFileCache<Node> copy =
+        nlohmann::json::from_cbor(data).get<common::JsonFileCache<Node>>();
+    REQUIRE(copy.entries.size() == cache.entries.size());
+    for (const auto& [path, entry] : cache.entries) {
+        REQUIRE(copy.entries.contains(path));
+        const common::JsonFileCache<Node>::Entry& e = copy.entries.at(path);
+        CHECK(e.lastWriteTime == entry.lastWriteTime);
+        CHECK(e.fileSize == entry.fileSize);
+        CHECK(e.contentHash == entry.contentHash);
+        CHECK(e.value.name == entry.value.name);
+        CHECK(e.value.port == entry.value.port);
+    }
+
+    // The deserialized cache is used in the same way as the original one
+    common::JsonFileCache<Node> restored = copy;
+    restored.entries[(dir / "b.json").string()].value.port = 999;
+    {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string(), nullptr, &restored);
+        REQUIRE(res.second);
+        CHECK(findPort(res.first, "a") == 1000);
+        CHECK(findPort(res.first, "b") == 999);
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Parallel Loading Order", "[JsonLoad]") {
+    namespace fs = std::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / "ctroll-test-jsonloadorder";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "sub");
+    for (int i = 0; i < 64; i++) {
+        const fs::path folder = i % 2 == 0 ? dir : dir / "sub";
+        writeNode(folder / std::format("node{}.json", i), std::format("n{}", i), i);
+    }
+
+    // The result has to be in the order of the directory traversal, regardless of the
+    // order in which the files finished parsing
+    std::vector<int> expected;
+    for (const fs::directory_entry& p : fs::recursive_directory_iterator(dir)) {
+        const std::string stem = p.path().stem().string();
+        if (p.is_regular_file()) {
+            expected.push_back(std::stoi(stem.substr(4)));
+        }
+    }
+    REQUIRE(expected.size() == 64);
+
+    for (int i = 0; i < 10; i++) {
+        std::pair<std::vector<Node>, bool> res =
+            common::loadJsonFromDirectory<Node>(dir.string());
+        REQUIRE(res.second);
+        REQUIRE(res.first.size() == expected.size());
+        for (size_t j = 0; j < expected.size(); j++) {
+            CHECK(res.first[j].port == expected[j]);
+        }
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "latencyhistogram.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("LatencyHistogram Empty", "[LatencyHistogram]") {
+    common::LatencyHistogram histogram;
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.percentile(0.5) == 0us);
+    CHECK(histogram.percentile(0.99) == 0us);
+}
+
+TEST_CASE("LatencyHistogram Small Values", "[LatencyHistogram]") {
+    // The values below 8 microseconds are stored exactly
+    common::LatencyHistogram histogram;
+    for (int i = 0; i < 8; i++) {
+        histogram.add(std::chrono::microseconds(i));
+    }
+    CHECK(histogram.count() == 8);
+    CHECK(histogram.percentile(0.0) == 0us);
+    CHECK(histogram.percentile(0.5) == 3us);
+    CHECK(histogram.percentile(1.0) == 7us);
+}
+
+TEST_CASE("LatencyHistogram Percentiles", "[LatencyHistogram]") {
+    common::LatencyHistogram histogram(1000);
+    for (int i = 1; i <= 1000; i++) {
+        histogram.add(std::chrono::microseconds(i * 100));
+    }
+    CHECK(histogram.count() == 1000);
+
+    // The result is the upper bound of the bucket, which is at most 12.5% larger
+    const std::chrono::microseconds p50 = histogram.percentile(0.5);
+    CHECK(p50 >= 50000us);
+    CHECK(p50 <= 56250us);
+
+    const std::chrono::microseconds p99 = histogram.percentile(0.99);
+    CHECK(p99 >= 99000us);
+    CHECK(p99 <= 111375us);
+
+    CHECK(histogram.percentile(1.0) >= 100000us);
+    CHECK(histogram.percentile(1.0) <= 112500us);
+}
+
+TEST_CASE("LatencyHistogram Outlier", "[LatencyHistogram]") {
+    // A single slow answer shows up in the 99th percentile but not in the median
+    common::LatencyHistogram histogram(100);
+    for (int i = 0; i < 99; i++) {
+        histogram.add(1ms);
+    }
+    histogram.add(500ms);
+
+    CHECK(histogram.percentile(0.5) <= 1125us);
+    CHECK(histogram.percentile(0.99) <= 1125us);
+    CHECK(histogram.percentile(1.0) >= 500ms);
+}
+
+TEST_CASE("LatencyHistogram Window", "[LatencyHistogram]") {
+    common::LatencyHistogram histogram(10);
+    for (int i = 0; i < 10; i++) {
+        histogram.add(100ms);
+    }
+    CHECK(histogram.percentile(0.5) >= 100ms);
+
+    // Once the window has been filled with new values, the old ones are forgotten
+    for (int i = 0; i < 10; i++) {
+        histogram.add(1ms);
+    }
+    CHECK(histogram.count() == 10);
+    CHECK(histogram.percentile(1.0) <= 1125us);
+
+    histogram.clear();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.percentile(0.5) == 0us);
+}
+
+TEST_CASE("LatencyHistogram Large Values", "[LatencyHistogram]") {
+    common::LatencyHistogram histogram;
+    histogram.add(std::chrono::hours(24));
+    histogram.add(-1ms);
+
+    CHECK(histogram.percentile(0.0) == 0us);
+    CHECK(histogram.percentile(1.0) == std::chrono::microseconds((1ll << 32) - 1));
+}
@@ -0,0 +1,211 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "launchscheduler.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+    using Scheduler = common::LaunchScheduler;
+
+    const Scheduler::Clock::time_point T0 = Scheduler::Clock::time_point(100s);
+
+    std::vector<int> items(const std::vector<Scheduler::Launch>& launches) {
+        std::vector<int> res;
+        for (const Scheduler::Launch& launch : launches) {
+            res.push_back(launch.item);
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("LaunchScheduler Empty", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+    CHECK(scheduler.update(T0).empty());
+
+    const int id = scheduler.add({ .items = {} }, T0);
+    CHECK_FALSE(scheduler.contains(id));
+    CHECK(scheduler.cancel(id).empty());
+}
+
+TEST_CASE("LaunchScheduler No Delay", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    const int id = scheduler.add({ .items = { 1, 2, 3 } }, T0);
+    CHECK(scheduler.contains(id));
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0);
+
+    // Without a delay or a limit, everything is launched at once
+    std::vector<Scheduler::Launch> launches = scheduler.update(T0);
+    CHECK(items(launches) == std::vector<int>{ 1, 2, 3 });
+    CHECK(launches[0].rollout == id);
+    CHECK_FALSE(scheduler.contains(id));
+    CHECK(scheduler.nInFlight(0) == 3);
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+}
+
+TEST_CASE("LaunchScheduler Delay", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    const int id = scheduler.add({ .items = { 1, 2, 3 }, .delay = 5s }, T0);
+
+    CHECK(items(scheduler.update(T0)) == std::vector<int>{ 1 });
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0 + 5s);
+    CHECK(scheduler.update(T0 + 4999ms).empty());
+    CHECK(items(scheduler.update(T0 + 5s)) == std::vector<int>{ 2 });
+    CHECK(scheduler.contains(id));
+
+    // A late update does not launch the remaining items at once
+    CHECK(items(scheduler.update(T0 + 20s)) == std::vector<int>{ 3 });
+    CHECK_FALSE(scheduler.contains(id));
+}
+
+TEST_CASE("LaunchScheduler Group Limit", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    scheduler.setLimit(1, 2);
+    const int a = scheduler.add({ .group = 1, .items = { 1, 2, 3 } }, T0);
+    const int b = scheduler.add({ .group = 1, .items = { 4 } }, T0);
+    const int c = scheduler.add({ .group = 2, .items = { 5, 6, 7 } }, T0);
+
+    // The limit is shared by all rollouts of a group and the older rollout goes first
+    std::vector<Scheduler::Launch> launches = scheduler.update(T0);
+    CHECK(items(launches) == std::vector<int>{ 1, 2, 5, 6, 7 });
+    CHECK(scheduler.nInFlight(1) == 2);
+    CHECK(scheduler.nInFlight(2) == 3);
+    CHECK(scheduler.contains(a));
+    CHECK(scheduler.contains(b));
+    CHECK_FALSE(scheduler.contains(c));
+
+    // A full group waits for the confirmations or the timeout of its launches
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0 + Scheduler::Options().launchTimeout);
+    CHECK(scheduler.update(T0 + 1s).empty());
+
+    scheduler.setLaunched(a, 1);
+    CHECK(scheduler.nInFlight(1) == 1);
+    CHECK(items(scheduler.update(T0 + 1s)) == std::vector<int>{ 3 });
+    CHECK_FALSE(scheduler.contains(a));
+
+    scheduler.setLaunched(a, 2);
+    scheduler.setLaunched(a, 3);
+    launches = scheduler.update(T0 + 2s);
+    REQUIRE(launches.size() == 1);
+    CHECK(launches[0].rollout == b);
+    CHECK(launches[0].item == 4);
+
+    // Confirming a launch twice or one that is unknown does nothing
+    scheduler.setLaunched(a, 3);
+    scheduler.setLaunched(b, 12);
+    CHECK(scheduler.nInFlight(1) == 1);
+}
+
+TEST_CASE("LaunchScheduler Limit And Delay", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    scheduler.setLimit(0, 1);
+    const int id = scheduler.add({ .items = { 1, 2 }, .delay = 2s }, T0);
+
+    CHECK(items(scheduler.update(T0)) == std::vector<int>{ 1 });
+
+    // The delay has passed, but the first launch is still in flight
+    CHECK(scheduler.update(T0 + 3s).empty());
+    scheduler.setLaunched(id, 1);
+    CHECK(items(scheduler.update(T0 + 3s)) == std::vector<int>{ 2 });
+}
+
+TEST_CASE("LaunchScheduler Timeout", "[LaunchScheduler]") {
+    Scheduler scheduler({ .launchTimeout = 10s });
+    scheduler.setLimit(0, 1);
+    const int id = scheduler.add({ .items = { 1, 2 } }, T0);
+
+    CHECK(items(scheduler.update(T0)) == std::vector<int>{ 1 });
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0 + 10s);
+    CHECK(scheduler.update(T0 + 9s).empty());
+    CHECK(scheduler.isInFlight(id, 1));
+    CHECK(items(scheduler.update(T0 + 10s)) == std::vector<int>{ 2 });
+    CHECK_FALSE(scheduler.isInFlight(id, 1));
+    CHECK(scheduler.isInFlight(id, 2));
+
+    scheduler.setLaunched(id, 2);
+    CHECK_FALSE(scheduler.isInFlight(id, 2));
+}
+
+TEST_CASE("LaunchScheduler Hold", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    const int id = scheduler.add({ .items = { 1, 2 }, .delay = 1s }, T0, true);
+    CHECK(scheduler.contains(id));
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+    CHECK(scheduler.update(T0 + 5s).empty());
+
+    scheduler.release(id, T0 + 5s);
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0 + 5s);
+    CHECK(items(scheduler.update(T0 + 5s)) == std::vector<int>{ 1 });
+    CHECK(items(scheduler.update(T0 + 6s)) == std::vector<int>{ 2 });
+
+    // A held rollout without any items is finished once it is released
+    const int empty = scheduler.add({ .items = {} }, T0, true);
+    CHECK(scheduler.contains(empty));
+    scheduler.release(empty, T0);
+    CHECK_FALSE(scheduler.contains(empty));
+}
+
+TEST_CASE("LaunchScheduler Cancel", "[LaunchScheduler]") {
+    Scheduler scheduler;
+    scheduler.setLimit(0, 2);
+    const int id = scheduler.add({ .items = { 1, 2, 3, 4 }, .delay = 1s }, T0);
+    CHECK(items(scheduler.update(T0)) == std::vector<int>{ 1 });
+    CHECK(items(scheduler.update(T0 + 1s)) == std::vector<int>{ 2 });
+
+    CHECK(scheduler.cancel(id) == std::vector<int>{ 3, 4 });
+    CHECK_FALSE(scheduler.contains(id));
+    CHECK(scheduler.update(T0 + 2s).empty());
+    CHECK(scheduler.cancel(id).empty());
+
+    // The launches that are in flight still occupy the group
+    CHECK(scheduler.nInFlight(0) == 2);
+    scheduler.add({ .items = { 5 } }, T0 + 2s);
+    CHECK(scheduler.update(T0 + 2s).empty());
+    scheduler.setLaunched(id, 1);
+    CHECK(items(scheduler.update(T0 + 2s)) == std::vector<int>{ 5 });
+
+    // A held rollout can be cancelled before it starts
+    const int held = scheduler.add({ .items = { 6, 7 } }, T0, true);
+    CHECK(scheduler.cancel(held) == std::vector<int>{ 6, 7 });
+    scheduler.release(held, T0);
+    CHECK(scheduler.update(T0 + 3s).empty());
+}
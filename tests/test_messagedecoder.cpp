@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "messagedecoder.h"
+#include "messages/killallmessage.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string encode(const nlohmann::json& j, common::Encoding encoding) {
+        switch (encoding) {
+            case common::Encoding::Json:
+                return j.dump();
+            case common::Encoding::Cbor:
+            {
+                std::vector<std::uint8_t> data = nlohmann::json::to_cbor(j);
+                return std::string(data.begin(), data.end());
+            }
+            case common::Encoding::MessagePack:
+            {
+                std::vector<std::uint8_t> data = nlohmann::json::to_msgpack(j);
+                return std::string(data.begin(), data.end());
+            }
+        }
+        throw std::logic_error("Missing case label");
+    }
+
+    constexpr std::array<common::Encoding, 3> Encodings = {
+        common::Encoding::Json, common::Encoding::Cbor, common::Encoding::MessagePack
+    };
+} // namespace
+
+TEST_CASE("MessageDecoder ProcessOutputMessage", "[MessageDecoder]") {
+    common::ProcessOutputMessage msg;
+    msg.processId = 13;
+    msg.message = "some output\nwith \"quotes\"";
+    msg.outputType = common::ProcessOutputMessage::OutputType::StdErr;
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(msg, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<common::ProcessOutputMessage>(res));
+        CHECK(std::get<common::ProcessOutputMessage>(res) == msg);
+    }
+}
+
+TEST_CASE("MessageDecoder ProcessOutputMessage Offset", "[MessageDecoder]") {
+    common::ProcessOutputMessage msg;
+    msg.processId = 13;
+    msg.message = "some output";
+    msg.offset = 5000000000;
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(msg, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<common::ProcessOutputMessage>(res));
+        CHECK(std::get<common::ProcessOutputMessage>(res) == msg);
+    }
+}
+
+TEST_CASE("MessageDecoder ProcessStatusMessage", "[MessageDecoder]") {
+    common::ProcessStatusMessage msg;
+    msg.processId = 2;
+    msg.status = common::ProcessStatusMessage::Status::CrashExit;
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(msg, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<common::ProcessStatusMessage>(res));
+        CHECK(std::get<common::ProcessStatusMessage>(res) == msg);
+    }
+}
+
+TEST_CASE("MessageDecoder TrayStatusMessage", "[MessageDecoder]") {
+    common::TrayStatusMessage msg;
+    msg.processes.push_back({ 1, 2, 3, 4, 5, 6 });
+    msg.processes.push_back({ 7, 8, 9, 10, 11, 18446744073709551615ull });
+    msg.processes.push_back({ 12, 13, 14, 15, 16, 17, 18, 19, 18446744073709551615ull });
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(msg, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<common::TrayStatusMessage>(res));
+        CHECK(std::get<common::TrayStatusMessage>(res) == msg);
+    }
+}
+
+TEST_CASE("MessageDecoder Empty TrayStatusMessage", "[MessageDecoder]") {
+    common::TrayStatusMessage msg;
+
+    std::string payload = encode(msg, common::Encoding::Json);
+    common::DecodedMessage res = common::decodeMessage(payload, common::Encoding::Json);
+    REQUIRE(std::holds_alternative<common::TrayStatusMessage>(res));
+    CHECK(std::get<common::TrayStatusMessage>(res) == msg);
+}
+
+TEST_CASE("MessageDecoder Other Message", "[MessageDecoder]") {
+    common::KillAllMessage msg;
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(msg, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<nlohmann::json>(res));
+        CHECK(std::get<nlohmann::json>(res) == nlohmann::json(msg));
+    }
+}
+
+TEST_CASE("MessageDecoder Unknown Field", "[MessageDecoder]") {
+    common::ProcessOutputMessage msg;
+    msg.processId = 3;
+    msg.message = "abc";
+    nlohmann::json j = msg;
+    j["foobar"] = { { "a", { 1, 2.5, nullptr } }, { "b", true } };
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(j, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<nlohmann::json>(res));
+        CHECK(std::get<nlohmann::json>(res) == j);
+    }
+}
+
+TEST_CASE("MessageDecoder Unknown Field In Process", "[MessageDecoder]") {
+    // The unknown field is encountered in the middle of an entry of the process list, so
+    // everything that was decoded until then has to end up in the document
+    common::TrayStatusMessage msg;
+    msg.processes.push_back({ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    msg.processes.push_back({ 10, 11, 12, 13, 14, 15 });
+    nlohmann::json j = msg;
+    j["processes"][1]["running"] = true;
+    j["processes"].push_back({ { "processId", 20 } });
+
+    for (common::Encoding encoding : Encodings) {
+        std::string payload = encode(j, encoding);
+        common::DecodedMessage res = common::decodeMessage(payload, encoding);
+        REQUIRE(std::holds_alternative<nlohmann::json>(res));
+        CHECK(std::get<nlohmann::json>(res) == j);
+    }
+}
+
+TEST_CASE("MessageDecoder Unexpected Version", "[MessageDecoder]") {
+    common::ProcessStatusMessage msg;
+    nlohmann::json j = msg;
+    j["version"] = { 1, 2, 3, 4, "five" };
+
+    std::string payload = encode(j, common::Encoding::Json);
+    common::DecodedMessage res = common::decodeMessage(payload, common::Encoding::Json);
+    REQUIRE(std::holds_alternative<nlohmann::json>(res));
+    CHECK(std::get<nlohmann::json>(res) == j);
+}
+
+TEST_CASE("MessageDecoder Not An Object", "[MessageDecoder]") {
+    common::DecodedMessage res = common::decodeMessage("[1,2]", common::Encoding::Json);
+    REQUIRE(std::holds_alternative<nlohmann::json>(res));
+    CHECK(std::get<nlohmann::json>(res) == nlohmann::json::array({ 1, 2 }));
+}
+
+TEST_CASE("MessageDecoder Wrong Version", "[MessageDecoder]") {
+    common::ProcessOutputMessage msg;
+    nlohmann::json j = msg;
+    j["version"] = { api::MajorVersion + 1, 0, 0 };
+
+    std::string payload = encode(j, common::Encoding::Json);
+    CHECK_THROWS(common::decodeMessage(payload, common::Encoding::Json));
+}
+
+TEST_CASE("MessageDecoder Missing Field", "[MessageDecoder]") {
+    common::ProcessStatusMessage msg;
+    nlohmann::json j = msg;
+    j.erase("processId");
+
+    std::string payload = encode(j, common::Encoding::Json);
+    CHECK_THROWS(common::decodeMessage(payload, common::Encoding::Json));
+}
+
+TEST_CASE("MessageDecoder Wrong OutputType", "[MessageDecoder]") {
+    common::ProcessOutputMessage msg;
+    nlohmann::json j = msg;
+    j["outputType"] = "foobar";
+
+    std::string payload = encode(j, common::Encoding::Json);
+    CHECK_THROWS(common::decodeMessage(payload, common::Encoding::Json));
+}
+
+TEST_CASE("MessageDecoder Malformed", "[MessageDecoder]") {
+    CHECK_THROWS(common::decodeMessage(R"({"type":)", common::Encoding::Json));
+}
@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "messagedispatcher.h"
+#include <nlohmann/json.hpp>
+#include <string>
+
+TEST_CASE("MessageDispatcher Type Ids", "[MessageDispatcher]") {
+    CHECK(
+        common::messageTypeName(common::messageTypeId<common::KillAllMessage>) ==
+        common::KillAllMessage::Type
+    );
+    CHECK(
+        common::findMessageType(common::TrayStatusMessage::Type) ==
+        common::messageTypeId<common::TrayStatusMessage>
+    );
+    CHECK(
+        common::findMessageType(common::ErrorOccurredMessage::Type) ==
+        common::messageTypeId<common::ErrorOccurredMessage>
+    );
+    CHECK(!common::findMessageType("NotAMessage").has_value());
+    CHECK(!common::findMessageType("").has_value());
+}
+
+TEST_CASE("MessageDispatcher Decode Header", "[MessageDispatcher]") {
+    using Status = common::MessageHeader::Status;
+
+    common::MessageHeader header = common::decodeMessageHeader(common::KillTrayMessage());
+    CHECK(header.status == Status::Valid);
+    CHECK(header.typeId == common::messageTypeId<common::KillTrayMessage>);
+
+    nlohmann::json unknown = common::KillTrayMessage();
+    unknown[common::Message::KeyType] = "NotAMessage";
+    CHECK(common::decodeMessageHeader(unknown).status == Status::UnknownType);
+
+    nlohmann::json version = common::KillTrayMessage();
+    version[common::Message::KeyVersion] = { api::MajorVersion + 1, 0, 0 };
+    CHECK(common::decodeMessageHeader(version).status == Status::IncompatibleVersion);
+
+    nlohmann::json noType = common::KillTrayMessage();
+    noType.erase(common::Message::KeyType);
+    CHECK(common::decodeMessageHeader(noType).status == Status::Invalid);
+
+    nlohmann::json noVersion = common::KillTrayMessage();
+    noVersion.erase(common::Message::KeyVersion);
+    CHECK(common::decodeMessageHeader(noVersion).status == Status::Invalid);
+
+    CHECK(common::decodeMessageHeader(nlohmann::json::array()).status == Status::Invalid);
+}
+
+TEST_CASE("MessageDispatcher Dispatch", "[MessageDispatcher]") {
+    common::MessageDispatcher<int> dispatcher;
+
+    int exitId = -1;
+    int exitArg = -1;
+    dispatcher.on<common::ExitCommandMessage>(
+        [&](common::ExitCommandMessage msg, int arg) {
+            exitId = msg.id;
+            exitArg = arg;
+        }
+    );
+
+    std::string rawType;
+    dispatcher.on<common::KillAllMessage>(
+        [&](common::KillAllMessage, const nlohmann::json& message, int) {
+            rawType = message[common::Message::KeyType];
+        }
+    );
+
+    int nFallback = 0;
+    dispatcher.setFallback([&](const nlohmann::json&, int) { nFallback++; });
+
+    common::ExitCommandMessage exit;
+    exit.id = 5;
+    CHECK(dispatcher.dispatch(exit, 7) == common::MessageHeader::Status::Valid);
+    CHECK(exitId == 5);
+    CHECK(exitArg == 7);
+
+    dispatcher.dispatch(common::KillAllMessage(), 0);
+    CHECK(rawType == common::KillAllMessage::Type);
+    CHECK(nFallback == 0);
+
+    // Known type without a handler
+    dispatcher.dispatch(common::KillTrayMessage(), 0);
+    CHECK(nFallback == 1);
+
+    nlohmann::json unknown = common::KillTrayMessage();
+    unknown[common::Message::KeyType] = "NotAMessage";
+    dispatcher.dispatch(unknown, 0);
+    CHECK(nFallback == 2);
+
+    dispatcher.dispatch(nlohmann::json::object(), 0);
+    CHECK(nFallback == 3);
+
+    CHECK(dispatcher.statistics().nDispatched == 2);
+    CHECK(dispatcher.statistics().nUnhandled == 1);
+    CHECK(dispatcher.statistics().nUnknownType == 1);
+    CHECK(dispatcher.statistics().nInvalid == 1);
+}
+
+TEST_CASE("MessageDispatcher Dispatch Decoded", "[MessageDispatcher]") {
+    common::MessageDispatcher<int> dispatcher;
+
+    std::string output;
+    dispatcher.on<common::ProcessOutputMessage>(
+        [&](common::ProcessOutputMessage msg, int) { output = std::move(msg.message); }
+    );
+
+    int rawProcessId = -1;
+    dispatcher.on<common::ProcessStatusMessage>(
+        [&](common::ProcessStatusMessage, const nlohmann::json& message, int) {
+            rawProcessId = message["processId"];
+        }
+    );
+
+    int nFallback = 0;
+    dispatcher.setFallback([&](const nlohmann::json&, int) { nFallback++; });
+
+    common::ProcessOutputMessage out;
+    out.message = "abc";
+    dispatcher.dispatchMessage(out, 0);
+    CHECK(output == "abc");
+
+    // Handlers that need the raw message get a JSON document created for them
+    common::ProcessStatusMessage status;
+    status.processId = 3;
+    dispatcher.dispatchMessage(status, 0);
+    CHECK(rawProcessId == 3);
+
+    dispatcher.dispatchMessage(common::TrayStatusMessage(), 0);
+    CHECK(nFallback == 1);
+
+    CHECK(dispatcher.statistics().nDispatched == 2);
+    CHECK(dispatcher.statistics().nUnhandled == 1);
+}
+
+TEST_CASE("MessageDispatcher Dispatch Header", "[MessageDispatcher]") {
+    common::MessageDispatcher<int> dispatcher;
+
+    int nKillAll = 0;
+    dispatcher.on<common::KillAllMessage>(
+        [&](common::KillAllMessage, int) { nKillAll++; }
+    );
+
+    int nFallback = 0;
+    dispatcher.setFallback([&](const nlohmann::json&, int) { nFallback++; });
+
+    const nlohmann::json message = common::KillAllMessage();
+    const common::MessageHeader header = common::decodeMessageHeader(message);
+    using Status = common::MessageHeader::Status;
+    CHECK(dispatcher.dispatch(header, message, 0) == Status::Valid);
+    CHECK(nKillAll == 1);
+
+    // The dispatch relies on the header that was passed in
+    common::MessageHeader invalid;
+    CHECK(dispatcher.dispatch(invalid, message, 0) == Status::Invalid);
+    CHECK(nKillAll == 1);
+    CHECK(nFallback == 1);
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "outputbuffer.h"
+
+TEST_CASE("OutputBuffer Empty", "[OutputBuffer]") {
+    common::OutputBuffer buffer;
+    CHECK(buffer.size() == 0);
+    CHECK(buffer.lineCount() == 0);
+    CHECK(buffer.beginOffset() == 0);
+    CHECK(buffer.endOffset() == 0);
+    CHECK(buffer.text().empty());
+}
+
+TEST_CASE("OutputBuffer Append", "[OutputBuffer]") {
+    common::OutputBuffer buffer;
+    buffer.append("abc\n");
+    buffer.append("def\nghi\n");
+    CHECK(buffer.text() == "abc\ndef\nghi\n");
+    CHECK(buffer.size() == 12);
+    CHECK(buffer.lineCount() == 3);
+    CHECK(buffer.endOffset() == 12);
+}
+
+TEST_CASE("OutputBuffer Text Since Offset", "[OutputBuffer]") {
+    common::OutputBuffer buffer;
+    buffer.append("abc\n");
+    const std::uint64_t offset = buffer.endOffset();
+    buffer.append("def\n");
+    buffer.append("ghi\n");
+    CHECK(buffer.text(offset) == "def\nghi\n");
+    CHECK(buffer.text(offset + 2) == "f\nghi\n");
+    CHECK(buffer.text(buffer.endOffset()).empty());
+    CHECK(buffer.text(buffer.endOffset() + 10).empty());
+}
+
+TEST_CASE("OutputBuffer Byte Limit", "[OutputBuffer]") {
+    common::OutputBuffer buffer({ .maxBytes = 8, .maxLines = 100 });
+    buffer.append("abc\n");
+    buffer.append("def\n");
+    buffer.append("ghi\n");
+    CHECK(buffer.text() == "def\nghi\n");
+    CHECK(buffer.beginOffset() == 4);
+    CHECK(buffer.endOffset() == 12);
+    CHECK(buffer.lineCount() == 2);
+
+    // Asking for discarded output returns everything that is left
+    CHECK(buffer.text(0) == "def\nghi\n");
+}
+
+TEST_CASE("OutputBuffer Line Limit", "[OutputBuffer]") {
+    common::OutputBuffer buffer({ .maxBytes = 100, .maxLines = 2 });
+    buffer.append("a\n");
+    buffer.append("b\n");
+    buffer.append("c\n");
+    CHECK(buffer.text() == "b\nc\n");
+    CHECK(buffer.lineCount() == 2);
+}
+
+TEST_CASE("OutputBuffer Oversized Chunk", "[OutputBuffer]") {
+    common::OutputBuffer buffer({ .maxBytes = 100, .maxLines = 2 });
+    buffer.append("a\nb\nc\nd\n");
+    CHECK(buffer.text() == "c\nd\n");
+    CHECK(buffer.beginOffset() == 4);
+    CHECK(buffer.lineCount() == 2);
+
+    common::OutputBuffer bytes({ .maxBytes = 3, .maxLines = 100 });
+    bytes.append("abcdef");
+    CHECK(bytes.text() == "def");
+    CHECK(bytes.beginOffset() == 3);
+}
+
+TEST_CASE("OutputBuffer Set Limits", "[OutputBuffer]") {
+    common::OutputBuffer buffer;
+    buffer.append("a\n");
+    buffer.append("b\n");
+    buffer.append("c\n");
+    buffer.setLimits({ .maxBytes = 100, .maxLines = 1 });
+    CHECK(buffer.text() == "c\n");
+}
+
+TEST_CASE("OutputBuffer Clear", "[OutputBuffer]") {
+    common::OutputBuffer buffer;
+    buffer.append("abc\n");
+    buffer.clear();
+    CHECK(buffer.size() == 0);
+    CHECK(buffer.beginOffset() == 4);
+    CHECK(buffer.endOffset() == 4);
+    buffer.append("d\n");
+    CHECK(buffer.text() == "d\n");
+    CHECK(buffer.text(4) == "d\n");
+}
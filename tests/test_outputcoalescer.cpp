@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "outputcoalescer.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+    const common::OutputCoalescer::Clock::time_point T0 =
+        common::OutputCoalescer::Clock::time_point(100s);
+} // namespace
+
+TEST_CASE("OutputCoalescer Empty", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer;
+    CHECK_FALSE(coalescer.hasPending());
+    CHECK(coalescer.take().empty());
+    CHECK_FALSE(coalescer.append("", T0));
+    CHECK_FALSE(coalescer.hasPending());
+}
+
+TEST_CASE("OutputCoalescer Combine", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer({ .interval = 50ms, .flushSize = 100 });
+    CHECK_FALSE(coalescer.append("abc\n", T0));
+    CHECK_FALSE(coalescer.append("def\n", T0 + 10ms));
+    CHECK(coalescer.hasPending());
+    CHECK(coalescer.deadline() == T0 + 50ms);
+    CHECK(coalescer.take() == "abc\ndef\n");
+    CHECK_FALSE(coalescer.hasPending());
+
+    // The deadline starts with the first pending byte after the output was taken
+    coalescer.append("ghi\n", T0 + 70ms);
+    CHECK(coalescer.deadline() == T0 + 120ms);
+}
+
+TEST_CASE("OutputCoalescer Flush Size", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer({ .interval = 50ms, .flushSize = 8 });
+    CHECK_FALSE(coalescer.append("abc\n", T0));
+    CHECK(coalescer.append("def\n", T0));
+    CHECK(coalescer.take() == "abc\ndef\n");
+}
+
+TEST_CASE("OutputCoalescer Rate Limit", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer({
+        .interval = 50ms,
+        .flushSize = 1000,
+        .maxBytesPerSecond = 8
+    });
+    coalescer.append("abc\n", T0);
+    coalescer.append("def\n", T0 + 100ms);
+    coalescer.append("ghi\n", T0 + 200ms);
+    coalescer.append("jk", T0 + 300ms);
+    CHECK(coalescer.take() == "abc\ndef\n[6 bytes dropped]\n");
+    CHECK(coalescer.totalDropped() == 6);
+
+    // Only dropped output still has to be reported
+    coalescer.append("lmn\n", T0 + 400ms);
+    CHECK(coalescer.hasPending());
+    CHECK(coalescer.deadline() == T0 + 450ms);
+    CHECK(coalescer.take() == "[4 bytes dropped]\n");
+
+    // A new second starts a new budget
+    coalescer.append("opq\n", T0 + 1s);
+    CHECK(coalescer.take() == "opq\n");
+    CHECK(coalescer.totalDropped() == 10);
+}
+
+TEST_CASE("OutputCoalescer Dropped Marker On New Line", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer({
+        .interval = 50ms,
+        .flushSize = 1000,
+        .maxBytesPerSecond = 3
+    });
+    coalescer.append("abc", T0);
+    coalescer.append("def", T0);
+    CHECK(coalescer.take() == "abc\n[3 bytes dropped]\n");
+}
+
+TEST_CASE("OutputCoalescer No Rate Limit", "[OutputCoalescer]") {
+    common::OutputCoalescer coalescer({
+        .interval = 50ms,
+        .flushSize = 1000,
+        .maxBytesPerSecond = 0
+    });
+    for (int i = 0; i < 100; i += 1) {
+        coalescer.append("abcdefgh", T0);
+    }
+    CHECK(coalescer.take().size() == 800);
+    CHECK(coalescer.totalDropped() == 0);
+}
+
+TEST_CASE("OutputCoalescer Shared Rate Limit", "[OutputCoalescer]") {
+    // The limit of the coalescers themselves is ignored in favor of the shared one
+    common::OutputCoalescer::Options options = {
+        .interval = 50ms,
+        .flushSize = 1000,
+        .maxBytesPerSecond = 1000
+    };
+    common::OutputCoalescer stdOut(options);
+    common::OutputCoalescer stdErr(options);
+    common::OutputRateLimit limit(8);
+
+    stdOut.append("abc\n", T0, limit);
+    stdErr.append("def\n", T0 + 100ms, limit);
+    stdOut.append("ghi\n", T0 + 200ms, limit);
+    stdErr.append("jk", T0 + 300ms, limit);
+    CHECK(stdOut.take() == "abc\n[4 bytes dropped]\n");
+    CHECK(stdErr.take() == "def\n[2 bytes dropped]\n");
+
+    // A new second starts a new budget for both of them
+    stdErr.append("lmn\n", T0 + 1s, limit);
+    stdOut.append("opq\n", T0 + 1s, limit);
+    CHECK(stdErr.take() == "lmn\n");
+    CHECK(stdOut.take() == "opq\n");
+}
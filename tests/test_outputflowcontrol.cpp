@@ -0,0 +1,230 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "outputflowcontrol.h"
+#include <utility>
+
+namespace {
+    common::SharedOutputPtr output(int processId, std::string text,
+                  common::ProcessOutputMessage::OutputType type =
+                                           common::ProcessOutputMessage::OutputType::StdOut)
+    {
+        common::ProcessOutputMessage msg;
+        msg.processId = processId;
+        msg.message = std::move(text);
+        msg.outputType = type;
+        return std::make_shared<common::SharedOutput>(std::move(msg));
+    }
+
+    std::string join(const std::vector<common::SharedOutputPtr>& outputs) {
+        std::string res;
+        for (const common::SharedOutputPtr& o : outputs) {
+            res += o->message.message;
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("OutputPolicy Names", "[OutputFlowControl]") {
+    using common::OutputPolicy;
+    for (OutputPolicy p : { OutputPolicy::KeepHead, OutputPolicy::KeepTail,
+                            OutputPolicy::Sample })
+    {
+        CHECK(common::outputPolicyFromString(common::toString(p)) == p);
+    }
+    CHECK_THROWS(common::outputPolicyFromString("abc"));
+}
+
+TEST_CASE("OutputFlowControl Pass Through", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(100);
+    flow.grant(10);
+    std::vector<common::SharedOutputPtr> res =
+        flow.push(output(1, "abc\n"), common::OutputPolicy::KeepTail);
+    REQUIRE(res.size() == 1);
+    CHECK(res[0]->message.message == "abc\n");
+    CHECK(flow.credits() == 6);
+    CHECK(flow.queuedBytes() == 0);
+}
+
+TEST_CASE("OutputFlowControl Queue Without Credits", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(100);
+    CHECK(flow.push(output(1, "abc\n"), common::OutputPolicy::KeepTail).empty());
+    CHECK(flow.push(output(1, "def\n"), common::OutputPolicy::KeepTail).empty());
+    CHECK(flow.queuedBytes() == 8);
+
+    // A message is sent as long as there is any credit left
+    std::vector<common::SharedOutputPtr> res = flow.grant(1);
+    CHECK(join(res) == "abc\n");
+    CHECK(flow.credits() == -3);
+
+    res = flow.grant(10);
+    CHECK(join(res) == "def\n");
+    CHECK(flow.queuedBytes() == 0);
+    CHECK(flow.credits() == 3);
+}
+
+TEST_CASE("OutputFlowControl Keep Order", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(100);
+    flow.push(output(1, "abc\n"), common::OutputPolicy::KeepTail);
+    flow.grant(1);
+    // The credit is used up again, so the output has to be queued behind the first one
+    flow.push(output(1, "def\n"), common::OutputPolicy::KeepTail);
+    CHECK(flow.grant(100).size() == 1);
+    CHECK(flow.push(output(1, "ghi\n"), common::OutputPolicy::KeepTail).size() == 1);
+}
+
+TEST_CASE("OutputFlowControl Keep Head", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(8);
+    flow.push(output(1, "abc\n"), common::OutputPolicy::KeepHead);
+    flow.push(output(1, "def\n"), common::OutputPolicy::KeepHead);
+    flow.push(output(1, "ghi\n"), common::OutputPolicy::KeepHead);
+    flow.push(output(1, "jkl\n"), common::OutputPolicy::KeepHead);
+    CHECK(flow.queuedBytes() == 8);
+    CHECK(flow.totalDropped() == 8);
+    CHECK(join(flow.grant(100)) == "abc\ndef\n[8 bytes dropped]\n");
+}
+
+TEST_CASE("OutputFlowControl Keep Tail", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(8);
+    flow.push(output(1, "abc\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(1, "def\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(1, "ghi\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(1, "jkl\n"), common::OutputPolicy::KeepTail);
+    CHECK(flow.queuedBytes() == 8);
+    CHECK(flow.totalDropped() == 8);
+    CHECK(join(flow.grant(100)) == "[8 bytes dropped]\nghi\njkl\n");
+}
+
+TEST_CASE("OutputFlowControl Sample", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(8);
+    for (int i = 0; i < 8; i++) {
+        flow.push(output(1, std::format("{}{}\n", i, i)), common::OutputPolicy::Sample);
+    }
+    CHECK(flow.queuedBytes() == 6);
+    CHECK(flow.totalDropped() == 18);
+    CHECK(join(flow.grant(100)) == "00\n77\n[18 bytes dropped]\n");
+}
+
+TEST_CASE("OutputFlowControl Dropped Per Output Type", "[OutputFlowControl]") {
+    using OutputType = common::ProcessOutputMessage::OutputType;
+    common::OutputFlowControl flow(4);
+    flow.push(output(1, "abc\n", OutputType::StdOut), common::OutputPolicy::KeepHead);
+    flow.push(output(1, "de\n", OutputType::StdErr), common::OutputPolicy::KeepHead);
+    flow.push(output(1, "f\n", OutputType::StdOut), common::OutputPolicy::KeepHead);
+    std::vector<common::SharedOutputPtr> res = flow.grant(100);
+    REQUIRE(res.size() == 3);
+    CHECK(res[1]->message.message == "[2 bytes dropped]\n");
+    CHECK(res[1]->message.outputType == OutputType::StdOut);
+    CHECK(res[2]->message.message == "[3 bytes dropped]\n");
+    CHECK(res[2]->message.outputType == OutputType::StdErr);
+}
+
+TEST_CASE("OutputFlowControl Round Robin", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(100);
+    flow.push(output(1, "a1\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(1, "a2\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(2, "b1\n"), common::OutputPolicy::KeepTail);
+    flow.push(output(2, "b2\n"), common::OutputPolicy::KeepTail);
+
+    std::vector<common::SharedOutputPtr> res = flow.grant(4);
+    REQUIRE(res.size() == 2);
+    CHECK(res[0]->message.processId == 1);
+    CHECK(res[1]->message.processId == 2);
+    CHECK(join(flow.grant(100)) == "a2\nb2\n");
+}
+
+TEST_CASE("OutputFlowControl Shared Output", "[OutputFlowControl]") {
+    // The same output is passed through the flow control of multiple connections without
+    // being copied, so that it only has to be encoded once for all of them
+    common::OutputFlowControl first(100);
+    common::OutputFlowControl second(100);
+    first.grant(100);
+    common::SharedOutputPtr out = output(1, "abc\n");
+    std::vector<common::SharedOutputPtr> res1 =
+        first.push(out, common::OutputPolicy::KeepTail);
+    CHECK(second.push(out, common::OutputPolicy::KeepTail).empty());
+    std::vector<common::SharedOutputPtr> res2 = second.grant(100);
+    REQUIRE(res1.size() == 1);
+    REQUIRE(res2.size() == 1);
+    CHECK(res1[0] == out);
+    CHECK(res2[0] == out);
+}
+
+TEST_CASE("OutputFlowControl Credit Round Trip", "[OutputFlowControl]") {
+    // The receiver grants back the credits for every message it received, including the
+    // markers for dropped output. Even with a process that produces output much faster
+    // than it is accepted, the credits must never exceed the window that was granted
+    constexpr std::int64_t Window = 16;
+    common::OutputFlowControl flow(8);
+    flow.grant(Window);
+
+    std::uint64_t unacknowledged = 0;
+    auto receive = [&unacknowledged](const std::vector<common::SharedOutputPtr>& res) {
+        for (const common::SharedOutputPtr& o : res) {
+            unacknowledged += o->message.message.size();
+        }
+    };
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < 10; j++) {
+            receive(flow.push(output(1, "abcd\n"), common::OutputPolicy::KeepTail));
+        }
+        const std::uint64_t credits = std::exchange(unacknowledged, 0);
+        receive(flow.grant(credits));
+        CHECK(flow.credits() + static_cast<std::int64_t>(unacknowledged) <= Window);
+    }
+    CHECK(flow.totalDropped() > 0);
+}
+
+TEST_CASE("OutputFlowControl Paused", "[OutputFlowControl]") {
+    common::OutputFlowControl flow(100);
+    flow.grant(100);
+
+    // While paused, the output is queued and credits are only collected
+    CHECK(flow.setPaused(true).empty());
+    CHECK(flow.isPaused());
+    CHECK(flow.push(output(1, "abc\n"), common::OutputPolicy::KeepTail).empty());
+    CHECK(flow.grant(100).empty());
+    CHECK(flow.queuedBytes() == 4);
+    CHECK(flow.credits() == 200);
+
+    std::vector<common::SharedOutputPtr> res = flow.setPaused(false);
+    REQUIRE(res.size() == 1);
+    CHECK(res[0]->message.message == "abc\n");
+    CHECK(flow.credits() == 196);
+
+    // After resuming, the output passes through again
+    CHECK(flow.push(output(1, "def\n"), common::OutputPolicy::KeepTail).size() == 1);
+}
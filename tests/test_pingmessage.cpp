@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "messages/pingmessage.h"
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+TEST_CASE("PingMessage Default Ctor", "[PingMessage]") {
+    common::PingMessage msg;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::PingMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("PingMessage Correct Type", "[PingMessage]") {
+    common::PingMessage msg;
+    CHECK(msg.type == common::PingMessage::Type);
+
+
+    nlohmann::json j;
+    to_json(j, msg);
+
+    common::PingMessage msgDeserialize;
+    from_json(j, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.type == common::PingMessage::Type);
+}
+
+TEST_CASE("PingMessage.sequence", "[PingMessage]") {
+    common::PingMessage msg;
+    msg.sequence = 0x1234'5678'9abc'def0;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::PingMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+
+    CHECK(j1 == j2);
+    CHECK(msgDeserialize.sequence == 0x1234'5678'9abc'def0);
+}
+
+TEST_CASE("PingMessage Skip Validation", "[PingMessage]") {
+    common::PingMessage msg;
+    msg.sequence = 5;
+
+    nlohmann::json j;
+    to_json(j, msg);
+    j[common::Message::KeyVersion] = { api::MajorVersion + 1, 0, 0 };
+
+    common::PingMessage msgDeserialize;
+    CHECK_THROWS_AS(from_json(j, msgDeserialize), std::runtime_error);
+
+    // The caller is responsible for checking the version, so the message is read as-is
+    from_json(j, msgDeserialize, common::SkipValidation());
+    CHECK(msgDeserialize.sequence == 5);
+}
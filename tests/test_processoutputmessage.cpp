@@ -139,6 +139,25 @@ TEST_CASE("ProcessOutputMessage.outputType stderr", "[ProcessOutputMessage]") {
     CHECK(j1 == j2);
 }
 
+TEST_CASE("ProcessOutputMessage.offset", "[ProcessOutputMessage]") {
+    common::ProcessOutputMessage msg;
+    msg.offset = 5000000000;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::ProcessOutputMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    REQUIRE(msgDeserialize.offset.has_value());
+    CHECK(*msgDeserialize.offset == 5000000000);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
 TEST_CASE("ProcessOutputMessage.outputType wrong", "[ProcessOutputMessage]") {
     common::ProcessOutputMessage msg;
     nlohmann::json j;
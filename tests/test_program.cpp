@@ -143,6 +143,42 @@ TEST_CASE("Program.shouldForwardMessages", "[Program]") {
     CHECK(j1 == j2);
 }
 
+TEST_CASE("Program.outputPolicy", "[Program]") {
+    Program msg;
+    msg.outputPolicy = common::OutputPolicy::Sample;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    Program msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.outputPolicy == common::OutputPolicy::Sample);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("Program.outputOnDemand", "[Program]") {
+    Program msg;
+    msg.outputOnDemand = true;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    Program msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.outputOnDemand);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
 TEST_CASE("Program.isEnabled", "[Program]") {
     Program msg;
     msg.isEnabled = false;
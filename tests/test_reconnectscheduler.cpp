@@ -0,0 +1,226 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * Copyright (c) 2016-2025                                                               *
+ * Alexander Bock                                                                        *
+ *                                                                                       *
+ * All rights reserved.                                                                  *
+ *                                                                                       *
+ * Redistribution and use in source and binary forms, with or without modification, are  *
+ * permitted provided that the following conditions are met:                             *
+ *                                                                                       *
+ * 1. Redistributions of source code must retain the above copyright notice, this list   *
+ *    of conditions and the following disclaimer.                                        *
+ *                                                                                       *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this     *
+ *    list of conditions and the following disclaimer in the documentation and/or other  *
+ *    materials provided with the distribution.                                          *
+ *                                                                                       *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be  *
+ *    used to endorse or promote products derived from this software without specific    *
+ *    prior written permission.                                                          *
+ *                                                                                       *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY   *
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT   *
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED  *
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR    *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN      *
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN    *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH   *
+ * DAMAGE.                                                                               *
+ *                                                                                       *
+ ****************************************************************************************/
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "reconnectscheduler.h"
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace {
+    using Scheduler = common::ReconnectScheduler;
+
+    const Scheduler::Clock::time_point T0 = Scheduler::Clock::time_point(100s);
+
+    bool contains(const std::vector<int>& ids, int id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    }
+} // namespace
+
+TEST_CASE("ReconnectScheduler Empty", "[ReconnectScheduler]") {
+    Scheduler scheduler;
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+    Scheduler::Actions actions = scheduler.update(T0);
+    CHECK(actions.dial.empty());
+    CHECK(actions.abort.empty());
+}
+
+TEST_CASE("ReconnectScheduler Dial Added", "[ReconnectScheduler]") {
+    Scheduler scheduler;
+    scheduler.add(1, T0);
+    scheduler.add(2, T0);
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0);
+
+    Scheduler::Actions actions = scheduler.update(T0);
+    CHECK(actions.dial == std::vector<int>{ 1, 2 });
+    CHECK(scheduler.isDialing(1));
+    CHECK(scheduler.isDialing(2));
+    CHECK(scheduler.nDialing() == 2);
+
+    // Nothing is dialed twice
+    CHECK(scheduler.update(T0).dial.empty());
+
+    scheduler.setConnected(1);
+    scheduler.setConnected(2);
+    CHECK(scheduler.nDialing() == 0);
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+}
+
+TEST_CASE("ReconnectScheduler Concurrent Dials", "[ReconnectScheduler]") {
+    Scheduler scheduler({ .maxConcurrentDials = 3 });
+    for (int i = 0; i < 10; i++) {
+        scheduler.add(i, T0);
+    }
+
+    Scheduler::Actions actions = scheduler.update(T0);
+    CHECK(actions.dial.size() == 3);
+    CHECK(scheduler.nDialing() == 3);
+    // While all slots are in use, only the timeouts of the attempts matter
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() == T0 + Scheduler::Options().dialTimeout);
+    CHECK(scheduler.update(T0 + 1ms).dial.empty());
+
+    // A finished attempt frees up a slot for the next connection
+    scheduler.setConnected(actions.dial[0]);
+    CHECK(scheduler.update(T0 + 2ms).dial.size() == 1);
+    CHECK(scheduler.nDialing() == 3);
+
+    // Every connection is dialed eventually
+    int nConnected = 1;
+    Scheduler::Clock::time_point now = T0 + 2ms;
+    for (int i = 0; i < 10 && nConnected < 10; i++) {
+        for (int id = 0; id < 10; id++) {
+            if (scheduler.isDialing(id)) {
+                scheduler.setConnected(id);
+                nConnected++;
+            }
+        }
+        now += 1ms;
+        Scheduler::Actions a = scheduler.update(now);
+        CHECK(a.dial.size() <= 3);
+    }
+    CHECK(nConnected == 10);
+    CHECK_FALSE(scheduler.nextUpdate().has_value());
+}
+
+TEST_CASE("ReconnectScheduler Backoff", "[ReconnectScheduler]") {
+    const Scheduler::Options options = {
+        .initialDelay = 100ms,
+        .maxDelay = 1000ms,
+        .dialTimeout = 10000ms
+    };
+    Scheduler scheduler(options, 1);
+    scheduler.add(1, T0);
+    REQUIRE(scheduler.update(T0).dial.size() == 1);
+
+    // Every failed attempt doubles the delay until the maximum is reached, with a
+    // jitter of up to half of the delay
+    Scheduler::Clock::time_point now = T0;
+    std::chrono::milliseconds expected = 200ms;
+    for (int i = 0; i < 8; i++) {
+        scheduler.setDisconnected(1, now);
+        CHECK_FALSE(scheduler.isDialing(1));
+        REQUIRE(scheduler.nextUpdate().has_value());
+        const Scheduler::Clock::duration delay = *scheduler.nextUpdate() - now;
+        CHECK(delay >= expected / 2);
+        CHECK(delay <= expected);
+
+        // Not dialed before the delay has passed
+        CHECK(scheduler.update(now + delay - 1ms).dial.empty());
+        now += delay;
+        CHECK(scheduler.update(now).dial == std::vector<int>{ 1 });
+        expected = std::min(expected * 2, options.maxDelay);
+    }
+
+    // A connection that is lost before the handshake does not reset the delay
+    scheduler.setConnected(1);
+    CHECK_FALSE(scheduler.isDialing(1));
+    scheduler.setDisconnected(1, now);
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() - now >= options.maxDelay / 2);
+    now = *scheduler.nextUpdate();
+    CHECK(scheduler.update(now).dial == std::vector<int>{ 1 });
+
+    // An established connection resets the delay
+    scheduler.setConnected(1);
+    scheduler.setEstablished(1);
+    scheduler.setDisconnected(1, now);
+    REQUIRE(scheduler.nextUpdate().has_value());
+    CHECK(*scheduler.nextUpdate() - now <= options.initialDelay);
+
+    // Disconnecting a connection that is already waiting does not change anything
+    const Scheduler::Clock::time_point next = *scheduler.nextUpdate();
+    scheduler.setDisconnected(1, now + 1ms);
+    CHECK(*scheduler.nextUpdate() == next);
+}
+
+TEST_CASE("ReconnectScheduler Jitter", "[ReconnectScheduler]") {
+    // Connections that are lost at the same time are not all retried at the same time
+    Scheduler scheduler({ .initialDelay = 1000ms, .maxConcurrentDials = 100 }, 2);
+    for (int i = 0; i < 100; i++) {
+        scheduler.add(i, T0);
+    }
+    REQUIRE(scheduler.update(T0).dial.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        scheduler.setConnected(i);
+        scheduler.setEstablished(i);
+        scheduler.setDisconnected(i, T0);
+    }
+
+    CHECK(scheduler.update(T0 + 499ms).dial.empty());
+    const std::size_t nFirstHalf = scheduler.update(T0 + 750ms).dial.size();
+    CHECK(nFirstHalf > 0);
+    CHECK(nFirstHalf < 100);
+    CHECK(scheduler.update(T0 + 1000ms).dial.size() == 100 - nFirstHalf);
+}
+
+TEST_CASE("ReconnectScheduler Timeout", "[ReconnectScheduler]") {
+    Scheduler scheduler({ .maxConcurrentDials = 1, .dialTimeout = 5s }, 3);
+    scheduler.add(1, T0);
+    scheduler.add(2, T0);
+    REQUIRE(scheduler.update(T0).dial == std::vector<int>{ 1 });
+
+    Scheduler::Actions actions = scheduler.update(T0 + 5s);
+    CHECK(actions.abort == std::vector<int>{ 1 });
+    CHECK(actions.dial == std::vector<int>{ 2 });
+    CHECK_FALSE(scheduler.isDialing(1));
+    CHECK(scheduler.isDialing(2));
+
+    // The socket of the aborted attempt reports the disconnect afterwards
+    const std::optional<Scheduler::Clock::time_point> next = scheduler.nextUpdate();
+    scheduler.setDisconnected(1, T0 + 5s);
+    CHECK(scheduler.nextUpdate() == next);
+}
+
+TEST_CASE("ReconnectScheduler Remove", "[ReconnectScheduler]") {
+    Scheduler scheduler({ .maxConcurrentDials = 1 });
+    scheduler.add(1, T0);
+    scheduler.add(2, T0);
+    REQUIRE(scheduler.update(T0).dial == std::vector<int>{ 1 });
+
+    // Removing a connection that is dialing frees up its slot
+    scheduler.remove(1);
+    CHECK(scheduler.nDialing() == 0);
+    Scheduler::Actions actions = scheduler.update(T0);
+    CHECK(contains(actions.dial, 2));
+    CHECK_FALSE(contains(actions.dial, 1));
+
+    // Unknown connections are ignored
+    scheduler.remove(3);
+    scheduler.setConnected(3);
+    scheduler.setDisconnected(3, T0);
+    CHECK(scheduler.nDialing() == 1);
+}
@@ -247,6 +247,64 @@ TEST_CASE("StartCommand.dataHash", "[StartCommand]") {
     CHECK(j1 == j2);
 }
 
+TEST_CASE("StartCommand.entityHashes", "[StartCommand]") {
+    common::StartCommandMessage msg;
+    msg.programHash = 18446744073709551615ull;
+    msg.clusterHash = 14;
+    msg.nodeHash = 15;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::StartCommandMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.programHash == 18446744073709551615ull);
+    CHECK(msgDeserialize.clusterHash == 14);
+    CHECK(msgDeserialize.nodeHash == 15);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("StartCommand.outputPolicy", "[StartCommand]") {
+    common::StartCommandMessage msg;
+    msg.outputPolicy = common::OutputPolicy::KeepHead;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::StartCommandMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.outputPolicy == common::OutputPolicy::KeepHead);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("StartCommand.outputOnDemand", "[StartCommand]") {
+    common::StartCommandMessage msg;
+    msg.outputOnDemand = true;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::StartCommandMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.outputOnDemand);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
 TEST_CASE("StartCommand full", "[StartCommand]") {
     common::StartCommandMessage msg;
     msg.id = 13;
@@ -66,3 +66,73 @@ TEST_CASE("TrayConnectedMessage Correct Type", "[TrayConnectedMessage]") {
     CHECK(msg == msgDeserialize);
     CHECK(msgDeserialize.type == common::TrayConnectedMessage::Type);
 }
+
+TEST_CASE("TrayConnectedMessage.encodings", "[TrayConnectedMessage]") {
+    common::TrayConnectedMessage msg;
+    msg.encodings = { "msgpack", "cbor" };
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::TrayConnectedMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("TrayConnectedMessage.compressions", "[TrayConnectedMessage]") {
+    common::TrayConnectedMessage msg;
+    msg.compressions = { "zlib" };
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::TrayConnectedMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("TrayConnectedMessage.supportsOutputCredits", "[TrayConnectedMessage]") {
+    common::TrayConnectedMessage msg;
+    msg.supportsOutputCredits = true;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::TrayConnectedMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.supportsOutputCredits);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
+
+TEST_CASE("TrayConnectedMessage.supportsHeartbeat", "[TrayConnectedMessage]") {
+    common::TrayConnectedMessage msg;
+    msg.supportsHeartbeat = true;
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::TrayConnectedMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    CHECK(msgDeserialize.supportsHeartbeat);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}
@@ -95,3 +95,29 @@ TEST_CASE("(TrayStatusMessage) processes", "[TrayStatusMessage]") {
     to_json(j2, msgDeserialize);
     CHECK(j1 == j2);
 }
+
+TEST_CASE("(TrayStatusMessage) entity hashes", "[TrayStatusMessage]") {
+    common::TrayStatusMessage msg;
+    msg.processes.push_back({ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    msg.processes.push_back({ 10, 11, 12, 13, 14, 15 });
+
+
+    nlohmann::json j1;
+    to_json(j1, msg);
+
+    common::TrayStatusMessage msgDeserialize;
+    from_json(j1, msgDeserialize);
+    CHECK(msg == msgDeserialize);
+    REQUIRE(msgDeserialize.processes.size() == 2);
+    CHECK(msgDeserialize.processes[0].programHash == 7);
+    CHECK(msgDeserialize.processes[0].clusterHash == 8);
+    CHECK(msgDeserialize.processes[0].nodeHash == 9);
+    // Processes started by an older C-Troll don't have the entity hashes
+    CHECK(msgDeserialize.processes[1].programHash == 0);
+    CHECK(msgDeserialize.processes[1].clusterHash == 0);
+    CHECK(msgDeserialize.processes[1].nodeHash == 0);
+
+    nlohmann::json j2;
+    to_json(j2, msgDeserialize);
+    CHECK(j1 == j2);
+}